@@ -60,6 +60,8 @@
 #include <metaverse/bitcoin/math/hash.hpp>
 #include <metaverse/bitcoin/math/hash_number.hpp>
 #include <metaverse/bitcoin/math/script_number.hpp>
+#include <metaverse/bitcoin/math/siphash.hpp>
+#include <metaverse/bitcoin/math/signature_cache.hpp>
 #include <metaverse/bitcoin/math/stealth.hpp>
 #include <metaverse/bitcoin/math/uint256.hpp>
 #include <metaverse/bitcoin/message/address.hpp>
@@ -117,7 +117,7 @@ public:
     static bool is_active(uint32_t flags, script_context flag);
 
     static bool check_signature(const ec_signature& signature,
-        uint8_t sighash_type, const data_chunk& public_key,
+        uint8_t sighash_type, data_slice public_key,
         const script& script_code, const transaction& parent_tx,
         uint32_t input_index);
 
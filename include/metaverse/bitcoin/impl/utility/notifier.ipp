@@ -219,7 +219,57 @@ void notifier<Key, Args...>::relay(Args... args)
         this->shared_from_this(), args...);
 }
 
+template <typename Key, typename... Args>
+void notifier<Key, Args...>::relay_to(const std::vector<Key>& keys,
+    Args... args)
+{
+    // This enqueues work while maintaining order.
+    dispatch_.ordered(&notifier<Key, Args...>::do_invoke_keys,
+        this->shared_from_this(), keys, args...);
+}
+
 // private
+template <typename Key, typename... Args>
+void notifier<Key, Args...>::do_invoke_keys(const std::vector<Key>& keys,
+    Args... args)
+{
+    // Critical Section (prevent concurrent handler execution)
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(invoke_mutex_);
+
+    for (const auto& key: keys)
+    {
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        subscribe_mutex_.lock_shared();
+
+        const auto it = subscriptions_.find(key);
+
+        if (stopped_ || it == subscriptions_.end())
+        {
+            subscribe_mutex_.unlock_shared();
+            //-----------------------------------------------------------------
+            continue;
+        }
+
+        const auto handler = it->second.notify;
+        subscribe_mutex_.unlock_shared();
+        ///////////////////////////////////////////////////////////////////////
+
+        if (handler(args...))
+            continue;
+
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        subscribe_mutex_.lock();
+        subscriptions_.erase(key);
+        subscribe_mutex_.unlock();
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+}
+
 template <typename Key, typename... Args>
 void notifier<Key, Args...>::do_invoke(Args... args)
 {
@@ -50,7 +50,7 @@ public:
 
     // Undefined state. set_data() must be called after.
     BC_API script_number();
-    BC_API bool set_data(const data_chunk& data,
+    BC_API bool set_data(data_slice data,
         uint8_t max_size=max_script_number_size);
 
     BC_API data_chunk data() const;
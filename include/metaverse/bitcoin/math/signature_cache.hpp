@@ -0,0 +1,87 @@
+/**
+ * Copyright (c) 2011-2021 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2021 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_SIGNATURE_CACHE_HPP
+#define MVS_SIGNATURE_CACHE_HPP
+
+#include <array>
+#include <cstddef>
+#include <unordered_set>
+#include <vector>
+#include <metaverse/bitcoin/define.hpp>
+#include <metaverse/bitcoin/math/hash.hpp>
+#include <metaverse/bitcoin/utility/data.hpp>
+#include <metaverse/bitcoin/utility/thread.hpp>
+
+namespace libbitcoin {
+
+/**
+ * A bounded set of signatures already found valid, keyed by a salted hash
+ * of (sighash, public key, signature). Transactions are verified when they
+ * enter the pool and again when their block is connected, so the second
+ * check is answered from here. Only successful verifications are stored.
+ * Locking is striped over shards so script threads rarely contend.
+ */
+class BC_API signature_cache
+{
+public:
+    /// The process wide cache shared by pool and block validation.
+    static signature_cache& instance();
+
+    /// Construct a cache holding up to capacity entries.
+    signature_cache(size_t capacity);
+
+    /// True if the signature was previously stored as valid.
+    bool contains(const hash_digest& sighash, data_slice public_key,
+        data_slice signature) const;
+
+    /// Record a successfully verified signature, evicting the oldest
+    /// entry of its shard when the shard is full.
+    void store(const hash_digest& sighash, data_slice public_key,
+        data_slice signature);
+
+    /// The number of entries currently cached.
+    size_t size() const;
+
+private:
+    struct shard
+    {
+        std::unordered_set<hash_digest> entries;
+        std::vector<hash_digest> ring;
+        size_t next;
+        mutable shared_mutex mutex;
+    };
+
+    static BC_CONSTEXPR size_t shard_count = 16;
+
+    hash_digest to_key(const hash_digest& sighash, data_slice public_key,
+        data_slice signature) const;
+    shard& shard_of(const hash_digest& key);
+    const shard& shard_of(const hash_digest& key) const;
+
+    const size_t shard_capacity_;
+    data_chunk salt_;
+    std::array<shard, shard_count> shards_;
+};
+
+} // namespace libbitcoin
+
+#endif
+
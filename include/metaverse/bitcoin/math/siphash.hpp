@@ -0,0 +1,48 @@
+/**
+ * Copyright (c) 2011-2021 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2021 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_SIPHASH_HPP
+#define MVS_SIPHASH_HPP
+
+#include <cstdint>
+#include <utility>
+#include <metaverse/bitcoin/define.hpp>
+#include <metaverse/bitcoin/math/hash.hpp>
+#include <metaverse/bitcoin/utility/data.hpp>
+
+namespace libbitcoin {
+
+/// The two 64 bit halves of a siphash key.
+typedef std::pair<uint64_t, uint64_t> siphash_key;
+
+/**
+ * Generate a siphash key from the first 16 bytes of a hash, little endian.
+ */
+BC_API siphash_key to_siphash_key(const hash_digest& hash);
+
+/**
+ * Generate a SipHash-2-4 hash of the data.
+ */
+BC_API uint64_t siphash(const siphash_key& key, data_slice message);
+
+} // namespace libbitcoin
+
+#endif
+
@@ -23,7 +23,9 @@
 
 #include <istream>
 #include <metaverse/bitcoin/define.hpp>
+#include <metaverse/bitcoin/chain/block.hpp>
 #include <metaverse/bitcoin/chain/header.hpp>
+#include <metaverse/bitcoin/math/siphash.hpp>
 #include <metaverse/bitcoin/message/prefilled_transaction.hpp>
 #include <metaverse/bitcoin/utility/data.hpp>
 #include <metaverse/bitcoin/utility/reader.hpp>
@@ -46,6 +48,15 @@ public:
     static compact_block factory_from_data(uint32_t version,
         reader& source);
 
+    /// Construct the compact form of a block (BIP152), prefilling the
+    /// coinbase and coinstake which can never be in the peer's mempool.
+    static compact_block factory_from_block(const chain::block& block,
+        uint64_t nonce);
+
+    /// The short id of a transaction hash under the short id key.
+    static short_id to_short_id(const siphash_key& key,
+        const hash_digest& hash);
+
     bool from_data(uint32_t version, const data_chunk& data);
     bool from_data(uint32_t version, std::istream& stream);
     bool from_data(uint32_t version, reader& source);
@@ -56,6 +67,9 @@ public:
     void reset();
     uint64_t serialized_size(uint32_t version) const;
 
+    /// The key of the short ids, derived from the header and nonce.
+    siphash_key short_id_key() const;
+
     static const std::string command;
     static const uint32_t version_minimum;
     static const uint32_t version_maximum;
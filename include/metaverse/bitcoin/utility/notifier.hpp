@@ -25,6 +25,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <metaverse/bitcoin/utility/asio.hpp>
 #include <metaverse/bitcoin/utility/assert.hpp>
 #include <metaverse/bitcoin/utility/dispatcher.hpp>
@@ -77,11 +78,15 @@ public:
     /// Invoke all handlers sequentially (non-blocking).
     void relay(Args... args);
 
+    /// Invoke only the handlers of the specified keys (non-blocking).
+    void relay_to(const std::vector<Key>& keys, Args... args);
+
 private:
     typedef struct { handler notify; asio::time_point expires; } value;
     typedef std::unordered_map<Key, value> map;
 
     void do_invoke(Args... args);
+    void do_invoke_keys(const std::vector<Key>& keys, Args... args);
 
     const size_t limit_;
     bool stopped_;
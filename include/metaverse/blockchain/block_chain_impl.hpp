@@ -82,6 +82,12 @@ public:
     // Get a reference to the blockchain configuration settings.
     const settings& chain_settings() const;
 
+    // Get the pool that verifies block input scripts.
+    threadpool& script_pool();
+
+    // Get the number of script verification threads, including the caller.
+    size_t script_threads() const;
+
     // block_chain start/stop (thread safe).
     // ------------------------------------------------------------------------
 
@@ -231,6 +237,12 @@ public:
 
     chain::history::list get_address_history(const wallet::payment_address& addr, bool add_memory_pool = false);
 
+    /// confirmed unspent outputs of an address, read from the address utxo index.
+    database::address_utxo::list get_address_utxos(const wallet::payment_address& addr);
+
+    /// confirmed total value ever received by an address.
+    uint64_t get_address_received(const wallet::payment_address& addr);
+
 
     /// fetch stealth results.
     void fetch_stealth(const binary& filter, uint64_t from_height,
@@ -327,6 +339,11 @@ public:
     std::shared_ptr<chain::asset_detail::list> get_local_assets();
     std::shared_ptr<chain::asset_detail::list> get_issued_assets(
         const std::string& symbol="", const std::string& address="");
+    /// Issued assets whose symbol starts with prefix, ordered after the
+    /// cursor symbol, at most limit symbols (zero is unbounded).
+    std::shared_ptr<chain::asset_detail::list> get_issued_assets_page(
+        const std::string& prefix, const std::string& after="",
+        uint64_t limit=0);
     std::shared_ptr<chain::asset_detail> get_issued_asset(const std::string& symbol);
     std::shared_ptr<chain::blockchain_asset> get_issued_blockchain_asset(const std::string& symbol);
     std::shared_ptr<chain::business_address_asset::list> get_account_assets();
@@ -352,7 +369,11 @@ public:
     bool is_asset_mit_exist(const std::string& symbol);
     uint64_t get_asset_mit_height(const std::string& mit_symbol)const;
     std::shared_ptr<chain::asset_mit_info> get_registered_mit(const std::string& symbol);
-    std::shared_ptr<chain::asset_mit_info::list> get_registered_mits();
+    /// Registered mits whose symbol starts with prefix, ordered after the
+    /// cursor symbol, at most limit symbols (zero is unbounded).
+    std::shared_ptr<chain::asset_mit_info::list> get_registered_mits(
+        const std::string& prefix="", const std::string& after="",
+        uint64_t limit=0);
     std::shared_ptr<chain::asset_mit_info::list> get_mit_history(const std::string& symbol,
         uint64_t limit = 0, uint64_t page_number = 0);
     std::shared_ptr<chain::asset_mit::list> get_account_mits(
@@ -365,7 +386,14 @@ public:
     bool is_account_owned_did(const std::string& account, const std::string& symbol);
     std::string get_did_from_address(const std::string& address, uint64_t fork_index = max_uint64);
     std::shared_ptr<chain::did_detail> get_registered_did(const std::string& symbol) const;
-    std::shared_ptr<chain::did_detail::list> get_registered_dids();
+    /// Registered dids whose symbol starts with prefix, ordered after the
+    /// cursor symbol, skipping skip symbols, at most limit symbols (zero is
+    /// unbounded).
+    std::shared_ptr<chain::did_detail::list> get_registered_dids(
+        const std::string& prefix="", const std::string& after="",
+        uint64_t limit=0, uint64_t skip=0);
+    uint64_t get_registered_dids_count(const std::string& prefix="",
+        const std::string& after="");
     std::shared_ptr<chain::did_detail::list> get_account_dids(const std::string& account);
 
     //get history addresses from did symbol
@@ -384,6 +412,22 @@ public:
         uint64_t limit, uint64_t page_number) const;
     std::shared_ptr<chain::account_address::list> get_addresses();
 
+    /// The height and hash of a transaction, a cursor for paging.
+    typedef std::pair<uint64_t, hash_digest> tx_position;
+
+    /// Selects the history rows of the addresses which list a transaction.
+    typedef std::function<bool(const chain::history_compact&)> history_filter;
+
+    /// Get up to limit transactions of the addresses in [start_height,
+    /// end_height), by height and then hash, descending. The page begins
+    /// after the cursor, the last position of the previous page, or at the
+    /// top if the cursor hash is null. A zero end_height is unbounded.
+    /// If set, only the rows passing the filter list their transaction.
+    std::vector<tx_position> get_addresses_transactions(
+        const std::vector<std::string>& addresses, uint64_t start_height,
+        uint64_t end_height, const tx_position& cursor, uint64_t limit,
+        const history_filter& filter=nullptr) const;
+
     // account message api
     std::shared_ptr<chain::business_address_message::list> get_account_messages(const std::string& name);
 
@@ -449,6 +493,8 @@ public:
     uint32_t get_median_time_past(uint64_t height) const;
     bool is_utxo_spendable(const chain::transaction& tx, uint32_t index,
                            uint64_t tx_height, uint64_t latest_height, uint64_t confirmations = transaction_maturity) const;
+    bool is_utxo_spendable(const database::address_utxo& utxo,
+                           uint64_t latest_height, uint64_t confirmations = transaction_maturity) const;
 
     static bool is_valid_symbol(const std::string& symbol, uint32_t tx_version);
     static bool is_valid_did_symbol(const std::string& symbol,  bool check_sensitive = false);
@@ -524,6 +570,8 @@ private:
     std::atomic<bool> stopped_;
     std::atomic<bool> sync_disabled_;
     const settings& settings_;
+    const size_t script_threads_;
+    threadpool script_pool_;
 
     // These are thread safe.
     organizer organizer_;
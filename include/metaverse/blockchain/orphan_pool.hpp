@@ -22,8 +22,12 @@
 #define MVS_BLOCKCHAIN_orphan_pool_HPP
 
 #include <cstddef>
+#include <cstdint>
+#include <map>
 #include <memory>
-#include <boost/circular_buffer.hpp>
+#include <set>
+#include <tuple>
+#include <unordered_map>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/blockchain/define.hpp>
 #include <metaverse/blockchain/block_detail.hpp>
@@ -32,17 +36,32 @@ namespace libbitcoin {
 namespace blockchain {
 
 /// This class is thread safe.
-/// An unordered memory pool for orphan blocks.
+/// A memory pool for orphan blocks, indexed by hash and by previous hash.
+/// When full the oldest of the lowest work leaf blocks is evicted, so that
+/// the connected chains of the pool are never broken. The parent of the
+/// incoming block is never evicted, if it is the only leaf the incoming
+/// block is refused instead.
 class BCB_API orphan_pool
 {
 public:
     typedef std::shared_ptr<orphan_pool> ptr;
 
+    /// A capacity of zero leaves the pool unbounded.
     orphan_pool(size_t capacity);
 
+    /// The number of blocks in the pool.
+    size_t size() const;
+
+    /// The serialized size of the blocks in the pool.
+    uint64_t bytes() const;
+
     /// Add a block to the pool.
     bool add(block_detail::ptr block);
 
+    /// Add a block to the pool, returning any blocks evicted to make room.
+    /// A block refused because the pool is full has error::pool_filled set.
+    bool add(block_detail::ptr block, block_detail::list& evicted);
+
     /// Remove a block from the pool.
     void remove(block_detail::ptr block);
 
@@ -59,18 +78,37 @@ public:
     block_detail::ptr delete_pending_block(const hash_digest& needed_block);
 
 private:
-//    typedef boost::circular_buffer<block_detail::ptr> buffer;
-    typedef std::vector<block_detail::ptr> buffer;
-    typedef buffer::const_iterator const_iterator;
-    typedef buffer::const_reverse_iterator const_reverse_iterator;
+    struct entry
+    {
+        block_detail::ptr block;
+        uint64_t sequence;
+        uint64_t size;
+        u256 work;
+    };
+
+    typedef std::unordered_map<hash_digest, entry> entries;
+    typedef std::map<uint64_t, hash_digest> age_index;
+    typedef std::unordered_multimap<hash_digest, hash_digest> child_index;
+    typedef std::tuple<u256, uint64_t, hash_digest> leaf_key;
+    typedef std::set<leaf_key> leaf_index;
 
     bool exists(const hash_digest& hash) const;
-    bool exists(const chain::header& header) const;
-    const_iterator find(buffer::const_iterator begin, const hash_digest& hash) const;
-    const_reverse_iterator rfind(buffer::const_reverse_iterator begin, const hash_digest& hash) const;
-
-    // The buffer is protected by mutex.
-    buffer buffer_;
+    bool has_children(const hash_digest& hash) const;
+    void insert(block_detail::ptr block);
+    void erase(entries::iterator it);
+    block_detail::ptr evict(const hash_digest& keep);
+    void erase_pending(const hash_digest& hash);
+
+    static leaf_key to_leaf_key(const hash_digest& hash, const entry& entry);
+
+    // The indexes are protected by mutex.
+    entries entries_;
+    age_index ages_;
+    child_index children_;
+    leaf_index leaves_;
+    uint64_t sequence_;
+    uint64_t bytes_;
+    const size_t capacity_;
     mutable upgrade_mutex mutex_;
 
     std::multimap<hash_digest, block_detail::ptr> pending_blocks_;
@@ -24,7 +24,12 @@
 #include <atomic>
 #include <cstddef>
 #include <functional>
-#include <boost/circular_buffer.hpp>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/blockchain/define.hpp>
 #include <metaverse/blockchain/block_chain.hpp>
@@ -45,6 +50,11 @@ public:
     typedef handle0 result_handler;
     typedef handle1<transaction_ptr> fetch_handler;
     typedef handle1<std::vector<transaction_ptr>> fetch_all_handler;
+
+    /// A template transaction and the fee per kilobyte of the package which
+    /// took it into the template.
+    typedef std::pair<transaction_ptr, uint64_t> rated_transaction;
+    typedef handle1<std::vector<rated_transaction>> fetch_template_handler;
     typedef handle1<transaction_ptr> confirm_handler;
     typedef handle2<transaction_ptr, indexes> validate_handler;
     typedef std::function<bool(const code&, const indexes&, transaction_ptr)>
@@ -77,6 +87,10 @@ public:
     void inventory(message::inventory::ptr inventory);
     void fetch(const hash_digest& tx_hash, fetch_handler handler);
     void fetch(fetch_all_handler handler);
+
+    /// Fetch transactions by descending ancestor fee rate, each preceded by
+    /// its unconfirmed ancestors, until at least max_size bytes are taken.
+    void fetch_template(size_t max_size, fetch_template_handler handler);
     void delete_tx(const hash_digest& tx_hash);
     void fetch_history(const wallet::payment_address& address, size_t limit,
         size_t from_height, block_chain::history_fetch_handler handler);
@@ -97,46 +111,109 @@ protected:
         confirm_handler handle_confirm;
     };
 
-    typedef boost::circular_buffer<entry> buffer;
-    typedef buffer::const_iterator const_iterator;
+    /// Entries in arrival order, keyed by sequence, the oldest is dropped
+    /// first when the pool is full.
+    typedef std::map<uint64_t, entry> entry_queue;
+    typedef std::unordered_map<hash_digest, uint64_t> hash_index;
+
+    /// Pooled transactions by each previous output they spend.
+    typedef std::unordered_multimap<chain::point, hash_digest> spender_index;
+
+    /// Reference counts of the symbols claimed by pooled transactions.
+    typedef std::unordered_map<std::string, size_t> symbol_counts;
+    struct symbol_index
+    {
+        symbol_counts assets;
+        symbol_counts certs;
+        symbol_counts mits;
+        symbol_counts dids;
+        symbol_counts did_addresses;
+        symbol_counts did_attaches;
+    };
+
+    /// The fee and size of a transaction and of its package, which is the
+    /// transaction with all of its unconfirmed ancestors in the pool.
+    struct fee_entry
+    {
+        transaction_ptr tx;
+        uint64_t fee;
+        uint64_t size;
+        uint64_t package_fee;
+        uint64_t package_size;
+        hash_list parents;
+        hash_list children;
+    };
+
+    /// Package fee per kilobyte and hash, ordered highest fee rate first.
+    typedef std::pair<uint64_t, hash_digest> fee_rate_key;
+    typedef std::set<fee_rate_key, std::greater<fee_rate_key>> fee_rate_index;
+    typedef std::unordered_map<hash_digest, fee_entry> fee_entry_map;
 
-    typedef std::function<bool(const chain::input&)> input_compare;
     typedef message::block_message::ptr_list block_list;
 
+    // A validation result with the input value summed by the validator.
+    typedef std::function<void(const code&, transaction_ptr, const indexes&,
+        uint64_t)> validated_handler;
+
     bool stopped();
-    const_iterator find(const hash_digest& tx_hash) const;
+    const entry* find(const hash_digest& tx_hash) const;
 
     bool handle_reorganized(const code& ec, size_t fork_point,
         const block_list& new_blocks, const block_list& replaced_blocks);
     void handle_validated(const code& ec, transaction_ptr tx,
-        const indexes& unconfirmed, validate_handler handler);
+        const indexes& unconfirmed, uint64_t value_in,
+        validated_handler handler);
 
-    void do_validate(transaction_ptr tx, validate_handler handler);
+    void do_validate(transaction_ptr tx, validated_handler handler);
     void do_store(const code& ec, transaction_ptr tx,
-        const indexes& unconfirmed, confirm_handler handle_confirm,
-        validate_handler handle_validate);
+        const indexes& unconfirmed, uint64_t value_in,
+        confirm_handler handle_confirm, validate_handler handle_validate);
 
     void notify_transaction(const chain::point::indexes& unconfirmed,
         transaction_ptr tx);
 
-    void add(transaction_ptr tx, confirm_handler handler);
+    bool add(transaction_ptr tx, confirm_handler handler, uint64_t value_in);
     void remove(const block_list& blocks);
     void clear(const code& ec);
 
     code check_symbol_repeat(transaction_ptr tx);
 
+    // The hash, spender and symbol indexes follow every entry change.
+    bool full() const;
+    void insert_entry(transaction_ptr tx, confirm_handler handler,
+        uint64_t value_in);
+    bool erase_entry(const hash_digest& tx_hash, entry& out);
+    void index_symbols(const chain::transaction& tx, bool add);
+
+    // The fee rate index is maintained as the entries change.
+    static fee_rate_key to_fee_rate_key(const hash_digest& tx_hash,
+        uint64_t package_fee, uint64_t package_size);
+    void index_fee(transaction_ptr tx, uint64_t value_in);
+    void deindex_fee(const hash_digest& tx_hash);
+    void update_package(const hash_digest& tx_hash);
+    void update_descendants(const hash_digest& tx_hash,
+        std::unordered_set<hash_digest>& updated);
+    void take_package(const hash_digest& tx_hash, uint64_t rate,
+        std::vector<rated_transaction>& out,
+        std::unordered_set<hash_digest>& taken, size_t& size) const;
+
     // These would be private but for test access.
     void delete_spent_in_blocks(const block_list& blocks);
     void delete_confirmed_in_blocks(const block_list& blocks);
-    void delete_dependencies(const hash_digest& tx_hash, const code& ec);
     void delete_dependencies(const chain::output_point& point, const code& ec);
-    void delete_dependencies(input_compare is_dependency, const code& ec);
     void delete_package(const code& ec);
     void delete_package(transaction_ptr tx, const code& ec);
     bool delete_single(const hash_digest& tx_hash, const code& ec);
 
-    // The buffer is protected by non-concurrent dispatch.
-    buffer buffer_;
+    // The entries and indexes are protected by non-concurrent dispatch.
+    entry_queue entries_;
+    hash_index hashes_;
+    spender_index spenders_;
+    symbol_index symbols_;
+    uint64_t sequence_;
+    const size_t capacity_;
+    fee_entry_map fee_entries_;
+    fee_rate_index fee_rates_;
     std::atomic<bool> stopped_;
 
 private:
@@ -47,6 +47,23 @@ public:
     typedef std::function<void(const code&, transaction_ptr,
         chain::point::indexes)> validate_handler;
 
+    /// Serialization and signature hash state of a transaction, computed
+    /// once and shared by the script checks of all of its inputs.
+    struct verify_context;
+    typedef std::shared_ptr<const verify_context> verify_context_ptr;
+
+    /// An input script check deferred by connect_input.
+    struct script_check
+    {
+        typedef std::vector<script_check> list;
+
+        chain::script prevout_script;
+        transaction_ptr tx;
+        verify_context_ptr context;
+        uint32_t input_index;
+        uint32_t flags;
+    };
+
     validate_transaction(block_chain& chain, const chain::transaction& tx,
         const transaction_pool& pool, dispatcher& dispatch);
 
@@ -59,6 +76,13 @@ public:
         const chain::transaction& current_tx, uint64_t input_index,
         uint32_t flags);
 
+    static bool check_consensus(const chain::script& prevout_script,
+        const chain::transaction& current_tx, uint64_t input_index,
+        uint32_t flags, const verify_context& context);
+
+    static verify_context_ptr create_verify_context(
+        const chain::transaction& tx);
+
     code check_transaction_version() const;
     code check_transaction_connect_input(uint64_t last_height);
     code check_transaction() const;
@@ -78,6 +102,13 @@ public:
 
     bool connect_input(const chain::transaction& previous_tx, uint64_t parent_height);
 
+    /// Collect input script checks into checks instead of running them,
+    /// the caller is then responsible for verifying them.
+    void defer_script_checks(script_check::list& checks);
+
+    /// The summed value of the previous outputs, once validation succeeded.
+    uint64_t value_in() const;
+
     static bool tally_fees(block_chain_impl& chain,
         const chain::transaction& tx, uint64_t value_in, uint64_t& fees, bool is_coinstake = false);
     static bool check_special_fees(bool is_testnet, const chain::transaction& tx, uint64_t fees);
@@ -147,6 +178,8 @@ private:
     uint32_t current_input_;
     chain::point::indexes unconfirmed_;
     validate_handler handle_validate_;
+    script_check::list* deferred_checks_;
+    verify_context_ptr verify_context_;
 };
 
 } // namespace blockchain
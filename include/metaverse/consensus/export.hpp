@@ -22,6 +22,7 @@
 #define MVS_CONSENSUS_EXPORT_HPP
 
 #include <cstddef>
+#include <memory>
 #include <metaverse/consensus/define.hpp>
 #include <metaverse/consensus/version.hpp>
 
@@ -199,6 +200,46 @@ typedef enum verify_flags_type
     size_t prevout_script_size, unsigned int tx_input_index,
     unsigned int flags);
 
+/**
+ * A transaction deserialized once, together with its signature hash state,
+ * for verifying each of its inputs. Immutable once constructed.
+ */
+class BCK_API transaction_context
+{
+public:
+    /**
+     * @param[in]  transaction       The transaction with the scripts to verify.
+     * @param[in]  transaction_size  The byte length of the transaction.
+     */
+    transaction_context(const unsigned char* transaction,
+        size_t transaction_size);
+    ~transaction_context();
+
+    transaction_context(const transaction_context&) = delete;
+    void operator=(const transaction_context&) = delete;
+
+    struct implementation;
+    const implementation& impl() const;
+
+private:
+    std::unique_ptr<implementation> impl_;
+};
+
+/**
+ * Verify that the transaction input correctly spends the previous output,
+ * reusing the deserialized transaction and signature hash state of context.
+ * @param[in]  context             The transaction with the script to verify.
+ * @param[in]  prevout_script      The script public key to verify against.
+ * @param[in]  prevout_script_size The byte length of the script public key.
+ * @param[in]  tx_input_index      The zero-based index of the transaction
+ *                                 input with signature to be verified.
+ * @param[in]  flags               Verification constraint flags.
+ * @returns                        A script verification result code.
+ */
+ BCK_API verify_result_type verify_script(const transaction_context& context,
+    const unsigned char* prevout_script, size_t prevout_script_size,
+    unsigned int tx_input_index, unsigned int flags);
+
 } // namespace consensus
 } // namespace libbitcoin
 
@@ -92,7 +92,9 @@ struct LightAllocation
 
 struct FullAllocation
 {
-    FullAllocation(ethash_light_t light, ethash_callback_t _cb);
+    /// Generate the DAG (or load it from disk), splitting generation across
+    /// _threads threads.
+    FullAllocation(ethash_light_t light, ethash_callback_t _cb, unsigned _threads = 1);
     ~FullAllocation();
     Result compute(h256& _headerHash, Nonce& _nonce);
     uint64_t size() const { return ethash_full_dag_size(full); }
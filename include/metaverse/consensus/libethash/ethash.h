@@ -60,6 +60,7 @@ typedef struct ethash_light* ethash_light_t;
 struct ethash_full;
 typedef struct ethash_full* ethash_full_t;
 typedef int(*ethash_callback_t)(unsigned);
+typedef bool(*ethash_generator_t)(void*, void*, uint64_t, ethash_light_t, ethash_callback_t);
 
 typedef struct ethash_return_value {
     ethash_h256_t result;
@@ -110,6 +111,27 @@ ethash_return_value_t ethash_light_compute(
  */
 ethash_full_t ethash_full_new(ethash_light_t light, ethash_callback_t callback);
 
+/**
+ * Allocate and initialize a new ethash_full handler, computing the DAG with
+ * the given generator instead of @ref ethash_compute_full_data()
+ *
+ * @param light         The light handler containing the cache.
+ * @param callback      A callback function, see @ref ethash_full_new()
+ * @param generator     A function with signature of @ref ethash_generator_t
+ *                      It accepts the context, the DAG memory, its size in bytes,
+ *                      the light handler and the callback, and returns false on
+ *                      failure or if the callback stopped generation.
+ * @param context       Passed unchanged as the first argument of the generator.
+ * @return              Newly allocated ethash_full handler or NULL in case of
+ *                      ERRNOMEM or a failure of the generator
+ */
+ethash_full_t ethash_full_new_generator(
+    ethash_light_t light,
+    ethash_callback_t callback,
+    ethash_generator_t generator,
+    void* context
+);
+
 /**
  * Frees a previously allocated ethash_full handler
  * @param full    The light handler to free
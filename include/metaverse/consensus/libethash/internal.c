@@ -436,7 +436,9 @@ ethash_full_t ethash_full_new_internal(
     ethash_h256_t const seed_hash,
     uint64_t full_size,
     ethash_light_t const light,
-    ethash_callback_t callback
+    ethash_callback_t callback,
+    ethash_generator_t generator,
+    void* context
 )
 {
     struct ethash_full* ret;
@@ -487,7 +489,10 @@ ethash_full_t ethash_full_new_internal(
 #if defined(__MIC__)
     ret->data = _mm_malloc((size_t)full_size, 64);
 #endif
-    if (!ethash_compute_full_data(ret->data, full_size, light, callback)) {
+    bool const computed = generator ?
+        generator(context, ret->data, full_size, light, callback) :
+        ethash_compute_full_data(ret->data, full_size, light, callback);
+    if (!computed) {
         ETHASH_CRITICAL("Failure at computing DAG data.");
         goto fail_free_full_data;
     }
@@ -529,7 +534,23 @@ ethash_full_t ethash_full_new(ethash_light_t light, ethash_callback_t callback)
     }
     uint64_t full_size = ethash_get_datasize(light->block_number);
     ethash_h256_t seedhash = ethash_get_seedhash(light->block_number);
-    return ethash_full_new_internal(strbuf, seedhash, full_size, light, callback);
+    return ethash_full_new_internal(strbuf, seedhash, full_size, light, callback, NULL, NULL);
+}
+
+ethash_full_t ethash_full_new_generator(
+    ethash_light_t light,
+    ethash_callback_t callback,
+    ethash_generator_t generator,
+    void* context
+)
+{
+    char strbuf[256];
+    if (!ethash_get_default_dirname(strbuf, 256)) {
+        return NULL;
+    }
+    uint64_t full_size = ethash_get_datasize(light->block_number);
+    ethash_h256_t seedhash = ethash_get_seedhash(light->block_number);
+    return ethash_full_new_internal(strbuf, seedhash, full_size, light, callback, generator, context);
 }
 
 void ethash_full_delete(ethash_full_t full)
@@ -135,6 +135,9 @@ struct ethash_full {
  *                       It accepts an unsigned with which a progress of DAG calculation
  *                       can be displayed. If all goes well the callback should return 0.
  *                       If a non-zero value is returned then DAG generation will stop.
+ * @param generator      The function computing the DAG, or NULL for
+ *                       @ref ethash_compute_full_data()
+ * @param context        Passed unchanged as the first argument of the generator.
  * @return               Newly allocated ethash_full handler or NULL in case of
  *                       ERRNOMEM or invalid parameters used for @ref ethash_compute_full_data()
  */
@@ -143,7 +146,9 @@ ethash_full_t ethash_full_new_internal(
     ethash_h256_t const seed_hash,
     uint64_t full_size,
     ethash_light_t const light,
-    ethash_callback_t callback
+    ethash_callback_t callback,
+    ethash_generator_t generator,
+    void* context
 );
 
 void ethash_calculate_dag_item(
@@ -57,6 +57,9 @@ public:
     // tx_hash -> tx_fee
     typedef std::unordered_map<hash_digest, uint64_t> tx_fee_map_t;
 
+    // tx_hash -> fee per kilobyte of the package which took it from the pool
+    typedef std::unordered_map<hash_digest, uint64_t> tx_rate_map_t;
+
     miner(node::p2p_node& node);
     ~miner();
 
@@ -135,7 +138,7 @@ private:
     ec_secret& get_private_key();
 
     uint32_t get_adjust_time(uint64_t height) const;
-    bool get_transaction(uint64_t last_height, std::vector<transaction_ptr>&, previous_out_map_t&, tx_fee_map_t&) const;
+    bool get_transaction(uint64_t last_height, size_t max_size, std::vector<transaction_ptr>&, previous_out_map_t&, tx_fee_map_t&, tx_rate_map_t&) const;
     bool get_block_transactions(
         uint64_t last_height, std::vector<transaction_ptr>& txs, std::vector<transaction_ptr>& reward_txs,
         uint64_t& total_fee, uint32_t& total_tx_sig_length);
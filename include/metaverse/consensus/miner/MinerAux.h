@@ -1,7 +1,9 @@
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
 #include <thread>
+#include <unordered_set>
 #include <metaverse/consensus/libethash/ethash.h>
 #include <metaverse/consensus/libdevcore/Log.h>
 #include <metaverse/consensus/libdevcore/BasicType.h>
@@ -24,22 +26,42 @@ public:
     static LightType get_light(h256& _seedHash);
     static FullType get_full(h256& _seedHash);
     static bool search(chain::header& header, std::function<bool (void)> is_exit);
+
+    /// Cancel and join the generation of the next epoch's DAG.
+    static void stop();
     static uint64_t getRate(){ return get()->m_rate; }
 
+    /// Set the number of threads searching nonces and generating the DAG,
+    /// zero for one per hardware thread.
+    static void set_threads(unsigned _threads);
+    static unsigned get_threads(){ return get()->m_threads; }
+
     static bool verify_work(const chain::header& header, const chain::header::ptr parent);
     static bool verify_stake(const chain::header& header, const chain::output_info& stake_output);
 
 private:
-    MinerAux() {m_rate = 0;}
+    MinerAux();
+    static FullType generate_full(h256& _seedHash, ethash_callback_t _callback);
+    static void prepare_next_epoch(const chain::header& header);
+    static int next_epoch_callback(unsigned _progress);
+    void join_next_epoch();
+
     static MinerAux* s_this;
     SharedMutex x_lights;
     std::unordered_map<h256, std::shared_ptr<LightAllocation>> m_lights;
     Mutex x_fulls;
     std::condition_variable m_fullsChanged;
     std::unordered_map<h256, std::weak_ptr<FullAllocation>> m_fulls;
+    std::unordered_set<h256> m_generating;
     FullType m_lastUsedFull;
+    h256 m_nextSeed;
+    FullType m_nextFull;
+    Mutex x_nextThread;
+    std::thread m_nextThread;
+    std::atomic<bool> m_cancelNext;
    // uint64_t m_hashCount;
-    uint64_t m_rate;
+    std::atomic<uint64_t> m_rate;
+    std::atomic<unsigned> m_threads;
 
 
 
@@ -15,10 +15,12 @@
  */
 
 #include <metaverse/bitcoin.hpp>
+#include <metaverse/database/address_key.hpp>
 #include <metaverse/database/data_base.hpp>
 #include <metaverse/database/define.hpp>
 #include <metaverse/database/settings.hpp>
 #include <metaverse/database/version.hpp>
+#include <metaverse/database/databases/address_utxo_database.hpp>
 #include <metaverse/database/databases/block_database.hpp>
 #include <metaverse/database/databases/history_database.hpp>
 #include <metaverse/database/databases/spend_database.hpp>
@@ -37,6 +39,7 @@
 #include <metaverse/database/primitives/record_multimap_iterator.hpp>
 #include <metaverse/database/primitives/slab_hash_table.hpp>
 #include <metaverse/database/primitives/slab_manager.hpp>
+#include <metaverse/database/primitives/symbol_index.hpp>
 #include <metaverse/database/result/block_result.hpp>
 #include <metaverse/database/result/transaction_result.hpp>
 
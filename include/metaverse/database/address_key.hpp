@@ -0,0 +1,47 @@
+/**
+ * Copyright (c) 2011-2021 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2021 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_DATABASE_ADDRESS_KEY_HPP
+#define MVS_DATABASE_ADDRESS_KEY_HPP
+
+#include <string>
+#include <metaverse/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// The key of the address asset, did and mit tables is the hash160 of the
+/// payment address, as for history, so indexing a block needs no Base58
+/// encoding. A string that is not an address keeps the hash of its text,
+/// so it does not alias the (blackhole) null hash key.
+inline short_hash to_address_key(const std::string& address)
+{
+    const wallet::payment_address payment(address);
+    if (payment)
+        return payment.hash();
+
+    const data_chunk data(address.begin(), address.end());
+    return ripemd160_hash(data);
+}
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
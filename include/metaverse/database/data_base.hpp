@@ -23,7 +23,9 @@
 
 #include <atomic>
 #include <cstddef>
+#include <functional>
 #include <memory>
+#include <vector>
 #include <boost/filesystem.hpp>
 #include <boost/interprocess/sync/file_lock.hpp>
 #include <metaverse/bitcoin.hpp>
@@ -31,6 +33,7 @@
 #include <metaverse/database/databases/spend_database.hpp>
 #include <metaverse/database/databases/transaction_database.hpp>
 #include <metaverse/database/databases/history_database.hpp>
+#include <metaverse/database/databases/address_utxo_database.hpp>
 #include <metaverse/database/databases/stealth_database.hpp>
 #include <metaverse/database/define.hpp>
 #include <metaverse/database/settings.hpp>
@@ -85,15 +88,26 @@ public:
         bool mits_exist() const;
         bool touch_witness_profiles() const;
         bool witness_profiles_exist() const;
+        bool touch_address_utxos() const;
+        bool address_utxos_exist() const;
+        bool touch_growable_tables() const;
+        bool growable_tables_exist() const;
+        bool touch_history() const;
+        bool history_exist() const;
+        bool touch_address_keys() const;
+        bool address_keys_exist() const;
 
         path database_lock;
         path blocks_lookup;
+        path blocks_buckets;
         path blocks_index;
         path history_lookup;
-        path history_rows;
+        path history_pages;
         path stealth_rows;
         path spends_lookup;
+        path spends_buckets;
         path transactions_lookup;
+        path transactions_buckets;
         /* begin database for account, asset, address_asset, did relationship */
         path accounts_lookup;
         path assets_lookup;
@@ -115,6 +129,10 @@ public:
         path mit_history_lookup;
         path mit_history_rows;
         path witness_profiles_lookup;
+        path address_utxos_lookup;
+        path address_utxos_buckets;
+        path address_utxos_rows;
+        path address_utxos_rows_buckets;
     };
 
     class db_metadata
@@ -151,6 +169,11 @@ public:
     /// If database exists then upgrades to version 64.
     static bool upgrade_version_64(const path& prefix);
 
+    /// If database exists then upgrades to the version, from 65 on, building
+    /// the tables it adds. Replayed indexes begin at the history height.
+    static bool upgrade_version(const path& prefix, uint32_t version,
+        size_t history_height);
+
     static bool touch_file(const path& file_path);
     static void write_metadata(const path& metadata_path, data_base::db_metadata& metadata);
     static void read_metadata(const path& metadata_path, data_base::db_metadata& metadata);
@@ -169,6 +192,9 @@ public:
     bool create_witness_certs();
     bool create_mits();
     bool create_witness_profiles();
+    bool create_address_utxos();
+    bool create_history();
+    bool create_address_keys();
 
     /// Start all databases.
     bool start();
@@ -324,11 +350,29 @@ private:
     typedef std::atomic<size_t> sequential_lock;
     typedef boost::interprocess::file_lock file_lock;
 
+    // The payment addresses of the inputs and outputs of a transaction,
+    // extracted once and shared by the address keyed stores.
+    struct tx_addresses
+    {
+        std::vector<wallet::payment_address> inputs;
+        std::vector<wallet::payment_address> outputs;
+    };
+
+    static tx_addresses to_tx_addresses(const chain::transaction& tx);
+
     static bool initialize_dids(const path& prefix);
     static bool initialize_certs(const path& prefix);
     static bool initialize_witness_certs(const path& prefix);
     static bool initialize_mits(const path& prefix);
     static bool initialize_witness_profiles(const path& prefix);
+    static bool initialize_address_utxos(const path& prefix,
+        size_t history_height);
+    static bool initialize_growable_tables(const path& prefix);
+    static bool initialize_history(const path& prefix,
+        size_t history_height);
+    static bool initialize_address_keys(const path& prefix,
+        size_t history_height);
+    static bool move_file(const path& from, const path& to);
 
     static void uninitialize_lock(const path& lock);
     static file_lock initialize_lock(const path& lock);
@@ -339,15 +383,33 @@ private:
     void synchronize_witness_certs();
     void synchronize_mits();
     void synchronize_witness_profiles();
-
-    void push_inputs(const hash_digest& tx_hash, size_t height,
-        const inputs& inputs);
-    void push_outputs(const hash_digest& tx_hash, size_t height,
-        const outputs& outputs);
+    void synchronize_address_utxos();
+    void synchronize_history();
+    void synchronize_address_keys();
+
+    void run_parallel(const std::vector<std::function<void()>>& tasks);
+    void push_spends(const hash_digest& tx_hash, const inputs& inputs);
+    void push_address_utxos(const hash_digest& tx_hash, size_t height,
+        const chain::transaction& tx, const tx_addresses& addresses);
+    void push_history(const hash_digest& tx_hash, size_t height,
+        const chain::transaction& tx, const tx_addresses& addresses);
+    void push_business(const hash_digest& tx_hash, size_t height,
+        const chain::transaction& tx, const tx_addresses& addresses);
     void push_stealth(const hash_digest& tx_hash, size_t height,
         const outputs& outputs);
     void pop_inputs(const inputs& inputs, size_t height);
-    void pop_outputs(const outputs& outputs, size_t height);
+    void restore_address_utxo(const chain::output_point& point);
+    void pop_outputs(const hash_digest& tx_hash, const outputs& outputs,
+        size_t height);
+
+    typedef std::function<void(size_t height, const hash_digest& tx_hash,
+        const chain::transaction& tx)> replay_visitor;
+
+    void replay_blocks(size_t from, replay_visitor visitor,
+        std::function<void()> synchronize);
+    void rebuild_address_utxos();
+    void rebuild_history();
+    void rebuild_address_keys();
 
     const path lock_file_path_;
     const size_t history_height_;
@@ -362,6 +424,14 @@ private:
     // Cross-database mutext to prevent concurrent file remapping.
     std::shared_ptr<shared_mutex> mutex_;
 
+    // Writes the independent stores of a block concurrently, created by the
+    // first push.
+    std::shared_ptr<threadpool> write_pool_;
+
+    // Set while replaying the chain to rekey the address asset, did and mit
+    // tables, so that only their rows are written.
+    bool address_rows_only_;
+
     // temp block timestamp
     uint32_t timestamp_;
 
@@ -370,6 +440,7 @@ public:
     /// Individual database query engines.
     block_database blocks;
     history_database history;
+    address_utxo_database address_utxos;
     spend_database spends;
     stealth_database stealth;
     transaction_database transactions;
@@ -0,0 +1,181 @@
+/**
+ * Copyright (c) 2011-2021 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2021 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_DATABASE_ADDRESS_UTXO_DATABASE_HPP
+#define MVS_DATABASE_ADDRESS_UTXO_DATABASE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/define.hpp>
+#include <metaverse/database/memory/memory_map.hpp>
+#include <metaverse/database/primitives/linear_hash_table_header.hpp>
+#include <metaverse/database/primitives/record_hash_table.hpp>
+#include <metaverse/database/primitives/record_manager.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// The spendability constraint of an unspent output, enough to decide
+/// whether it is frozen without loading the creating transaction.
+enum class utxo_lock_kind : uint8_t
+{
+    none = 0,
+
+    /// Coinbase output, subject to coinbase maturity.
+    coinbase = 1,
+
+    /// Deposit output, lock_value is the lock height.
+    lock_height = 2,
+
+    /// Relative lock output, lock_value is the raw lock sequence.
+    sequence_lock = 3,
+
+    /// Output of a transaction not final by its inputs, lock_value is the
+    /// lock time of the transaction.
+    locktime = 4
+};
+
+struct BCD_API address_utxo
+{
+    typedef std::vector<address_utxo> list;
+
+    chain::output_point output;
+    uint32_t height;
+    uint64_t value;
+
+    /// Payment address version of the output script.
+    uint8_t version;
+
+    utxo_lock_kind lock_kind;
+    uint32_t lock_value;
+
+    /// Attachment type of the output (ETP_TYPE, ASSET_TYPE, ...).
+    uint32_t attachment_type;
+};
+
+struct BCD_API address_utxo_statinfo
+{
+    /// Number of buckets used in the address hashtable.
+    const size_t buckets;
+
+    /// Total number of unique addresses in the database.
+    const size_t addrs;
+
+    /// Total number of output rows allocated, including released rows.
+    const size_t rows;
+};
+
+/// The set of unspent outputs of each address, maintained as blocks are
+/// pushed and popped so that balances cost O(unspent outputs).
+///
+/// Each address keys the head of a doubly linked list of output rows.
+/// The rows are themselves keyed by output point so that spends can
+/// unlink them in constant time. Spent rows are released to a free list
+/// and reused, popping the spending block stores them again.
+class BCD_API address_utxo_database
+{
+public:
+    /// Construct the database.
+    address_utxo_database(const boost::filesystem::path& lookup_filename,
+        const boost::filesystem::path& lookup_growth_filename,
+        const boost::filesystem::path& rows_filename,
+        const boost::filesystem::path& rows_growth_filename,
+        std::shared_ptr<shared_mutex> mutex=nullptr);
+
+    /// Close the database (all threads must first be stopped).
+    ~address_utxo_database();
+
+    /// Initialize a new address utxo database.
+    bool create();
+
+    /// Call before using the database.
+    bool start();
+
+    /// Call to signal a stop of current operations.
+    bool stop();
+
+    /// Call to unload the memory map.
+    bool close();
+
+    /// Add an unspent output to the key. If key doesn't exist it will be created.
+    void store(const short_hash& key, const address_utxo& utxo);
+
+    /// Store again an output whose spending block has been popped, the
+    /// value was already received when the output was first stored.
+    void restore(const short_hash& key, const address_utxo& utxo);
+
+    /// Drop a spent output from its address. Returns false if untracked.
+    bool spend(const chain::output_point& outpoint);
+
+    /// Delete an output whose creating transaction has been popped.
+    void remove(const chain::output_point& outpoint);
+
+    /// Get the unspent outputs associated with the address hash.
+    address_utxo::list get(const short_hash& key) const;
+
+    /// Get the total value ever received by the address hash.
+    uint64_t received(const short_hash& key) const;
+
+    /// Synchonise with disk.
+    void sync();
+
+    /// Return statistical info about the database.
+    address_utxo_statinfo statinfo() const;
+
+private:
+    typedef record_hash_table<short_hash, linear_record_hash_table_header>
+        address_map;
+    typedef record_hash_table<chain::point, linear_record_hash_table_header>
+        row_map;
+
+    void insert(const short_hash& key, const address_utxo& utxo,
+        bool receive);
+    bool erase(const chain::output_point& outpoint, bool unreceive);
+    array_index take_free();
+
+    // These must be called under the exclusive lock.
+    void link(array_index index);
+    void give_free(array_index index);
+    array_index read_free();
+    void write_free(array_index index);
+
+    /// Address hash to [ head:4 ][ received:8 ].
+    memory_map lookup_file_;
+    memory_map lookup_growth_file_;
+    linear_record_hash_table_header lookup_header_;
+    record_manager lookup_manager_;
+    address_map lookup_map_;
+
+    /// Output point to its row, doubly linked per address.
+    memory_map rows_file_;
+    memory_map rows_growth_file_;
+    linear_record_hash_table_header rows_header_;
+    record_manager rows_manager_;
+    row_map rows_map_;
+
+    mutable shared_mutex mutex_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
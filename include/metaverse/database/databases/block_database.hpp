@@ -44,6 +44,7 @@ public:
 
     /// Construct the database.
     block_database(const boost::filesystem::path& map_filename,
+        const boost::filesystem::path& growth_filename,
         const boost::filesystem::path& index_filename,
         std::shared_ptr<shared_mutex> mutex=nullptr);
 
@@ -56,6 +57,9 @@ public:
     /// Call before using the database.
     bool start();
 
+    /// Convert a fixed size lookup table to a growable one (offline).
+    bool convert();
+
     /// Call to signal a stop of current operations.
     bool stop();
 
@@ -94,7 +98,8 @@ public:
     bool next_gap(size_t& out_height, size_t start_height) const;
 
 private:
-    typedef slab_hash_table<hash_digest> slab_map;
+    typedef slab_hash_table<hash_digest, linear_slab_hash_table_header>
+        slab_map;
 
     /// Zeroize the specfied index positions.
     void zeroize(array_index first, array_index count);
@@ -107,7 +112,8 @@ private:
 
     /// Hash table used for looking up blocks by hash.
     memory_map lookup_file_;
-    slab_hash_table_header lookup_header_;
+    memory_map growth_file_;
+    linear_slab_hash_table_header lookup_header_;
     slab_manager lookup_manager_;
     slab_map lookup_map_;
 
@@ -28,6 +28,7 @@
 #include <metaverse/database/result/transaction_result.hpp>
 #include <metaverse/database/primitives/slab_hash_table.hpp>
 #include <metaverse/database/primitives/slab_manager.hpp>
+#include <metaverse/database/primitives/symbol_index.hpp>
 
 namespace libbitcoin {
 namespace database {
@@ -64,6 +65,12 @@ public:
     /// Get all asset certs
     std::shared_ptr<std::vector<chain::asset_cert>> get_blockchain_asset_certs() const;
 
+    /// Certs whose key (symbol then type) starts with prefix, ordered by key
+    /// after the cursor key, at most limit keys (zero is unbounded).
+    std::shared_ptr<std::vector<chain::asset_cert>> get_blockchain_asset_certs_page(
+        const std::string& prefix, const std::string& after="",
+        size_t limit=0) const;
+
     void store(const chain::asset_cert& sp_cert);
 
     /// Delete a transaction from database.
@@ -76,11 +83,16 @@ public:
 private:
     typedef slab_hash_table<hash_digest> slab_map;
 
+    void load_symbols(symbol_index::visitor visit) const;
+
     // Hash table used for looking up txs by hash.
     memory_map lookup_file_;
     slab_hash_table_header lookup_header_;
     slab_manager lookup_manager_;
     slab_map lookup_map_;
+
+    // Symbol ordered keys of the hash table.
+    symbol_index symbols_;
 };
 
 } // namespace database
@@ -28,6 +28,7 @@
 #include <metaverse/database/result/transaction_result.hpp>
 #include <metaverse/database/primitives/slab_hash_table.hpp>
 #include <metaverse/database/primitives/slab_manager.hpp>
+#include <metaverse/database/primitives/symbol_index.hpp>
 #include <metaverse/bitcoin/chain/attachment/asset/blockchain_asset.hpp>
 
 namespace libbitcoin {
@@ -65,6 +66,13 @@ public:
     ///
     std::shared_ptr<std::vector<chain::blockchain_asset>> get_blockchain_assets(const std::string& asset_symbol="") const;
 
+    /// Assets whose symbol starts with prefix, ordered by symbol after the
+    /// cursor symbol, at most limit symbols (zero is unbounded). Symbols
+    /// matched by exclude do not count toward the limit.
+    std::shared_ptr<std::vector<chain::blockchain_asset>> get_blockchain_assets_page(
+        const std::string& prefix, const std::string& after="",
+        size_t limit=0, const symbol_index::filter& exclude=nullptr) const;
+
     uint64_t get_asset_volume(const std::string& name) const;
 
     ///
@@ -85,11 +93,16 @@ public:
 private:
     typedef slab_hash_table<hash_digest> slab_map;
 
+    void load_symbols(symbol_index::visitor visit) const;
+
     // Hash table used for looking up txs by hash.
     memory_map lookup_file_;
     slab_hash_table_header lookup_header_;
     slab_manager lookup_manager_;
     slab_map lookup_map_;
+
+    // Symbol ordered keys of the hash table.
+    symbol_index symbols_;
 };
 
 } // namespace database
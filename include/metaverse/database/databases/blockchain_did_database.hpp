@@ -28,6 +28,7 @@
 #include <metaverse/database/result/transaction_result.hpp>
 #include <metaverse/database/primitives/slab_hash_table.hpp>
 #include <metaverse/database/primitives/slab_manager.hpp>
+#include <metaverse/database/primitives/symbol_index.hpp>
 #include <metaverse/bitcoin/chain/attachment/did/blockchain_did.hpp>
 
 namespace libbitcoin {
@@ -67,6 +68,18 @@ public:
     ///
     std::shared_ptr<std::vector<chain::blockchain_did> > get_blockchain_dids() const;
 
+    /// Dids whose symbol starts with prefix, ordered by symbol after the
+    /// cursor symbol, skipping skip symbols, at most limit symbols (zero is
+    /// unbounded).
+    std::shared_ptr<std::vector<chain::blockchain_did> > get_blockchain_dids_page(
+        const std::string& prefix, const std::string& after="",
+        size_t limit=0, size_t skip=0) const;
+
+    /// The number of did symbols starting with prefix, ordered after the
+    /// cursor symbol.
+    size_t get_blockchain_dids_count(const std::string& prefix="",
+        const std::string& after="") const;
+
     /// 
     std::shared_ptr<chain::blockchain_did> get_register_history(const std::string & did_symbol) const;
     ///
@@ -93,11 +106,16 @@ protected:
 private:
     typedef slab_hash_table<hash_digest> slab_map;
 
+    void load_symbols(symbol_index::visitor visit) const;
+
     // Hash table used for looking up txs by hash.
     memory_map lookup_file_;
     slab_hash_table_header lookup_header_;
     slab_manager lookup_manager_;
     slab_map lookup_map_;
+
+    // Symbol ordered keys of the hash table.
+    symbol_index symbols_;
 };
 
 } // namespace database
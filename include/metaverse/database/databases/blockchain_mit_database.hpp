@@ -26,6 +26,7 @@
 #include <metaverse/database/memory/memory_map.hpp>
 #include <metaverse/database/primitives/slab_hash_table.hpp>
 #include <metaverse/database/primitives/slab_manager.hpp>
+#include <metaverse/database/primitives/symbol_index.hpp>
 
 namespace libbitcoin {
 namespace database {
@@ -57,6 +58,12 @@ public:
     /// Get all asset certs
     std::shared_ptr<chain::asset_mit_info::list> get_blockchain_mits() const;
 
+    /// Mits whose symbol starts with prefix, ordered by symbol after the
+    /// cursor symbol, at most limit symbols (zero is unbounded).
+    std::shared_ptr<chain::asset_mit_info::list> get_blockchain_mits_page(
+        const std::string& prefix, const std::string& after="",
+        size_t limit=0) const;
+
     /// 
     std::shared_ptr<chain::asset_mit_info> get_register_history(const std::string & mit_symbol) const;
     ///
@@ -74,11 +81,16 @@ public:
 private:
     typedef slab_hash_table<hash_digest> slab_map;
 
+    void load_symbols(symbol_index::visitor visit) const;
+
     // Hash table used for looking up txs by hash.
     memory_map lookup_file_;
     slab_hash_table_header lookup_header_;
     slab_manager lookup_manager_;
     slab_map lookup_map_;
+
+    // Symbol ordered keys of the hash table.
+    symbol_index symbols_;
 };
 
 } // namespace database
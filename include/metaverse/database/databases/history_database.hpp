@@ -21,12 +21,14 @@
 #ifndef MVS_DATABASE_HISTORY_DATABASE_HPP
 #define MVS_DATABASE_HISTORY_DATABASE_HPP
 
+#include <cstdint>
 #include <memory>
 #include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/database/define.hpp>
 #include <metaverse/database/memory/memory_map.hpp>
-#include <metaverse/database/primitives/record_multimap.hpp>
+#include <metaverse/database/primitives/record_hash_table.hpp>
+#include <metaverse/database/primitives/slab_manager.hpp>
 
 namespace libbitcoin {
 namespace database {
@@ -40,18 +42,22 @@ struct BCD_API history_statinfo
     /// Total number of unique addresses in the database.
     const size_t addrs;
 
-    /// Total number of rows across all addresses.
-    const size_t rows;
+    /// Total size of the row pages across all addresses.
+    const size_t pages_size;
 };
 
 /// This is a multimap where the key is the Bitcoin address hash,
 /// which returns several rows giving the history for that address.
+///
+/// The rows of an address are packed into a list of pages, newest first,
+/// each holding its rows in height order and by column, so that reads are
+/// sequential and a from_height filter skips pages by their heights.
 class BCD_API history_database
 {
 public:
     /// Construct the database.
     history_database(const boost::filesystem::path& lookup_filename,
-        const boost::filesystem::path& rows_filename,
+        const boost::filesystem::path& pages_filename,
         std::shared_ptr<shared_mutex> mutex=nullptr);
 
     /// Close the database (all threads must first be stopped).
@@ -84,6 +90,12 @@ public:
     chain::history_compact::list get(const short_hash& key, size_t limit,
         size_t from_height) const;
 
+    /// Get the rows from to_height down to from_height, newest first.
+    /// Reads at least limit rows (if available) and then completes the
+    /// height of the last, so that a next call may begin below it.
+    chain::history_compact::list get(const short_hash& key, size_t limit,
+        size_t from_height, size_t to_height) const;
+
     /// Synchonise with disk.
     void sync();
 
@@ -92,19 +104,26 @@ public:
 
 private:
     typedef record_hash_table<short_hash> record_map;
-    typedef record_multimap<short_hash> record_multiple_map;
 
-    /// Hash table used for start index lookup for linked list by address hash.
+    // Rows must be added in height order.
+    void add_row(const short_hash& key, chain::point_kind kind,
+        const chain::point& point, uint32_t height, uint64_t value);
+
+    // Allocate a page for at least one row, linked to the previous page.
+    file_offset new_page(file_offset previous, uint16_t capacity);
+
+    /// Hash table of address hash to the position of its newest page.
     memory_map lookup_file_;
     record_hash_table_header lookup_header_;
     record_manager lookup_manager_;
     record_map lookup_map_;
 
-    /// List of history rows.
-    memory_map rows_file_;
-    record_manager rows_manager_;
-    record_list rows_list_;
-    record_multiple_map rows_multimap_;
+    /// Pages of history rows.
+    memory_map pages_file_;
+    slab_manager pages_manager_;
+
+    // Protects the page list heads and row counts.
+    mutable shared_mutex mutex_;
 };
 
 } // namespace database
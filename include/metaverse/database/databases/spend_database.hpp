@@ -49,6 +49,7 @@ class BCD_API spend_database
 public:
     /// Construct the database.
     spend_database(const boost::filesystem::path& filename,
+        const boost::filesystem::path& growth_filename,
         std::shared_ptr<shared_mutex> mutex=nullptr);
 
     /// Close the database (all threads must first be stopped).
@@ -60,6 +61,9 @@ public:
     /// Call before using the database.
     bool start();
 
+    /// Convert a fixed size lookup table to a growable one (offline).
+    bool convert();
+
     /// Call to signal a stop of current operations.
     bool stop();
 
@@ -84,11 +88,13 @@ public:
     spend_statinfo statinfo() const;
 
 private:
-    typedef record_hash_table<chain::point> record_map;
+    typedef record_hash_table<chain::point, linear_record_hash_table_header>
+        record_map;
 
     // Hash table used for looking up inpoint spends by outpoint.
     memory_map lookup_file_;
-    record_hash_table_header lookup_header_;
+    memory_map growth_file_;
+    linear_record_hash_table_header lookup_header_;
     record_manager lookup_manager_;
     record_map lookup_map_;
 };
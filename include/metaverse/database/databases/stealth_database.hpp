@@ -23,6 +23,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <vector>
 #include <boost/filesystem.hpp>
 #include <metaverse/database/define.hpp>
 #include <metaverse/database/memory/memory.hpp>
@@ -56,7 +57,7 @@ public:
     /// Call to unload the memory map.
     bool close();
 
-    /// Linearly scan all entries, discarding those after from_height.
+    /// Scan the segments reaching from_height for rows matching the filter.
     chain::stealth_compact::list scan(const binary& filter,
         size_t from_height) const;
 
@@ -64,7 +65,7 @@ public:
     void store(uint32_t prefix, uint32_t height,
         const chain::stealth_compact& row);
 
-    /// Delete all rows after and including from_height (no implemented).
+    /// Delete the trailing rows at and above from_height.
     void unlink(size_t from_height);
 
     /// Synchronise storage with disk so things are consistent.
@@ -72,12 +73,26 @@ public:
     void sync();
 
 private:
-    void write_index();
-    array_index read_index(size_t from_height) const;
+    /// Height bounds of a fixed size run of consecutive rows.
+    struct segment
+    {
+        uint32_t min_height;
+        uint32_t max_height;
+    };
+
+    void load_index();
+    void index_row(uint32_t prefix, uint32_t height);
+    void truncate_index(array_index count);
+    uint32_t read_height(array_index row) const;
 
     // Row entries containing stealth tx data.
     memory_map rows_file_;
     record_manager rows_manager_;
+
+    // In memory prefix column (bit order keys) and segment directory.
+    std::vector<uint32_t> prefixes_;
+    std::vector<segment> segments_;
+    mutable shared_mutex index_mutex_;
 };
 
 } // namespace database
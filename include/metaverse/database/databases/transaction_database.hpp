@@ -43,6 +43,7 @@ class BCD_API transaction_database
 public:
     /// Construct the database.
     transaction_database(const boost::filesystem::path& map_filename,
+        const boost::filesystem::path& growth_filename,
         std::shared_ptr<shared_mutex> mutex=nullptr);
 
     /// Close the database (all threads must first be stopped).
@@ -54,6 +55,9 @@ public:
     /// Call before using the database.
     bool start();
 
+    /// Convert a fixed size lookup table to a growable one (offline).
+    bool convert();
+
     /// Call to signal a stop of current operations.
     bool stop();
 
@@ -75,11 +79,13 @@ public:
     void sync();
 
 private:
-    typedef slab_hash_table<hash_digest> slab_map;
+    typedef slab_hash_table<hash_digest, linear_slab_hash_table_header>
+        slab_map;
 
     // Hash table used for looking up txs by hash.
     memory_map lookup_file_;
-    slab_hash_table_header lookup_header_;
+    memory_map growth_file_;
+    linear_slab_hash_table_header lookup_header_;
     slab_manager lookup_manager_;
     slab_map lookup_map_;
 };
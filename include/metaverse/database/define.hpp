@@ -45,8 +45,12 @@
 // Log name.
 #define LOG_DATABASE "database"
 
-// Remap safety is required if the mmap file is not fully preallocated.
-#define REMAP_SAFETY
+// Remap safety is required if the mmap file is not fully preallocated and
+// address space cannot be reserved for it to grow in place. Otherwise the
+// mapping never moves while open and reads require no lock or allocation.
+#ifdef _WIN32
+    #define REMAP_SAFETY
+#endif
 
 // Allocate safety is required for support of concurrent write operations.
 #define ALLOCATE_SAFETY
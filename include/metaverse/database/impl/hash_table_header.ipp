@@ -138,6 +138,30 @@ IndexType hash_table_header<IndexType, ValueType>::size() const
     return buckets_;
 }
 
+template <typename IndexType, typename ValueType>
+IndexType hash_table_header<IndexType, ValueType>::bucket(size_t hash) const
+{
+    return buckets_ == 0 ? 0 : static_cast<IndexType>(hash % buckets_);
+}
+
+template <typename IndexType, typename ValueType>
+bool hash_table_header<IndexType, ValueType>::add_entry()
+{
+    return false;
+}
+
+template <typename IndexType, typename ValueType>
+void hash_table_header<IndexType, ValueType>::remove_entry()
+{
+}
+
+template <typename IndexType, typename ValueType>
+IndexType hash_table_header<IndexType, ValueType>::grow()
+{
+    BITCOIN_ASSERT_MSG(false, "Fixed size hash table cannot grow.");
+    return 0;
+}
+
 template <typename IndexType, typename ValueType>
 file_offset hash_table_header<IndexType, ValueType>::item_position(
     IndexType index) const
@@ -0,0 +1,238 @@
+/**
+ * Copyright (c) 2011-2021 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2021 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_DATABASE_LINEAR_HASH_TABLE_HEADER_IPP
+#define MVS_DATABASE_LINEAR_HASH_TABLE_HEADER_IPP
+
+#include <limits>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/memory/memory.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+template <typename IndexType, typename ValueType>
+const ValueType linear_hash_table_header<IndexType, ValueType>::empty =
+    (ValueType)bc::max_uint64;
+
+template <typename IndexType, typename ValueType>
+const uint64_t linear_hash_table_header<IndexType, ValueType>::maximum_load = 1;
+
+template <typename IndexType, typename ValueType>
+linear_hash_table_header<IndexType, ValueType>::linear_hash_table_header(
+    memory_map& file, memory_map& growth_file, IndexType buckets)
+  : base_(file, buckets),
+    growth_file_(growth_file),
+    base_buckets_(buckets),
+    buckets_(buckets),
+    level_buckets_(buckets),
+    entries_(0)
+{
+    BITCOIN_ASSERT_MSG(buckets != 0, "Linear hash table requires buckets.");
+}
+
+template <typename IndexType, typename ValueType>
+bool linear_hash_table_header<IndexType, ValueType>::create()
+{
+    return base_.create() && convert();
+}
+
+template <typename IndexType, typename ValueType>
+bool linear_hash_table_header<IndexType, ValueType>::convert()
+{
+    if (!base_.start())
+        return false;
+
+    // The accessor must remain in scope until the end of the block.
+    const auto memory = growth_file_.resize(item_position(base_buckets_));
+    auto serial = make_serializer(REMAP_ADDRESS(memory));
+    serial.template write_little_endian<IndexType>(base_buckets_);
+    serial.write_8_bytes_little_endian(0);
+
+    set_buckets(base_buckets_);
+    entries_ = 0;
+    return true;
+}
+
+template <typename IndexType, typename ValueType>
+bool linear_hash_table_header<IndexType, ValueType>::start()
+{
+    // The growth file is too small, the table has not been converted.
+    if (!base_.start() || item_position(base_buckets_) > growth_file_.size())
+        return false;
+
+    // The accessor must remain in scope until the end of the block.
+    const auto memory = growth_file_.access();
+    auto deserial = make_deserializer_unsafe(REMAP_ADDRESS(memory));
+
+    // Does not require atomicity (no concurrency during start).
+    const auto buckets = deserial.template read_little_endian<IndexType>();
+    const auto entries = deserial.read_8_bytes_little_endian();
+
+    if (buckets < base_buckets_ ||
+        item_position(buckets) > growth_file_.size())
+        return false;
+
+    set_buckets(buckets);
+    entries_ = entries;
+    return true;
+}
+
+template <typename IndexType, typename ValueType>
+ValueType linear_hash_table_header<IndexType, ValueType>::read(
+    IndexType index) const
+{
+    if (index < base_buckets_)
+        return base_.read(index);
+
+    // This is not runtime safe but test is avoided as an optimization.
+    BITCOIN_ASSERT(index < buckets_);
+
+    // The accessor must remain in scope until the end of the block.
+    const auto memory = growth_file_.access();
+    const auto value_address = REMAP_ADDRESS(memory) + item_position(index);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return from_little_endian_unsafe<ValueType>(value_address);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+template <typename IndexType, typename ValueType>
+void linear_hash_table_header<IndexType, ValueType>::write(IndexType index,
+    ValueType value)
+{
+    if (index < base_buckets_)
+    {
+        base_.write(index, value);
+        return;
+    }
+
+    // This is not runtime safe but test is avoided as an optimization.
+    BITCOIN_ASSERT(index < buckets_);
+
+    // The accessor must remain in scope until the end of the block.
+    const auto memory = growth_file_.access();
+    const auto value_address = REMAP_ADDRESS(memory) + item_position(index);
+    auto serial = make_serializer(value_address);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+    serial.template write_little_endian<ValueType>(value);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+template <typename IndexType, typename ValueType>
+IndexType linear_hash_table_header<IndexType, ValueType>::size() const
+{
+    return buckets_;
+}
+
+template <typename IndexType, typename ValueType>
+IndexType linear_hash_table_header<IndexType, ValueType>::bucket(
+    size_t hash) const
+{
+    const size_t level_buckets = level_buckets_;
+    const auto bucket = hash % level_buckets;
+
+    // Buckets below the split pointer have been split in this round.
+    if (bucket < buckets_ - level_buckets_)
+        return static_cast<IndexType>(hash % (level_buckets * 2));
+
+    return static_cast<IndexType>(bucket);
+}
+
+template <typename IndexType, typename ValueType>
+bool linear_hash_table_header<IndexType, ValueType>::add_entry()
+{
+    set_entries(entries_ + 1);
+    return entries_ > buckets_ * maximum_load &&
+        buckets_ < std::numeric_limits<IndexType>::max();
+}
+
+template <typename IndexType, typename ValueType>
+void linear_hash_table_header<IndexType, ValueType>::remove_entry()
+{
+    BITCOIN_ASSERT(entries_ > 0);
+    set_entries(entries_ - 1);
+}
+
+template <typename IndexType, typename ValueType>
+void linear_hash_table_header<IndexType, ValueType>::set_entries(
+    uint64_t entries)
+{
+    // The accessor must remain in scope until the end of the block.
+    const auto memory = growth_file_.access();
+    auto serial = make_serializer(REMAP_ADDRESS(memory) + sizeof(IndexType));
+    serial.write_8_bytes_little_endian(entries);
+    entries_ = entries;
+}
+
+template <typename IndexType, typename ValueType>
+IndexType linear_hash_table_header<IndexType, ValueType>::grow()
+{
+    const auto source = buckets_ - level_buckets_;
+    const auto target = buckets_;
+
+    // This will throw if insufficient disk space.
+    // The accessor must remain in scope until the end of the block.
+    const auto memory = growth_file_.reserve(item_position(target + 1));
+    const auto address = REMAP_ADDRESS(memory);
+    auto serial = make_serializer(address);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+    serial.template write_little_endian<IndexType>(target + 1);
+    auto item = make_serializer(address + item_position(target));
+    item.template write_little_endian<ValueType>(empty);
+    set_buckets(target + 1);
+    ///////////////////////////////////////////////////////////////////////////
+
+    return source;
+}
+
+template <typename IndexType, typename ValueType>
+file_offset linear_hash_table_header<IndexType, ValueType>::item_position(
+    IndexType index) const
+{
+    BITCOIN_ASSERT(index >= base_buckets_);
+    return sizeof(IndexType) + sizeof(uint64_t) +
+        file_offset(index - base_buckets_) * sizeof(ValueType);
+}
+
+template <typename IndexType, typename ValueType>
+void linear_hash_table_header<IndexType, ValueType>::set_buckets(
+    IndexType buckets)
+{
+    size_t level_buckets = base_buckets_;
+    while (level_buckets * 2 <= buckets)
+        level_buckets *= 2;
+
+    buckets_ = buckets;
+    level_buckets_ = static_cast<IndexType>(level_buckets);
+}
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
@@ -30,9 +30,9 @@
 namespace libbitcoin {
 namespace database {
 
-template <typename KeyType>
-record_hash_table<KeyType>::record_hash_table(
-    record_hash_table_header& header, record_manager& manager)
+template <typename KeyType, typename HeaderType>
+record_hash_table<KeyType, HeaderType>::record_hash_table(
+    HeaderType& header, record_manager& manager)
   : header_(header), manager_(manager)
 {
 }
@@ -40,26 +40,47 @@ record_hash_table<KeyType>::record_hash_table(
 // This is not limited to storing unique key values. If duplicate keyed values
 // are store then retrieval and unlinking will fail as these multiples cannot
 // be differentiated.
-template <typename KeyType>
-void record_hash_table<KeyType>::store(const KeyType& key,
+template <typename KeyType, typename HeaderType>
+array_index record_hash_table<KeyType, HeaderType>::store(const KeyType& key,
     const write_function write)
 {
-    mutex_.lock();
+    return store(key, write, header_.empty);
+}
+
+template <typename KeyType, typename HeaderType>
+array_index record_hash_table<KeyType, HeaderType>::store(const KeyType& key,
+    const write_function write, const array_index record)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
     // Store current bucket value.
     const auto old_begin = read_bucket_value(key);
-    record_row<KeyType> item(manager_, 0);
-    const auto new_begin = item.create(key, old_begin);
+    record_row<KeyType> item(manager_, record);
+    const auto new_begin = record == header_.empty ?
+        item.create(key, old_begin) : item.recreate(key, old_begin);
     write(item.data());
 
     // Link record to header.
     link(key, new_begin);
-    mutex_.unlock();
+
+    if (header_.add_entry())
+    {
+        unique_lock split_lock(split_mutex_);
+        split();
+    }
+
+    return new_begin;
+    ///////////////////////////////////////////////////////////////////////////
 }
 
 // This is limited to returning the first of multiple matching key values.
-template <typename KeyType>
-const memory_ptr record_hash_table<KeyType>::find(const KeyType& key) const
+template <typename KeyType, typename HeaderType>
+const memory_ptr record_hash_table<KeyType, HeaderType>::find(const KeyType& key) const
 {
+    shared_lock lock(split_mutex_);
+
     // Find start item...
     auto current = read_bucket_value(key);
 
@@ -87,9 +108,11 @@ const memory_ptr record_hash_table<KeyType>::find(const KeyType& key) const
 
 
 // This is limited to returning all the item in the special index.
-template <typename KeyType>
-std::shared_ptr<std::vector<memory_ptr>> record_hash_table<KeyType>::find(array_index index) const
+template <typename KeyType, typename HeaderType>
+std::shared_ptr<std::vector<memory_ptr>> record_hash_table<KeyType, HeaderType>::find(array_index index) const
 {
+    shared_lock lock(split_mutex_);
+
     auto vec_memo = std::make_shared<std::vector<memory_ptr>>();
     // find first item
     auto current = header_.read(index);
@@ -117,9 +140,11 @@ std::shared_ptr<std::vector<memory_ptr>> record_hash_table<KeyType>::find(array_
 }
 
 // This is limited to unlinking the first of multiple matching key values.
-template <typename KeyType>
-bool record_hash_table<KeyType>::unlink(const KeyType& key)
+template <typename KeyType, typename HeaderType>
+bool record_hash_table<KeyType, HeaderType>::unlink(const KeyType& key)
 {
+    unique_lock lock(mutex_);
+
     // Find start item...
     const auto begin = read_bucket_value(key);
     const record_row<KeyType> begin_item(manager_, begin);
@@ -128,6 +153,7 @@ bool record_hash_table<KeyType>::unlink(const KeyType& key)
     if (begin_item.compare(key))
     {
         link(key, begin_item.next_index());
+        header_.remove_entry();
         return true;
     }
 
@@ -144,6 +170,7 @@ bool record_hash_table<KeyType>::unlink(const KeyType& key)
         if (item.compare(key))
         {
             release(item, previous);
+            header_.remove_entry();
             return true;
         }
 
@@ -160,17 +187,41 @@ bool record_hash_table<KeyType>::unlink(const KeyType& key)
     return false;
 }
 
-template <typename KeyType>
-array_index record_hash_table<KeyType>::bucket_index(
+template <typename KeyType, typename HeaderType>
+uint64_t record_hash_table<KeyType, HeaderType>::count() const
+{
+    shared_lock lock(split_mutex_);
+
+    uint64_t entries = 0;
+    for (array_index bucket = 0; bucket < header_.size(); ++bucket)
+    {
+        auto current = header_.read(bucket);
+        while (current != header_.empty)
+        {
+            const record_row<KeyType> item(manager_, current);
+            ++entries;
+
+            const auto previous = current;
+            current = item.next_index();
+            if (previous == current)
+                break;
+        }
+    }
+
+    return entries;
+}
+
+template <typename KeyType, typename HeaderType>
+array_index record_hash_table<KeyType, HeaderType>::bucket_index(
     const KeyType& key) const
 {
-    const auto bucket = remainder(key, header_.size());
+    const auto bucket = header_.bucket(std::hash<KeyType>()(key));
     BITCOIN_ASSERT(bucket < header_.size());
     return bucket;
 }
 
-template <typename KeyType>
-array_index record_hash_table<KeyType>::read_bucket_value(
+template <typename KeyType, typename HeaderType>
+array_index record_hash_table<KeyType, HeaderType>::read_bucket_value(
     const KeyType& key) const
 {
     auto value = header_.read(bucket_index(key));
@@ -178,22 +229,55 @@ array_index record_hash_table<KeyType>::read_bucket_value(
     return value;
 }
 
-template <typename KeyType>
-void record_hash_table<KeyType>::link(const KeyType& key,
+template <typename KeyType, typename HeaderType>
+void record_hash_table<KeyType, HeaderType>::link(const KeyType& key,
     const array_index begin)
 {
     header_.write(bucket_index(key), begin);
 }
 
-template <typename KeyType>
+template <typename KeyType, typename HeaderType>
 template <typename ListItem>
-void record_hash_table<KeyType>::release(const ListItem& item,
+void record_hash_table<KeyType, HeaderType>::release(const ListItem& item,
     const file_offset previous)
 {
     ListItem previous_item(manager_, previous);
     previous_item.write_next_index(item.next_index());
 }
 
+// Items keep their relative order within the two resulting chains, so that
+// the first of multiple matching key values is still the latest stored.
+template <typename KeyType, typename HeaderType>
+void record_hash_table<KeyType, HeaderType>::split()
+{
+    const auto source = header_.grow();
+    auto current = header_.read(source);
+    header_.write(source, header_.empty);
+
+    // The last item of each chain as it is rebuilt, keyed by bucket.
+    std::pair<array_index, array_index> tails
+    {
+        header_.empty, header_.empty
+    };
+
+    while (current != header_.empty)
+    {
+        record_row<KeyType> item(manager_, current);
+        const auto next = item.next_index();
+        const auto bucket = header_.bucket(std::hash<KeyType>()(item.key()));
+        auto& tail = (bucket == source) ? tails.first : tails.second;
+
+        if (tail == header_.empty)
+            header_.write(bucket, current);
+        else
+            record_row<KeyType>(manager_, tail).write_next_index(current);
+
+        item.write_next_index(header_.empty);
+        tail = current;
+        current = next;
+    }
+}
+
 } // namespace database
 } // namespace libbitcoin
 
@@ -22,6 +22,7 @@
 #define MVS_DATABASE_RECORD_ROW_IPP
 
 #include <metaverse/database/memory/memory.hpp>
+#include "remainder.ipp"
 
 namespace libbitcoin {
 namespace database {
@@ -45,9 +46,15 @@ public:
 
     array_index create(const KeyType& key, const array_index next);
 
+    /// Overwrite this (released) item in place, keeping its index.
+    array_index recreate(const KeyType& key, const array_index next);
+
     /// Does this match?
     bool compare(const KeyType& key) const;
 
+    /// The key of this item.
+    KeyType key() const;
+
     /// The actual user data.
     const memory_ptr data() const;
 
@@ -83,7 +90,13 @@ array_index record_row<KeyType>::create(const KeyType& key,
     //   [ next:4   ]
     //   [ value... ]
     index_ = manager_.new_records(1);
+    return recreate(key, next);
+}
 
+template <typename KeyType>
+array_index record_row<KeyType>::recreate(const KeyType& key,
+    const array_index next)
+{
     // Write record.
     const auto memory = raw_data(0);
     const auto record = REMAP_ADDRESS(memory);
@@ -107,6 +120,14 @@ bool record_row<KeyType>::compare(const KeyType& key) const
     return std::equal(key.begin(), key.end(), REMAP_ADDRESS(memory));
 }
 
+template <typename KeyType>
+KeyType record_row<KeyType>::key() const
+{
+    // Key data is at the start.
+    const auto memory = raw_data(0);
+    return read_key<KeyType>(REMAP_ADDRESS(memory));
+}
+
 template <typename KeyType>
 const memory_ptr record_row<KeyType>::data() const
 {
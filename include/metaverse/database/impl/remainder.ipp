@@ -21,6 +21,7 @@
 #ifndef MVS_DATABASE_REMAINDER_IPP
 #define MVS_DATABASE_REMAINDER_IPP
 
+#include <algorithm>
 #include <cstdint>
 #include <functional>
 #include <metaverse/bitcoin.hpp>
@@ -35,6 +36,24 @@ Divisor remainder(const KeyType& key, const Divisor divisor)
     return divisor == 0 ? 0 : std::hash<KeyType>()(key) % divisor;
 }
 
+/// Read a key from the start of a table row.
+template <typename KeyType>
+KeyType read_key(const uint8_t* data)
+{
+    KeyType key;
+    std::copy(data, data + key.size(), key.begin());
+    return key;
+}
+
+template <>
+inline chain::point read_key<chain::point>(const uint8_t* data)
+{
+    auto deserial = make_deserializer_unsafe(data);
+    auto hash = deserial.read_hash();
+    const auto index = deserial.read_4_bytes_little_endian();
+    return chain::point(std::move(hash), index);
+}
+
 } // namespace database
 } // namespace libbitcoin
 
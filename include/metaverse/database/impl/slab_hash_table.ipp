@@ -29,8 +29,8 @@
 namespace libbitcoin {
 namespace database {
 
-template <typename KeyType>
-slab_hash_table<KeyType>::slab_hash_table(slab_hash_table_header& header,
+template <typename KeyType, typename HeaderType>
+slab_hash_table<KeyType, HeaderType>::slab_hash_table(HeaderType& header,
     slab_manager& manager)
   : header_(header), manager_(manager)
 {
@@ -40,11 +40,14 @@ slab_hash_table<KeyType>::slab_hash_table(slab_hash_table_header& header,
 // are store then retrieval and unlinking will fail as these multiples cannot
 // be differentiated. Therefore the database is not currently able to support
 // multiple transactions with the same hash, as required by BIP30.
-template <typename KeyType>
-file_offset slab_hash_table<KeyType>::store(const KeyType& key,
+template <typename KeyType, typename HeaderType>
+file_offset slab_hash_table<KeyType, HeaderType>::store(const KeyType& key,
     write_function write, const size_t value_size)
 {
-    mutex_.lock();
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
     // Store current bucket value.
     const auto old_begin = read_bucket_value(key);
     slab_row<KeyType> item(manager_, 0);
@@ -54,18 +57,23 @@ file_offset slab_hash_table<KeyType>::store(const KeyType& key,
     // Link record to header.
     link(key, new_begin);
 
-    mutex_.unlock();
+    if (header_.add_entry())
+    {
+        unique_lock split_lock(split_mutex_);
+        split();
+    }
 
     // Return position,
     return new_begin + item.value_begin;
+    ///////////////////////////////////////////////////////////////////////////
 }
 
 // This is not limited to store unique key values. If duplicate keyed values
 // are store then retrieval and unlinking will fail as these multiples cannot
 // be differentiated. Therefore the database is not currently able to support
 // multiple transactions with the same hash, as required by BIP30.
-template <typename KeyType>
-file_offset slab_hash_table<KeyType>::restore(const KeyType& key,
+template <typename KeyType, typename HeaderType>
+file_offset slab_hash_table<KeyType, HeaderType>::restore(const KeyType& key,
     write_function write, const size_t value_size)
 {
     mutex_.lock();
@@ -85,9 +93,11 @@ file_offset slab_hash_table<KeyType>::restore(const KeyType& key,
 }
 
 // This is limited to returning the first of multiple matching key values.
-template <typename KeyType>
-const memory_ptr slab_hash_table<KeyType>::find(const KeyType& key) const
+template <typename KeyType, typename HeaderType>
+const memory_ptr slab_hash_table<KeyType, HeaderType>::find(const KeyType& key) const
 {
+    shared_lock lock(split_mutex_);
+
     // Find start item...
     auto current = read_bucket_value(key);
 
@@ -117,9 +127,11 @@ const memory_ptr slab_hash_table<KeyType>::find(const KeyType& key) const
 }
 
 // This is limited to returning the last of multiple matching key values.
-template <typename KeyType>
-const memory_ptr slab_hash_table<KeyType>::rfind(const KeyType& key) const
+template <typename KeyType, typename HeaderType>
+const memory_ptr slab_hash_table<KeyType, HeaderType>::rfind(const KeyType& key) const
 {
+    shared_lock lock(split_mutex_);
+
     memory_ptr ret;
     // Find start item...
     auto current = read_bucket_value(key);
@@ -150,9 +162,11 @@ const memory_ptr slab_hash_table<KeyType>::rfind(const KeyType& key) const
 }
 
 // This is returning all of multiple matching key values.
-template <typename KeyType>
-std::vector<memory_ptr> slab_hash_table<KeyType>::finds(const KeyType& key) const
+template <typename KeyType, typename HeaderType>
+std::vector<memory_ptr> slab_hash_table<KeyType, HeaderType>::finds(const KeyType& key) const
 {
+    shared_lock lock(split_mutex_);
+
     std::vector<memory_ptr> ret;
     // Find start item...
     auto current = read_bucket_value(key);
@@ -184,9 +198,11 @@ std::vector<memory_ptr> slab_hash_table<KeyType>::finds(const KeyType& key) cons
 
 
 // This is limited to returning all the item in the special index.
-template <typename KeyType>
-std::shared_ptr<std::vector<memory_ptr>> slab_hash_table<KeyType>::find(uint64_t index) const
+template <typename KeyType, typename HeaderType>
+std::shared_ptr<std::vector<memory_ptr>> slab_hash_table<KeyType, HeaderType>::find(uint64_t index) const
 {
+    shared_lock lock(split_mutex_);
+
     auto vec_memo = std::make_shared<std::vector<memory_ptr>>();
     // find first item
     auto current = header_.read(index);
@@ -217,9 +233,11 @@ std::shared_ptr<std::vector<memory_ptr>> slab_hash_table<KeyType>::find(uint64_t
 }
 
 // This is limited to unlinking the first of multiple matching key values.
-template <typename KeyType>
-bool slab_hash_table<KeyType>::unlink(const KeyType& key)
+template <typename KeyType, typename HeaderType>
+bool slab_hash_table<KeyType, HeaderType>::unlink(const KeyType& key)
 {
+    unique_lock lock(mutex_);
+
     // Find start item...
     const auto begin = read_bucket_value(key);
     const slab_row<KeyType> begin_item(manager_, begin);
@@ -231,6 +249,7 @@ bool slab_hash_table<KeyType>::unlink(const KeyType& key)
     if (begin_item.compare(key))
     {
         link(key, begin_item.next_position());
+        header_.remove_entry();
         return true;
     }
 
@@ -250,6 +269,7 @@ bool slab_hash_table<KeyType>::unlink(const KeyType& key)
         if (item.compare(key))
         {
             release(item, previous);
+            header_.remove_entry();
             return true;
         }
 
@@ -266,16 +286,43 @@ bool slab_hash_table<KeyType>::unlink(const KeyType& key)
     return false;
 }
 
-template <typename KeyType>
-array_index slab_hash_table<KeyType>::bucket_index(const KeyType& key) const
+template <typename KeyType, typename HeaderType>
+uint64_t slab_hash_table<KeyType, HeaderType>::count() const
+{
+    shared_lock lock(split_mutex_);
+
+    uint64_t entries = 0;
+    for (array_index bucket = 0; bucket < header_.size(); ++bucket)
+    {
+        auto current = header_.read(bucket);
+        while (current != header_.empty)
+        {
+            const slab_row<KeyType> item(manager_, current);
+            if (item.out_of_memory())
+                break;
+
+            ++entries;
+
+            const auto previous = current;
+            current = item.next_position();
+            if (previous == current)
+                break;
+        }
+    }
+
+    return entries;
+}
+
+template <typename KeyType, typename HeaderType>
+array_index slab_hash_table<KeyType, HeaderType>::bucket_index(const KeyType& key) const
 {
-    const auto bucket = remainder(key, header_.size());
+    const auto bucket = header_.bucket(std::hash<KeyType>()(key));
     BITCOIN_ASSERT(bucket < header_.size());
     return bucket;
 }
 
-template <typename KeyType>
-file_offset slab_hash_table<KeyType>::read_bucket_value(
+template <typename KeyType, typename HeaderType>
+file_offset slab_hash_table<KeyType, HeaderType>::read_bucket_value(
     const KeyType& key) const
 {
     const auto value = header_.read(bucket_index(key));
@@ -283,22 +330,55 @@ file_offset slab_hash_table<KeyType>::read_bucket_value(
     return value;
 }
 
-template <typename KeyType>
-void slab_hash_table<KeyType>::link(const KeyType& key,
+template <typename KeyType, typename HeaderType>
+void slab_hash_table<KeyType, HeaderType>::link(const KeyType& key,
     const file_offset begin)
 {
     header_.write(bucket_index(key), begin);
 }
 
-template <typename KeyType>
+template <typename KeyType, typename HeaderType>
 template <typename ListItem>
-void slab_hash_table<KeyType>::release(const ListItem& item,
+void slab_hash_table<KeyType, HeaderType>::release(const ListItem& item,
     const file_offset previous)
 {
     ListItem previous_item(manager_, previous);
     previous_item.write_next_position(item.next_position());
 }
 
+// Items keep their relative order within the two resulting chains, so that
+// find and rfind still return the latest and earliest of matching keys.
+template <typename KeyType, typename HeaderType>
+void slab_hash_table<KeyType, HeaderType>::split()
+{
+    const auto source = header_.grow();
+    auto current = header_.read(source);
+    header_.write(source, header_.empty);
+
+    // The last item of each chain as it is rebuilt, keyed by bucket.
+    std::pair<file_offset, file_offset> tails
+    {
+        header_.empty, header_.empty
+    };
+
+    while (current != header_.empty)
+    {
+        slab_row<KeyType> item(manager_, current);
+        const auto next = item.next_position();
+        const auto bucket = header_.bucket(std::hash<KeyType>()(item.key()));
+        auto& tail = (bucket == source) ? tails.first : tails.second;
+
+        if (tail == header_.empty)
+            header_.write(bucket, current);
+        else
+            slab_row<KeyType>(manager_, tail).write_next_position(current);
+
+        item.write_next_position(header_.empty);
+        tail = current;
+        current = next;
+    }
+}
+
 } // namespace database
 } // namespace libbitcoin
 
@@ -22,6 +22,7 @@
 #define MVS_DATABASE_SLAB_LIST_IPP
 
 #include <metaverse/database/memory/memory.hpp>
+#include "remainder.ipp"
 
 namespace libbitcoin {
 namespace database {
@@ -49,6 +50,9 @@ public:
     /// Does this match?
     bool compare(const KeyType& key) const;
 
+    /// The key of this item.
+    KeyType key() const;
+
     /// The actual user data.
     const memory_ptr data() const;
 
@@ -114,6 +118,14 @@ bool slab_row<KeyType>::compare(const KeyType& key) const
     return std::equal(key.begin(), key.end(), REMAP_ADDRESS(memory));
 }
 
+template <typename KeyType>
+KeyType slab_row<KeyType>::key() const
+{
+    // Key data is at the start.
+    const auto memory = raw_data(0);
+    return read_key<KeyType>(REMAP_ADDRESS(memory));
+}
+
 template <typename KeyType>
 const memory_ptr slab_row<KeyType>::data() const
 {
@@ -29,6 +29,8 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 #include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/database/define.hpp>
@@ -38,7 +40,12 @@ namespace libbitcoin {
 namespace database {
 
 /// This class is thread safe, allowing concurent read and write.
-/// A change to the size of the memory map waits on and locks read and write.
+/// With REMAP_SAFETY a change to the size of the memory map waits on and
+/// locks read and write. Otherwise the file is mapped into a reservation of
+/// address space and grows in place, so reads are unlocked. If the file
+/// outgrows its reservation and the reservation cannot be extended in place,
+/// the file is mapped again elsewhere. The file pages of the previous mapping
+/// are retained until close, so that no returned pointer dangles.
 class BCD_API memory_map
 {
 public:
@@ -87,6 +94,13 @@ private:
     bool truncate_mapped(size_t size);
     bool validate(size_t size);
 
+#ifndef REMAP_SAFETY
+    size_t reservation(size_t size);
+    bool reserve_map(size_t size);
+    bool grow_reservation(size_t size);
+    bool extend_map(size_t size);
+#endif
+
     void log_mapping();
     void log_resizing(size_t size);
     void log_unmapped();
@@ -99,8 +113,17 @@ private:
     const boost::filesystem::path filename_;
 
     // Protected by internal mutex.
+#ifdef REMAP_SAFETY
     uint8_t* data_;
-    size_t file_size_;
+#else
+    // Read without a lock, written only under the internal mutex.
+    std::atomic<uint8_t*> data_;
+
+    // Address space reserved at data_, and mappings retained until close.
+    size_t reserved_;
+    std::vector<std::pair<uint8_t*, size_t>> retired_;
+#endif
+    std::atomic<size_t> file_size_;
     size_t logical_size_;
     std::atomic<bool> closed_;
     std::atomic<bool> stopped_;
@@ -70,6 +70,18 @@ public:
     /// The hash table size (bucket count).
     IndexType size() const;
 
+    /// The bucket of a key hash.
+    IndexType bucket(size_t hash) const;
+
+    /// Count an added entry, a fixed size table never splits a bucket.
+    bool add_entry();
+
+    /// Count a removed entry.
+    void remove_entry();
+
+    /// A fixed size table cannot grow, add_entry never requests a split.
+    IndexType grow();
+
 private:
 
     // Locate the item in the memory map.
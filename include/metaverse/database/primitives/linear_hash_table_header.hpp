@@ -0,0 +1,122 @@
+/**
+ * Copyright (c) 2011-2021 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2021 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_DATABASE_LINEAR_HASH_TABLE_HEADER_HPP
+#define MVS_DATABASE_LINEAR_HASH_TABLE_HEADER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/memory/memory_map.hpp>
+#include <metaverse/database/primitives/hash_table_header.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/**
+ * A hash table header which grows one bucket at a time (linear hashing).
+ *
+ * The first buckets are those of a fixed hash_table_header at the start of
+ * the table file, so that a fixed table converts without rehashing. Buckets
+ * added by splits are kept in a separate growth file:
+ *
+ *  [ buckets:IndexType  ]
+ *  [ entries:8          ]
+ *  [ [      ...       ] ]
+ *  [ [ item:ValueType ] ]
+ *  [ [      ...       ] ]
+ *
+ * With n base buckets a hash maps to hash % (n * 2^level), or to
+ * hash % (n * 2^(level + 1)) if that bucket has already been split in the
+ * current round. Splits are made by the owning table as entries are added.
+ */
+template <typename IndexType, typename ValueType>
+class linear_hash_table_header
+{
+public:
+    static const ValueType empty;
+
+    /// Average chain length above which a bucket is split.
+    static const uint64_t maximum_load;
+
+    linear_hash_table_header(memory_map& file, memory_map& growth_file,
+        IndexType buckets);
+
+    // Copy.
+    linear_hash_table_header(const linear_hash_table_header&) = delete;
+    linear_hash_table_header& operator=(const linear_hash_table_header&) = delete;
+
+    /// Allocate the hash table and populate with empty values.
+    bool create();
+
+    /// Allocate the growth file for an existing fixed size hash table.
+    /// The entry count is zero until set with set_entries.
+    bool convert();
+
+    /// Must be called before use. Loads the sizes from the files.
+    bool start();
+
+    /// Read item's value.
+    ValueType read(IndexType index) const;
+
+    /// Write value to item.
+    void write(IndexType index, ValueType value);
+
+    /// The hash table size (bucket count).
+    IndexType size() const;
+
+    /// The bucket of a key hash.
+    IndexType bucket(size_t hash) const;
+
+    /// Count an added entry, true if a bucket should now be split.
+    bool add_entry();
+
+    /// Count a removed entry.
+    void remove_entry();
+
+    /// Overwrite the entry count (used when converting).
+    void set_entries(uint64_t entries);
+
+    /// Append a bucket, returning the index of the bucket to be split into
+    /// it. The caller must relink that chain before releasing its lock.
+    IndexType grow();
+
+private:
+    // Locate the item in the growth file.
+    file_offset item_position(IndexType index) const;
+
+    // Load the derived addressing state from the bucket count.
+    void set_buckets(IndexType buckets);
+
+    hash_table_header<IndexType, ValueType> base_;
+    memory_map& growth_file_;
+    IndexType base_buckets_;
+    IndexType buckets_;
+    IndexType level_buckets_;
+    uint64_t entries_;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#include <metaverse/database/impl/linear_hash_table_header.ipp>
+
+#endif
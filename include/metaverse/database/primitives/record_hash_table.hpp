@@ -26,6 +26,7 @@
 #include <tuple>
 #include <metaverse/database/memory/memory.hpp>
 #include <metaverse/database/primitives/hash_table_header.hpp>
+#include <metaverse/database/primitives/linear_hash_table_header.hpp>
 #include <metaverse/database/primitives/record_manager.hpp>
 
 namespace libbitcoin {
@@ -39,6 +40,8 @@ BC_CONSTFUNC size_t hash_table_record_size(size_t value_size)
 }
 
 typedef hash_table_header<array_index, array_index> record_hash_table_header;
+typedef linear_hash_table_header<array_index, array_index>
+    linear_record_hash_table_header;
 
 /**
  * A hashtable mapping hashes to fixed sized values (records).
@@ -58,18 +61,28 @@ typedef hash_table_header<array_index, array_index> record_hash_table_header;
  * By using the record_manager instead of slabs, we can have smaller
  * indexes avoiding reading/writing extra bytes to the file.
  * Using fixed size records is therefore faster.
+ *
+ * With a linear_record_hash_table_header the table splits one bucket
+ * per store once the average chain length exceeds the maximum load.
  */
-template <typename KeyType>
+template <typename KeyType,
+    typename HeaderType=record_hash_table_header>
 class record_hash_table
 {
 public:
     typedef std::function<void(memory_ptr)> write_function;
 
-    record_hash_table(record_hash_table_header& header, record_manager& manager);
+    record_hash_table(HeaderType& header, record_manager& manager);
 
     /// Store a value. The provided write() function must write the correct
     /// number of bytes (record_size - key_size - sizeof(array_index)).
-    void store(const KeyType& key, write_function write);
+    /// Returns the index of the new record.
+    array_index store(const KeyType& key, write_function write);
+
+    /// Store a value into a record previously released by unlink. The table
+    /// does not track released records, the caller must own them.
+    array_index store(const KeyType& key, write_function write,
+        array_index record);
 
     /// Find the record for a given hash.
     /// Returns a null pointer if not found.
@@ -78,6 +91,9 @@ public:
     /// Delete a key-value pair from the hashtable by unlinking the node.
     bool unlink(const KeyType& key);
 
+    /// Count the linked entries by walking every chain (slow).
+    uint64_t count() const;
+
 private:
     // What is the bucket given a hash.
     array_index bucket_index(const KeyType& key) const;
@@ -92,9 +108,15 @@ private:
     template <typename ListItem>
     void release(const ListItem& item, const file_offset previous);
 
-    record_hash_table_header& header_;
+    // Divide the chain of the bucket at the split pointer with a new bucket.
+    void split();
+
+    HeaderType& header_;
     record_manager& manager_;
     shared_mutex mutex_;
+
+    // Readers share, a split of a chain is exclusive.
+    mutable shared_mutex split_mutex_;
 };
 
 } // namespace database
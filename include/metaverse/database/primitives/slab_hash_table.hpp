@@ -25,12 +25,15 @@
 #include <cstdint>
 #include <metaverse/database/memory/memory.hpp>
 #include <metaverse/database/primitives/hash_table_header.hpp>
+#include <metaverse/database/primitives/linear_hash_table_header.hpp>
 #include <metaverse/database/primitives/slab_manager.hpp>
 
 namespace libbitcoin {
 namespace database {
 
 typedef hash_table_header<array_index, file_offset> slab_hash_table_header;
+typedef linear_hash_table_header<array_index, file_offset>
+    linear_slab_hash_table_header;
 
 /**
  * A hashtable mapping hashes to variable sized values (slabs).
@@ -51,14 +54,18 @@ typedef hash_table_header<array_index, file_offset> slab_hash_table_header;
  * data can be lost but the hashtable is never corrupted.
  * Instead we prefer speed and batch that operation. The user should
  * call allocator.sync() after a series of store() calls.
+ *
+ * With a linear_slab_hash_table_header the table splits one bucket
+ * per store once the average chain length exceeds the maximum load.
  */
-template <typename KeyType>
+template <typename KeyType,
+    typename HeaderType=slab_hash_table_header>
 class slab_hash_table
 {
 public:
     typedef std::function<void(memory_ptr)> write_function;
 
-    slab_hash_table(slab_hash_table_header& header, slab_manager& manager);
+    slab_hash_table(HeaderType& header, slab_manager& manager);
 
     /// Store a value. value_size is the requested size for the value.
     /// The provided write() function must write exactly value_size bytes.
@@ -76,6 +83,9 @@ public:
     /// Delete a key-value pair from the hashtable by unlinking the node.
     bool unlink(const KeyType& key);
 
+    /// Count the linked entries by walking every chain (slow).
+    uint64_t count() const;
+
 private:
 
     // What is the bucket given a hash.
@@ -91,9 +101,15 @@ private:
     template <typename ListItem>
     void release(const ListItem& item, const file_offset previous);
 
-    slab_hash_table_header& header_;
+    // Divide the chain of the bucket at the split pointer with a new bucket.
+    void split();
+
+    HeaderType& header_;
     slab_manager& manager_;
     shared_mutex mutex_;
+
+    // Readers share, a split of a chain is exclusive.
+    mutable shared_mutex split_mutex_;
 };
 
 } // namespace database
@@ -0,0 +1,90 @@
+/**
+ * Copyright (c) 2011-2021 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2021 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_DATABASE_SYMBOL_INDEX_HPP
+#define MVS_DATABASE_SYMBOL_INDEX_HPP
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/define.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// This class is thread safe.
+/// An ordered index from symbol to its slab hash table key, so that symbol
+/// tables can be listed in order without walking every hash bucket.
+/// It is loaded from the table on first use and then kept in sync by the
+/// owning database on store and remove.
+class BCD_API symbol_index
+{
+public:
+    typedef std::function<void(const std::string&, const hash_digest&)>
+        visitor;
+    typedef std::function<void(visitor)> loader;
+    typedef std::function<bool(const std::string&)> filter;
+
+    symbol_index(loader load);
+
+    /// Index the symbol of a stored key.
+    void insert(const std::string& symbol, const hash_digest& key);
+
+    /// Drop a key once no record remains under it.
+    void erase(const hash_digest& key);
+
+    /// Forget all keys, the table was recreated.
+    void clear();
+
+    /// The number of indexed symbols starting with prefix and ordered after
+    /// the cursor symbol.
+    size_t size(const std::string& prefix="", const std::string& after="") const;
+
+    /// Keys of the symbols starting with prefix and ordered after the
+    /// cursor symbol, in symbol order, skipping the first skip of them.
+    /// Symbols matched by exclude are passed over before paging.
+    /// A limit of zero is unbounded.
+    hash_list scan(const std::string& prefix="", const std::string& after="",
+        size_t limit=0, size_t skip=0, const filter& exclude=nullptr) const;
+
+private:
+    typedef std::map<std::string, hash_digest> symbol_map;
+    typedef std::unordered_map<hash_digest, std::string> key_map;
+
+    symbol_map::const_iterator first(const std::string& prefix,
+        const std::string& after) const;
+    void load() const;
+
+    const loader load_;
+
+    // The maps are protected by mutex.
+    mutable bool loaded_;
+    mutable symbol_map symbols_;
+    mutable key_map keys_;
+    mutable unique_mutex mutex_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
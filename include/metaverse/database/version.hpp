@@ -24,12 +24,32 @@
  * 1. for DID (Digital IDentities) support, adding some new tables.
  *    these tables can be created automatically if not exist.
  *    this way only soft fork is needed when user upgrade.
+ *
+ * 2026.10.17 modify to 0.6.5
+ * 1. add address utxo tables, indexing the unspent outputs of each address.
+ *    these tables are rebuilt from the local block database when upgrading.
+ *
+ * 2026.10.17 modify to 0.6.6
+ * 1. block, spend and transaction hash tables grow by linear hashing,
+ *    buckets added by splits are kept in new *_table_buckets files.
+ *    the existing buckets are kept, upgrading only counts their entries.
+ *
+ * 2026.10.17 modify to 0.6.7
+ * 1. history rows are packed per address into height ordered pages, by column.
+ *    these are rebuilt from the local block database when upgrading,
+ *    replacing the history_table and history_rows files.
+ *
+ * 2026.10.17 modify to 0.6.8
+ * 1. address asset, did and mit rows are keyed by the address hash160
+ *    instead of the hash of the encoded address string.
+ *    these are rebuilt from the local block database when upgrading,
+ *    into the new address_*_key_table and address_*_key_row files.
  */
-#define MVS_DATABASE_VERSION "0.6.4"
+#define MVS_DATABASE_VERSION "0.6.8"
 
 #define MVS_DATABASE_MAJOR_VERSION 0
 #define MVS_DATABASE_MINOR_VERSION 6
-#define MVS_DATABASE_PATCH_VERSION 4
+#define MVS_DATABASE_PATCH_VERSION 8
 
 #define MVS_DATABASE_VERSION_NUMBER (((MVS_DATABASE_MAJOR_VERSION)*100) + ((MVS_DATABASE_MINOR_VERSION)*10) + (MVS_DATABASE_PATCH_VERSION))
 
@@ -69,6 +69,19 @@ BCX_API console_result dispatch_command(int argc, const char* argv[],
     Json::Value& jv_output,
     bc::server::server_node& node, uint8_t api_version = 1);
 
+/**
+ * Invoke the command by name with json-rpc params bound directly to its
+ * typed fields, without building argv or running program_options.
+ * @param[in]  method  The command symbolic name.
+ * @param[in]  params  The json-rpc params array.
+ * @param[out] result  The console return code when the command ran.
+ * @return             False if the command has no direct binding for these
+ *                     params, the caller then uses the argv dispatch.
+ */
+BCX_API bool dispatch_json(const std::string& method, const Json::Value& params,
+    Json::Value& jv_output, console_result& result,
+    bc::server::server_node& node, uint8_t api_version = 1);
+
 } // namespace explorer
 } // namespace libbitcoin
 
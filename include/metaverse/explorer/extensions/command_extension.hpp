@@ -23,6 +23,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/explorer/define.hpp>
 #include <metaverse/explorer/command.hpp>
@@ -221,7 +222,90 @@ public:
         return console_result::failure;
     }
 
+    /**
+     * Load typed parameters straight from json-rpc params, skipping argv
+     * and program_options. Return false to fall back to the argv path,
+     * which also produces the usual error for malformed parameters.
+     */
+    virtual bool bind_json(const Json::Value& params)
+    {
+        return false;
+    }
+
 protected:
+    /**
+     * Split json-rpc params into positional values and named options.
+     * Returns false for shapes only the argv path understands: a string
+     * that looks like a command line option, or more than one object.
+     */
+    static bool split_json_params(const Json::Value& params,
+        std::vector<const Json::Value*>& positional,
+        const Json::Value*& options)
+    {
+        options = nullptr;
+        if (params.isNull())
+            return true;
+        if (!params.isArray())
+            return false;
+
+        for (const auto& param : params) {
+            if (param.isObject()) {
+                if (options != nullptr)
+                    return false;
+                options = &param;
+                continue;
+            }
+
+            if (param.isString() && !param.asString().empty()
+                && param.asString().front() == '-')
+                return false;
+
+            positional.push_back(&param);
+        }
+
+        return true;
+    }
+
+    /// Read a boolean as program_options would from its string form.
+    static bool json_to_bool(const Json::Value& value, bool& out)
+    {
+        if (value.isBool()) {
+            out = value.asBool();
+            return true;
+        }
+
+        if (value.isIntegral()) {
+            out = value.asInt64() != 0;
+            return true;
+        }
+
+        if (!value.isString())
+            return false;
+
+        const auto text = value.asString();
+        if (text == "true" || text == "1" || text == "yes" || text == "on") {
+            out = true;
+            return true;
+        }
+
+        if (text == "false" || text == "0" || text == "no" || text == "off") {
+            out = false;
+            return true;
+        }
+
+        return false;
+    }
+
+    /// Read a string the way HttpMessage would have placed it in argv.
+    static bool json_to_string(const Json::Value& value, std::string& out)
+    {
+        if (!value.isString() && !value.isIntegral())
+            return false;
+
+        out = value.asString();
+        return true;
+    }
+
     struct argument_base
     {
         std::string name;
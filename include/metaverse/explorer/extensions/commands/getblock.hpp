@@ -91,6 +91,45 @@ public:
     {
     }
 
+    bool bind_json(const Json::Value& params) override
+    {
+        std::vector<const Json::Value*> positional;
+        const Json::Value* options;
+        if (!split_json_params(params, positional, options)
+            || positional.empty() || positional.size() > 3)
+            return false;
+
+        if (!json_to_string(*positional[0], argument_.hash_or_height))
+            return false;
+
+        option_.json = true;
+        option_.tx_json = true;
+
+        if (positional.size() > 1 && !json_to_bool(*positional[1], option_.json))
+            return false;
+        if (positional.size() > 2 && !json_to_bool(*positional[2], option_.tx_json))
+            return false;
+
+        if (options != nullptr) {
+            for (const auto& key : options->getMemberNames()) {
+                const auto& value = (*options)[key];
+                if (key == "json") {
+                    if (!json_to_bool(value, option_.json))
+                        return false;
+                }
+                else if (key == "tx_json") {
+                    if (!json_to_bool(value, option_.tx_json))
+                        return false;
+                }
+                else {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
     console_result invoke (Json::Value& jv_output,
          libbitcoin::server::server_node& node) override;
 
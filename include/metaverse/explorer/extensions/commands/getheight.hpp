@@ -84,6 +84,22 @@ public:
     {
     }
 
+    bool bind_json(const Json::Value& params) override
+    {
+        std::vector<const Json::Value*> positional;
+        const Json::Value* options;
+        if (!split_json_params(params, positional, options)
+            || (options != nullptr && !options->empty()) || positional.size() > 2)
+            return false;
+
+        if (positional.size() > 0 && !json_to_string(*positional[0], auth_.name))
+            return false;
+        if (positional.size() > 1 && !json_to_string(*positional[1], auth_.auth))
+            return false;
+
+        return true;
+    }
+
     console_result invoke (Json::Value& jv_output,
          libbitcoin::server::server_node& node) override;
 
@@ -86,6 +86,35 @@ public:
     {
     }
 
+    bool bind_json(const Json::Value& params) override
+    {
+        std::vector<const Json::Value*> positional;
+        const Json::Value* options;
+        if (!split_json_params(params, positional, options)
+            || positional.empty() || positional.size() > 2)
+            return false;
+
+        std::string hash;
+        hash_digest digest;
+        if (!json_to_string(*positional[0], hash) || !decode_hash(digest, hash))
+            return false;
+
+        argument_.hash = bc::config::hash256(digest);
+        option_.json = true;
+
+        if (positional.size() > 1 && !json_to_bool(*positional[1], option_.json))
+            return false;
+
+        if (options != nullptr) {
+            for (const auto& key : options->getMemberNames()) {
+                if (key != "json" || !json_to_bool((*options)[key], option_.json))
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
     console_result invoke (Json::Value& jv_output,
              libbitcoin::server::server_node& node) override;
 
@@ -85,6 +85,21 @@ public:
             value<std::string>(&option_.cert_type)->default_value(""),
             "If specified, then only get related type of cert. Default is not specified."
         )
+        (
+            "prefix,p",
+            value<std::string>(&option_.prefix)->default_value(""),
+            "Only list assets in blockchain whose symbol starts with this prefix. Default is empty."
+        )
+        (
+            "after,a",
+            value<std::string>(&option_.after)->default_value(""),
+            "Only list assets in blockchain ordered after this symbol. Default is empty."
+        )
+        (
+            "limit,l",
+            value<uint64_t>(&option_.limit)->default_value(0),
+            "Maximum count of assets in blockchain to list, zero lists all. Default is 0."
+        )
         ;
 
         return options;
@@ -105,6 +120,9 @@ public:
     {
         bool is_cert;
         std::string cert_type;
+        std::string prefix;
+        std::string after;
+        uint64_t limit;
     } option_;
 
 };
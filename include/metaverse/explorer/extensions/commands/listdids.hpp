@@ -84,6 +84,16 @@ public:
             "index,i",
             value<uint64_t>(&argument_.index)->default_value(1),
             "Page index. Default is 1."
+        )
+        (
+            "prefix,p",
+            value<std::string>(&argument_.prefix)->default_value(""),
+            "Only list DIDs whose symbol starts with this prefix. Default is empty."
+        )
+        (
+            "after,a",
+            value<std::string>(&argument_.after)->default_value(""),
+            "Only list DIDs ordered after this symbol, the page index is then ignored. Default is empty."
         );
 
         return options;
@@ -102,6 +112,8 @@ public:
         {};
         uint64_t limit;
         uint64_t index;
+        std::string prefix;
+        std::string after;
     } argument_;
 
     struct option
@@ -74,6 +74,21 @@ public:
             "ACCOUNTAUTH",
             value<std::string>(&auth_.auth),
             BX_ACCOUNT_AUTH
+        )
+        (
+            "prefix,p",
+            value<std::string>(&option_.prefix)->default_value(""),
+            "Only list MITs in blockchain whose symbol starts with this prefix. Default is empty."
+        )
+        (
+            "after,a",
+            value<std::string>(&option_.after)->default_value(""),
+            "Only list MITs in blockchain ordered after this symbol. Default is empty."
+        )
+        (
+            "limit,l",
+            value<uint64_t>(&option_.limit)->default_value(0),
+            "Maximum count of MITs in blockchain to list, zero lists all. Default is 0."
         );
 
         return options;
@@ -90,6 +105,15 @@ public:
     {
     } argument_;
 
+    struct option
+    {
+        option():limit(0)
+        {};
+        std::string prefix;
+        std::string after;
+        uint64_t limit;
+    } option_;
+
 };
 
 
@@ -98,7 +98,12 @@ public:
         (
             "index,i",
             value<uint64_t>(&argument_.index)->default_value(1),
-            "Page index."
+            "Page index, ignored if a cursor is given."
+        )
+        (
+            "cursor,c",
+            value<std::string>(&option_.cursor),
+            "The cursor returned with the previous page, the next page follows it."
         )
         ;
 
@@ -125,9 +130,10 @@ public:
 
     struct option
     {
-        option(): height(0, 0)
+        option(): height(0, 0), cursor("")
         {};
         libbitcoin::explorer::commands::colon_delimited2_item<uint64_t, uint64_t> height;
+        std::string cursor;
     } option_;
 
 };
@@ -96,6 +96,11 @@ public:
             value<std::string>(&option_.consensus)->default_value("pow"),
             "Accept block with the specified consensus, eg. pow, pos, defaults to pow."
         )
+        (
+            "threads,t",
+            value<uint16_t>(&option_.threads)->default_value(0),
+            "The number of pow mining threads. Defaults to 0, means one per hardware thread."
+        )
         ;
 
         return options;
@@ -118,6 +123,7 @@ public:
         uint16_t number;
         std::string consensus = "pow";
         std::string symbol = "";
+        uint16_t threads;
     } option_;
 
 };
@@ -9,10 +9,21 @@
 #include <metaverse/blockchain.hpp>
 #include <metaverse/server/services/query_service.hpp> //public_query
 
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 namespace libbitcoin{
 namespace server{
     class server_node;
 }
+namespace explorer{
+    class explorer_exception;
+}
 }
 
 namespace mgbubble{
@@ -44,8 +55,12 @@ public:
     void reset(HttpMessage& data) noexcept;
 
     bool start() override;
+    void stop() override;
 
-    void spawn_to_mongoose(const std::function<void(uint64_t)>&& handler);
+    bool spawn_to_mongoose(const std::function<void(uint64_t)>&& handler);
+
+    /// Number of rpc calls accepted but not yet started by a worker.
+    size_t rpc_queue_depth() const noexcept { return rpc_queue_depth_; }
 
 protected:
     void run() override;
@@ -55,6 +70,8 @@ protected:
     void on_ws_handshake_done_handler(struct mg_connection& nc) override;
     void on_ws_frame_handler(struct mg_connection& nc, struct websocket_message& msg) override;
 
+    void on_close_handler(struct mg_connection& nc) override;
+
     void check_rpc_client_addresses(struct mg_connection& nc);
 
 private:
@@ -74,15 +91,69 @@ private:
       MatchMask = MatchMethod | MatchUri
     };
 
+    struct rpc_job
+    {
+        std::string method;
+        std::function<void()> run;
+    };
+
+    // A response body in pieces, sent back to back without joining.
+    typedef std::vector<std::string> rpc_parts;
+
+    struct rpc_connection
+    {
+        bool websocket{false};
+        uint64_t generation{0};
+        uint64_t issued{0};
+        uint64_t sent{0};
+        std::map<uint64_t, rpc_parts> ready;
+    };
+
     bool isSet(int bs) const noexcept { return (state_ & bs) == bs; }
 
+    // rpc dispatch, safe to call on any thread.
+    std::string rpc_invoke(const std::vector<std::string>& args,
+        const Json::Value& params, int64_t id, uint8_t rpc_version);
+    std::string rpc_error(const libbitcoin::explorer::explorer_exception& e,
+        int64_t id, uint8_t rpc_version) const;
+    bool rpc_exclusive(const std::string& method) const;
+    std::string ws_invoke(const std::vector<std::string>& args);
+    std::string ws_error(const std::string& message) const;
+
+    // rpc scheduling, per-method concurrency is bounded by settings.
+    void rpc_submit(rpc_job&& job);
+    void rpc_post(rpc_job&& job);
+    void rpc_finish(const std::string& method);
+    void rpc_batch(mg_connection& nc, uint64_t generation, uint64_t order,
+        const std::vector<JsonRpcCall>& calls, uint8_t rpc_version);
+    void rpc_complete(mg_connection* connection, uint64_t generation,
+        uint64_t order, std::shared_ptr<rpc_parts> parts);
+    void rpc_deliver(mg_connection& nc, uint64_t order, rpc_parts&& parts);
+    void rpc_flush();
+
     // config
-    static thread_local OStream out_;
     static thread_local Tokeniser<'/'> uri_;
     static thread_local int state_;
     const char* const servername_{"Metaverse " MVS_VERSION};
     libbitcoin::server::server_node &node_;
     std::string document_root_;
+
+    // rpc workers, commands run here instead of on the mongoose thread.
+    libbitcoin::threadpool rpc_pool_;
+    std::atomic<size_t> rpc_queue_depth_{0};
+
+    // Only touched on the mongoose thread.
+    uint64_t rpc_generation_{0};
+    std::unordered_map<mg_connection*, rpc_connection> rpc_connections_;
+
+    // Protected by rpc_mutex_.
+    std::unordered_map<std::string, uint32_t> rpc_running_;
+    std::deque<rpc_job> rpc_waiting_;
+    std::vector<std::function<void(uint64_t)>> rpc_undelivered_;
+    mutable std::mutex rpc_mutex_;
+
+    // Account and admin commands never overlap, as on a single thread.
+    std::mutex exclusive_mutex_;
 };
 
 } // mgbubble
@@ -44,6 +44,7 @@ class ToCommandArg{
 public:
     auto argv() const noexcept { return argv_; }
     auto argc() const noexcept { return argc_; }
+    const auto& args() const noexcept { return vargv_; }
     const auto& get_command() const {
         if(!vargv_.empty())
             return vargv_[0];
@@ -62,6 +63,15 @@ protected:
     std::vector<std::string> vargv_;
 };
 
+/// One entry of a json-rpc batch, either arguments or a request error.
+struct JsonRpcCall {
+    std::vector<std::string> args;
+    Json::Value params;
+    int64_t id{-1};
+    int32_t error_code{0};
+    std::string error_message;
+};
+
 class HttpMessage : public ToCommandArg{
 public:
     HttpMessage(http_message* impl) noexcept : impl_{impl}, jsonrpc_id_(-1){}
@@ -89,12 +99,19 @@ public:
     auto body() const noexcept { return +impl_->body; }
 
     const int64_t jsonrpc_id() const noexcept { return jsonrpc_id_; }
+    const Json::Value& jsonrpc_params() const noexcept { return jsonrpc_params_; }
+    const std::vector<JsonRpcCall>& batch() const noexcept { return batch_; }
+
+    /// Largest number of calls accepted in one batch request.
+    static const size_t max_batch_calls{100};
 
     void data_to_arg(uint8_t rpc_version) override;
 
 private:
     int64_t jsonrpc_id_;
     http_message* impl_;
+    Json::Value jsonrpc_params_;
+    std::vector<JsonRpcCall> batch_;
 };
 
 class WebsocketMessage:public ToCommandArg { // connect to bx command-tool
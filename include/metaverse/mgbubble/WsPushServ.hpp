@@ -21,10 +21,12 @@
 #include <vector>
 #include <atomic>
 #include <mutex>
+#include <set>
 #include <memory>
 #include <unordered_map>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/mgbubble/MgServer.hpp>
+#include <metaverse/server/utility/prefix_index.hpp>
 
 namespace libbitcoin {
 namespace server {
@@ -106,8 +108,6 @@ protected:
         struct mg_connection& nc, const std::string& event,
         const std::string& channel, Json::Value data = Json::nullValue);
 
-    void refresh_connections();
-
 protected:
     void run() override;
 
@@ -120,8 +120,16 @@ protected:
 
 private:
     typedef std::vector<std::string> string_vector;
-    typedef std::map<std::weak_ptr<mg_connection>, string_vector,
-            std::owner_less<std::weak_ptr<mg_connection>>> connection_string_map;
+    typedef std::weak_ptr<mg_connection> connection_ptr;
+    typedef std::owner_less<connection_ptr> connection_less;
+    typedef std::map<connection_ptr, string_vector,
+            connection_less> connection_string_map;
+    typedef bc::server::prefix_index<connection_ptr,
+            std::set<connection_ptr, connection_less>> connection_index;
+
+    // Add or remove the subscription's addresses, empty subscribes to all.
+    void index_subscription(const connection_ptr& con,
+        const string_vector& addresses, bool add);
 
     void do_notify(
         const std::vector<std::weak_ptr<mg_connection>>& notify_cons,
@@ -136,6 +144,9 @@ private:
     connection_string_map subscribers_;
     std::mutex subscribers_lock_;
 
+    // Transaction subscribers by address hash, shares subscribers_lock_.
+    connection_index address_index_;
+
     connection_string_map block_subscribers_;
     std::mutex block_subscribers_lock_;
 };
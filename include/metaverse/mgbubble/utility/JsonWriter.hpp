@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2016-2021 metaverse core developers (see MVS-AUTHORS) - Metaverse.
+ *
+ * This program is free software; you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if
+ * not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+#ifndef MVSD_JSON_WRITER_HPP
+#define MVSD_JSON_WRITER_HPP
+
+#include <metaverse/mgbubble/compat/define.hpp>
+#include <jsoncpp/json/json.h>
+
+#include <ostream>
+#include <string>
+
+/**
+ * @addtogroup Util
+ * @{
+ */
+
+namespace mgbubble {
+
+/**
+ * Compact json serialiser. The value is walked once and written straight to the sink, without
+ * the intermediate document toStyledString() builds and indents. Pretty output is opt-in and
+ * matches toStyledString().
+ */
+MVS_API void writeJson(std::string& out, const Json::Value& value, bool pretty = false);
+MVS_API void writeJson(std::ostream& os, const Json::Value& value, bool pretty = false);
+
+inline std::string toJson(const Json::Value& value, bool pretty = false)
+{
+  std::string out;
+  writeJson(out, value, pretty);
+  return out;
+}
+
+} // mgbubble
+
+/** @} */
+
+#endif // MVSD_JSON_WRITER_HPP
@@ -128,6 +128,12 @@ public:
     /// Determine if the network is stopped.
     virtual bool stopped() const;
 
+    /// Take one of 'limit' slots for peers relaying blocks unannounced.
+    virtual bool reserve_high_bandwidth(size_t limit);
+
+    /// Return a slot taken by reserve_high_bandwidth.
+    virtual void release_high_bandwidth();
+
     /// Return a reference to the network threadpool.
     virtual threadpool& thread_pool();
 
@@ -244,6 +250,7 @@ private:
     // These are thread safe.
     std::atomic<bool> stopped_;
     std::atomic<size_t> height_;
+    std::atomic<size_t> high_bandwidth_peers_;
     bc::atomic<session_manual::ptr> manual_;
     threadpool threadpool_;
     hosts::ptr hosts_;
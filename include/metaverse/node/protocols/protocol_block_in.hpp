@@ -23,10 +23,13 @@
 
 #include <atomic>
 #include <cstddef>
+#include <map>
 #include <memory>
+#include <vector>
 #include <metaverse/blockchain.hpp>
 #include <metaverse/network.hpp>
 #include <metaverse/node/define.hpp>
+#include <metaverse/node/utility/compact_requests.hpp>
 
 namespace libbitcoin {
 namespace node {
@@ -39,7 +42,8 @@ public:
 
     /// Construct a block protocol instance.
     protocol_block_in(network::p2p& network, network::channel::ptr channel,
-        blockchain::block_chain& blockchain);
+        blockchain::block_chain& blockchain,
+        blockchain::transaction_pool& pool);
 
     ptr do_subscribe();
 
@@ -54,16 +58,43 @@ private:
     typedef message::inventory::ptr inventory_ptr;
     typedef message::not_found::ptr not_found_ptr;
     typedef message::block_message::ptr_list block_ptr_list;
+    typedef message::compact_block::ptr compact_block_ptr;
+    typedef message::block_transactions::ptr block_transactions_ptr;
+    typedef message::transaction_message::ptr transaction_ptr;
+    typedef std::vector<transaction_ptr> transaction_ptr_list;
+
+    /// A block being reconstructed from a compact block, awaiting the
+    /// transactions at the missing indexes.
+    struct partial_block
+    {
+        block_ptr block;
+        std::vector<uint64_t> missing;
+        asio::time_point started;
+    };
+
+    typedef std::map<hash_digest, partial_block> partial_block_map;
 
     void get_block_inventory(const code& ec);
     void send_get_blocks(const hash_digest& stop_hash);
     void send_get_blocks(const hash_digest& from_hash, const hash_digest& to_hash);
     void send_get_data(const code& ec, get_data_ptr message);
+    void send_get_block(const hash_digest& hash);
+    void send_send_compact_blocks();
 
     bool handle_receive_block(const code& ec, block_ptr message);
     bool handle_receive_headers(const code& ec, headers_ptr message);
     bool handle_receive_inventory(const code& ec, inventory_ptr message);
     bool handle_receive_not_found(const code& ec, not_found_ptr message);
+    bool handle_receive_compact_block(const code& ec,
+        compact_block_ptr message);
+    bool handle_receive_block_transactions(const code& ec,
+        block_transactions_ptr message);
+    void handle_fetch_pool(const code& ec,
+        const transaction_ptr_list& transactions, compact_block_ptr message);
+    void handle_reconstructed(block_ptr block);
+    void release_high_bandwidth();
+    void expire_compact_blocks();
+    void handle_requested_block();
     void handle_filter_orphans(const code& ec, get_data_ptr message);
     void handle_store_block(const code& ec, block_ptr message);
     void handle_fetch_block_locator(const code& ec, const hash_list& locator,
@@ -71,11 +102,22 @@ private:
     bool handle_reorganized(const code& ec, size_t fork_point,
         const block_ptr_list& incoming, const block_ptr_list& outgoing);
 
+    network::p2p& network_;
     blockchain::block_chain& blockchain_;
     bc::atomic<hash_digest> last_locator_top_;
     bc::atomic<hash_digest> current_chain_top_;
     const bool headers_from_peer_;
     std::atomic_int headers_batch_size_;
+
+    blockchain::transaction_pool& pool_;
+    const bool compact_from_peer_;
+    std::atomic<bool> high_bandwidth_;
+
+    compact_requests compact_requests_;
+
+    // Protected by mutex.
+    partial_block_map partial_blocks_;
+    mutable shared_mutex mutex_;
 };
 
 } // namespace node
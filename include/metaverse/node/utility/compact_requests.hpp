@@ -0,0 +1,57 @@
+/**
+ * Copyright (c) 2011-2021 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_NODE_COMPACT_REQUESTS_HPP
+#define MVS_NODE_COMPACT_REQUESTS_HPP
+
+#include <cstddef>
+#include <map>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+/// Compact blocks requested from a peer and not yet answered, thread safe.
+/// Each request is answered once, by a compact block, a full block, a
+/// not_found or by expiring.
+class BCN_API compact_requests
+{
+public:
+    /// Track a request sent at the given time.
+    void insert(const hash_digest& hash, asio::time_point requested);
+
+    /// Forget an answered request, true if it was outstanding.
+    bool erase(const hash_digest& hash);
+
+    /// Drop the requests sent before the cutoff, return how many.
+    size_t expire(asio::time_point cutoff);
+
+    /// The number of outstanding requests.
+    size_t size() const;
+
+private:
+    std::map<hash_digest, asio::time_point> requests_;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace node
+} // namespace libbitcoin
+
+#endif
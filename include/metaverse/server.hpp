@@ -35,6 +35,7 @@
 #include <metaverse/server/utility/address_key.hpp>
 #include <metaverse/server/utility/authenticator.hpp>
 #include <metaverse/server/utility/fetch_helpers.hpp>
+#include <metaverse/server/utility/prefix_index.hpp>
 #include <metaverse/server/workers/notification_worker.hpp>
 #include <metaverse/server/workers/query_worker.hpp>
 
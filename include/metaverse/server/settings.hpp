@@ -48,6 +48,9 @@ public:
     std::string websocket_listen;
     std::string log_level;
     std::string rpc_version;
+    uint16_t rpc_threads;
+    uint16_t rpc_method_concurrency;
+    bool pretty_json;
     bool administrator_required;
     bool secure_only;
 
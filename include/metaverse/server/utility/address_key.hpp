@@ -39,8 +39,9 @@ public:
     const binary& prefix_filter() const;
 
 private:
-    const route& reply_to_;
-    const binary& prefix_filter_;
+    // Copies, the key outlives the subscription request.
+    route reply_to_;
+    binary prefix_filter_;
 };
 
 } // namespace server
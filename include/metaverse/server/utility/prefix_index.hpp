@@ -0,0 +1,137 @@
+/**
+ * Copyright (c) 2011-2021 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2021 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse-server.
+ *
+ * metaverse-server is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_SERVER_PREFIX_INDEX_HPP
+#define MVS_SERVER_PREFIX_INDEX_HPP
+
+#include <cstddef>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/server/define.hpp>
+
+namespace libbitcoin {
+namespace server {
+
+/// This class is thread safe.
+/// Maps binary prefix filters to the subscribers registered for them, so the
+/// subscribers matching a field are found with one lookup per distinct
+/// prefix length in use, rather than by testing every subscriber. An empty
+/// prefix matches every field.
+template <typename Subscriber,
+    typename Bucket = std::unordered_set<Subscriber>>
+class prefix_index
+{
+public:
+    prefix_index()
+      : size_(0)
+    {
+    }
+
+    /// Register the subscriber for fields starting with prefix.
+    /// Returns false if it was already registered for the prefix.
+    bool insert(const binary& prefix, const Subscriber& subscriber)
+    {
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section
+        unique_lock lock(mutex_);
+
+        if (!buckets_[prefix].insert(subscriber).second)
+            return false;
+
+        ++lengths_[prefix.size()];
+        ++size_;
+        return true;
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    /// Remove the subscriber from the prefix.
+    /// Returns false if it was not registered for the prefix.
+    bool erase(const binary& prefix, const Subscriber& subscriber)
+    {
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section
+        unique_lock lock(mutex_);
+
+        const auto bucket = buckets_.find(prefix);
+        if (bucket == buckets_.end() || bucket->second.erase(subscriber) == 0)
+            return false;
+
+        if (bucket->second.empty())
+            buckets_.erase(bucket);
+
+        const auto length = lengths_.find(prefix.size());
+        if (--length->second == 0)
+            lengths_.erase(length);
+
+        --size_;
+        return true;
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    /// Invoke handler(prefix, subscriber) for each registration whose prefix
+    /// is a prefix of field. The handler must not modify this index.
+    template <typename Handler>
+    void find(const binary& field, Handler handler) const
+    {
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section
+        shared_lock lock(mutex_);
+
+        for (const auto& length: lengths_)
+        {
+            // Lengths are ordered, so no longer prefix can match.
+            if (length.first > field.size())
+                break;
+
+            const binary prefix(length.first, field.blocks());
+            const auto bucket = buckets_.find(prefix);
+            if (bucket == buckets_.end())
+                continue;
+
+            for (const auto& subscriber: bucket->second)
+                handler(prefix, subscriber);
+        }
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    /// The number of registrations.
+    size_t size() const
+    {
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section
+        shared_lock lock(mutex_);
+        return size_;
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+private:
+    // Prefix length to the number of registrations of that length.
+    std::map<size_t, size_t> lengths_;
+    std::unordered_map<binary, Bucket> buckets_;
+    size_t size_;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace server
+} // namespace libbitcoin
+
+#endif
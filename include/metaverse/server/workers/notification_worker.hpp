@@ -29,6 +29,7 @@
 #include <metaverse/server/messages/route.hpp>
 #include <metaverse/server/settings.hpp>
 #include <metaverse/server/utility/address_key.hpp>
+#include <metaverse/server/utility/prefix_index.hpp>
 
 namespace libbitcoin {
 namespace server {
@@ -84,6 +85,7 @@ private:
         const hash_digest&, const chain::transaction&> address_subscriber;
     typedef notifier<address_key, const code&, uint32_t,
         const hash_digest&, const hash_digest&> penetration_subscriber;
+    typedef prefix_index<address_key> subscription_index;
 
     // Remove expired subscriptions.
     void purge();
@@ -115,6 +117,10 @@ private:
     void notify_penetration(uint32_t height, const hash_digest& block_hash,
         const hash_digest& tx_hash);
 
+    // The subscriptions of the index whose filter is a prefix of field.
+    static std::vector<address_key> to_keys(const subscription_index& index,
+        const binary& field);
+
     // Send a notification to the subscriber.
     void send(const route& reply_to, const std::string& command,
         uint32_t id, const data_chunk& payload);
@@ -150,6 +156,12 @@ private:
     payment_subscriber::ptr payment_subscriber_;
     stealth_subscriber::ptr stealth_subscriber_;
     penetration_subscriber::ptr penetration_subscriber_;
+
+    // Subscriptions by prefix filter, so that notifications are only relayed
+    // to the subscribers matching a transaction.
+    subscription_index payment_index_;
+    subscription_index stealth_index_;
+    subscription_index address_index_;
 };
 
 } // namespace server
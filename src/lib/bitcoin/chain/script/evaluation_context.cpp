@@ -20,14 +20,24 @@
  */
 #include "evaluation_context.hpp"
 
+#include <utility>
 #include <metaverse/bitcoin/utility/data.hpp>
 
 namespace libbitcoin {
 namespace chain {
 
-data_chunk evaluation_context::pop_stack()
+// Typical scripts never outgrow this, so the stack is sized once.
+static BC_CONSTEXPR size_t initial_stack_capacity = 16;
+
+evaluation_context::evaluation_context()
+  : operation_counter(0), flags(0)
+{
+    stack.reserve(initial_stack_capacity);
+}
+
+stack_item evaluation_context::pop_stack()
 {
-    const auto value = stack.back();
+    auto value = std::move(stack.back());
     stack.pop_back();
     return value;
 }
@@ -27,6 +27,7 @@
 #include <metaverse/bitcoin/define.hpp>
 #include <metaverse/bitcoin/utility/data.hpp>
 #include "conditional_stack.hpp"
+#include "stack_item.hpp"
 
 namespace libbitcoin {
 namespace chain {
@@ -34,12 +35,14 @@ namespace chain {
 class evaluation_context
 {
 public:
-    data_chunk pop_stack();
+    evaluation_context();
+
+    stack_item pop_stack();
 
     operation::stack::const_iterator code_begin;
     uint64_t operation_counter;
-    data_stack stack;
-    data_stack alternate;
+    item_stack stack;
+    item_stack alternate;
     conditional_stack conditional;
     uint32_t flags;
 };
@@ -32,6 +32,7 @@
 #include <metaverse/bitcoin/math/elliptic_curve.hpp>
 #include <metaverse/bitcoin/math/hash.hpp>
 #include <metaverse/bitcoin/math/script_number.hpp>
+#include <metaverse/bitcoin/math/signature_cache.hpp>
 #include <metaverse/bitcoin/utility/container_sink.hpp>
 #include <metaverse/bitcoin/utility/container_source.hpp>
 #include <metaverse/bitcoin/utility/istream_reader.hpp>
@@ -40,6 +41,7 @@
 #include <metaverse/bitcoin/utility/variable_uint_size.hpp>
 #include "conditional_stack.hpp"
 #include "evaluation_context.hpp"
+#include "sighash_writer.hpp"
 
 namespace libbitcoin {
 namespace chain {
@@ -381,14 +383,6 @@ inline hash_digest one_hash()
     };
 }
 
-inline void nullify_input_sequences(input::list& inputs,
-    uint32_t except_input)
-{
-    for (size_t index = 0; index < inputs.size(); ++index)
-        if (index != except_input)
-            inputs[index].sequence = 0;
-}
-
 inline uint8_t is_sighash_enum(uint8_t sighash_type,
     signature_hash_algorithm value)
 {
@@ -404,69 +398,92 @@ inline uint8_t is_sighash_flag(uint8_t sighash_type,
 hash_digest script::generate_signature_hash(const transaction& parent_tx,
     uint32_t input_index, const script& script_code, uint8_t sighash_type)
 {
-    // Copy the parent transaction.
-    transaction parent(parent_tx);
+    // The modified transaction is streamed into the hash from the parent,
+    // rather than copied and mutated, so nothing is allocated here.
+    const auto& inputs = parent_tx.inputs;
+    const auto& outputs = parent_tx.outputs;
 
     // This is NOT considered an error result and callers should not test
     // for one_hash. This is a bitcoind bug we perpetuate.
-    if (input_index >= parent_tx.inputs.size())
+    if (input_index >= inputs.size())
         return one_hash();
 
-    // FindAndDelete(OP_CODESEPARATOR) done in op_checksigverify(...)
+    const auto none = is_sighash_enum(sighash_type,
+        signature_hash_algorithm::none);
+    const auto single = is_sighash_enum(sighash_type,
+        signature_hash_algorithm::single);
+    const auto anyone = is_sighash_flag(sighash_type,
+        signature_hash_algorithm::anyone_can_pay);
 
-    // Blank all other inputs' signatures
-    for (auto& input: parent.inputs)
-        input.script.reset();
+    // This is NOT considered an error result and callers should not test
+    // for one_hash. This is a bitcoind bug we perpetuate.
+    if (single && input_index >= outputs.size())
+        return one_hash();
 
-    parent.inputs[input_index].script = script_code;
+    sighash_writer sink;
+    sink.write_4_bytes_little_endian(parent_tx.version);
 
-    // The default sighash::all signs all outputs, and the current input.
-    // Transaction cannot be updated without resigning the input.
-    // (note the lack of nullify_input_sequences() call)
+    // Flag to ignore the other inputs except our own.
+    const size_t first = anyone ? input_index : 0;
+    const size_t last = anyone ? input_index + 1 : inputs.size();
+    sink.write_variable_uint_little_endian(last - first);
+
+    for (auto index = first; index < last; ++index)
+    {
+        const auto& input = inputs[index];
+        const auto own = (index == input_index);
+        input.previous_output.to_data(sink);
+
+        // FindAndDelete(OP_CODESEPARATOR) done in op_checksigverify(...)
+        // Blank all other inputs' signatures.
+        if (own)
+            script_code.to_data(sink, true);
+        else
+            sink.write_variable_uint_little_endian(0);
+
+        // The default sighash::all signs all outputs, and the current input.
+        // Other sequences are nullified for none and single so they can be
+        // updated without resigning the input.
+        const auto nullify = !own && (none || single);
+        sink.write_4_bytes_little_endian(nullify ? 0 : input.sequence);
+    }
 
-    if (is_sighash_enum(sighash_type, signature_hash_algorithm::none))
+    if (none)
     {
         // Sign no outputs, so they can be changed.
-        parent.outputs.clear();
-        nullify_input_sequences(parent.inputs, input_index);
+        sink.write_variable_uint_little_endian(0);
     }
-    else if (is_sighash_enum(sighash_type, signature_hash_algorithm::single))
+    else if (single)
     {
-
         // Sign the single output corresponding to our index.
         // We don't care about additional inputs or outputs to the tx.
-        auto& outputs = parent.outputs;
-        uint32_t output_index = input_index;
-
-        // This is NOT considered an error result and callers should not test
-        // for one_hash. This is a bitcoind bug we perpetuate.
-        if (output_index >= outputs.size())
-            return one_hash();
-
-        outputs.resize(output_index + 1);
+        sink.write_variable_uint_little_endian(input_index + 1);
 
-        // Loop through outputs except the last one.
-        for (auto it = outputs.begin(); it != outputs.end() - 1; ++it)
+        // Outputs before our index are signed as blank values and scripts.
+        for (uint32_t index = 0; index < input_index; ++index)
         {
-            it->value = std::numeric_limits<uint64_t>::max();
-            it->script.reset();
+            sink.write_8_bytes_little_endian(max_uint64);
+            sink.write_variable_uint_little_endian(0);
+            outputs[index].attach_data.to_data(sink);
         }
 
-        nullify_input_sequences(parent.inputs, input_index);
+        outputs[input_index].to_data(sink);
     }
-
-    // Flag to ignore the other inputs except our own.
-    if (is_sighash_flag(sighash_type,
-        signature_hash_algorithm::anyone_can_pay))
+    else
     {
-        parent.inputs[0] = parent.inputs[input_index];
-        parent.inputs.resize(1);
+        sink.write_variable_uint_little_endian(outputs.size());
+
+        for (const auto& output: outputs)
+            output.to_data(sink);
     }
 
-    return parent.hash(sighash_type);
+    sink.write_4_bytes_little_endian(parent_tx.locktime);
+    sink.write_4_bytes_little_endian(sighash_type);
+    return sink.bitcoin_hash();
 }
 
-inline bool cast_to_bool(const data_chunk& values)
+template <typename Data>
+bool cast_to_bool(const Data& values)
 {
     for (auto it = values.begin(); it != values.end(); ++it)
     {
@@ -490,9 +507,9 @@ void stack_swap(DataStack& stack, size_t index_a, size_t index_b)
 }
 
 template <typename DataStack>
-data_chunk pop_item(DataStack& stack)
+typename DataStack::value_type pop_item(DataStack& stack)
 {
-    const auto value = stack.back();
+    auto value = std::move(stack.back());
     stack.pop_back();
     return value;
 }
@@ -1156,7 +1173,7 @@ bool op_ripemd160(evaluation_context& context)
         return false;
 
     const auto hash = ripemd160_hash(context.pop_stack());
-    context.stack.push_back(to_chunk(hash));
+    context.stack.push_back(hash);
     return true;
 }
 
@@ -1166,7 +1183,7 @@ bool op_sha1(evaluation_context& context)
         return false;
 
     const auto hash = sha1_hash(context.pop_stack());
-    context.stack.push_back(to_chunk(hash));
+    context.stack.push_back(hash);
     return true;
 }
 
@@ -1176,7 +1193,7 @@ bool op_sha256(evaluation_context& context)
         return false;
 
     const auto hash = sha256_hash(context.pop_stack());
-    context.stack.push_back(to_chunk(hash));
+    context.stack.push_back(hash);
     return true;
 }
 
@@ -1186,7 +1203,7 @@ bool op_hash160(evaluation_context& context)
         return false;
 
     const auto hash = bitcoin_short_hash(context.pop_stack());
-    context.stack.push_back(to_chunk(hash));
+    context.stack.push_back(hash);
     return true;
 }
 
@@ -1196,7 +1213,7 @@ bool op_hash256(evaluation_context& context)
         return false;
 
     const auto hash = bitcoin_hash(context.pop_stack());
-    context.stack.push_back(to_chunk(hash));
+    context.stack.push_back(hash);
     return true;
 }
 
@@ -1219,7 +1236,7 @@ bool script::create_endorsement(endorsement& out, const ec_secret& secret,
 }
 
 bool script::check_signature(const ec_signature& signature,
-    uint8_t sighash_type, const data_chunk& public_key,
+    uint8_t sighash_type, data_slice public_key,
     const script& script_code, const transaction& parent_tx,
     uint32_t input_index)
 {
@@ -1230,8 +1247,17 @@ bool script::check_signature(const ec_signature& signature,
     const auto sighash = script::generate_signature_hash(parent_tx, input_index,
         script_code, sighash_type);
 
+    // Signatures seen valid in the pool are not verified again in a block.
+    auto& cache = signature_cache::instance();
+    if (cache.contains(sighash, public_key, signature))
+        return true;
+
     // Validate the EC signature.
-    return verify_signature(public_key, sighash, signature);
+    if (!verify_signature(public_key, sighash, signature))
+        return false;
+
+    cache.store(sighash, public_key, signature);
+    return true;
 }
 
 signature_parse_result op_checksigverify(evaluation_context& context,
@@ -1249,16 +1275,17 @@ signature_parse_result op_checksigverify(evaluation_context& context,
 
     ec_signature signature;
 
-    if (strict && !parse_signature(signature, distinguished, true))
+    if (strict && !parse_signature(signature, distinguished.to_chunk(), true))
         return signature_parse_result::lax_encoding;
 
     chain::script script_code;
 
     for (auto it = context.code_begin; it != script.operations.end(); ++it)
-        if (it->data != endorsement && it->code != opcode::codeseparator)
+        if (endorsement != it->data && it->code != opcode::codeseparator)
             script_code.operations.push_back(*it);
 
-    if (!strict && !parse_signature(signature, distinguished, false))
+    if (!strict && !parse_signature(signature, distinguished.to_chunk(),
+        false))
         return signature_parse_result::invalid;
 
     return script::check_signature(signature, sighash_type, pubkey,
@@ -1285,7 +1312,7 @@ bool op_checksig(evaluation_context& context, const script& script,
     return true;
 }
 
-bool read_section(evaluation_context& context, data_stack& section,
+bool read_section(evaluation_context& context, item_stack& section,
     size_t count)
 {
     if (context.stack.size() < count)
@@ -1314,7 +1341,7 @@ signature_parse_result op_checkmultisigverify(evaluation_context& context,
     if (context.operation_counter > op_counter_limit)
         return signature_parse_result::invalid;
 
-    data_stack pubkeys;
+    item_stack pubkeys;
 
     if (!read_section(context, pubkeys, pubkeys_count))
         return signature_parse_result::invalid;
@@ -1327,7 +1354,7 @@ signature_parse_result op_checkmultisigverify(evaluation_context& context,
     if (sigs_count < 0 || sigs_count > pubkeys_count)
         return signature_parse_result::invalid;
 
-    data_stack endorsements;
+    item_stack endorsements;
 
     if (!read_section(context, endorsements, sigs_count))
         return signature_parse_result::invalid;
@@ -1363,7 +1390,7 @@ signature_parse_result op_checkmultisigverify(evaluation_context& context,
 
         ec_signature signature;
 
-        if (!parse_signature(signature, distinguished, strict))
+        if (!parse_signature(signature, distinguished.to_chunk(), strict))
             return strict ?
                 signature_parse_result::lax_encoding :
                 signature_parse_result::invalid;
@@ -1487,7 +1514,7 @@ bool op_checkattenuationverify(evaluation_context& context, const script& script
         return false;
 
     auto model_param = context.pop_stack();
-    if (!attenuation_model::check_model_param_format(model_param))
+    if (!attenuation_model::check_model_param_format(model_param.to_chunk()))
         return false;
 
     return true;
@@ -1883,7 +1910,7 @@ bool next_step(const transaction& parent_tx, uint32_t input_index,
     // push data to the stack
     if (op.code == opcode::zero)
     {
-        context.stack.push_back(data_chunk());
+        context.stack.emplace_back();
     }
     else if (op.code == opcode::codeseparator)
     {
@@ -1962,7 +1989,7 @@ bool script::verify(const script& input_script, const script& output_script,
         // Invalid script - parsable only as raw_data
         script eval_script;
 
-        if (!eval_script.from_data(input_context.stack.back(), false,
+        if (!eval_script.from_data(input_context.stack.back().to_chunk(), false,
             parse_mode::raw_data_fallback))
             return false;
 
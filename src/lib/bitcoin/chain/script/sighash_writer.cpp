@@ -0,0 +1,176 @@
+/**
+ * Copyright (c) 2011-2021 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2021 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "sighash_writer.hpp"
+
+#include <algorithm>
+#include <metaverse/bitcoin/utility/endian.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+sighash_writer::sighash_writer()
+{
+    SHA256Init(&context_);
+}
+
+sighash_writer::operator bool() const
+{
+    return true;
+}
+
+bool sighash_writer::operator!() const
+{
+    return false;
+}
+
+void sighash_writer::write_byte(uint8_t value)
+{
+    SHA256Update(&context_, &value, 1);
+}
+
+void sighash_writer::write_data(const data_chunk& data)
+{
+    write_data(data.data(), data.size());
+}
+
+void sighash_writer::write_data(const uint8_t* data, size_t size)
+{
+    SHA256Update(&context_, data, size);
+}
+
+void sighash_writer::write_hash(const hash_digest& value)
+{
+    write_array(value);
+}
+
+void sighash_writer::write_short_hash(const short_hash& value)
+{
+    write_array(value);
+}
+
+void sighash_writer::write_mini_hash(const mini_hash& value)
+{
+    write_array(value);
+}
+
+void sighash_writer::write_2_bytes_little_endian(uint16_t value)
+{
+    write_array(to_little_endian(value));
+}
+
+void sighash_writer::write_4_bytes_little_endian(uint32_t value)
+{
+    write_array(to_little_endian(value));
+}
+
+void sighash_writer::write_8_bytes_little_endian(uint64_t value)
+{
+    write_array(to_little_endian(value));
+}
+
+void sighash_writer::write_variable_uint_little_endian(uint64_t value)
+{
+    if (value < 0xfd)
+    {
+        write_byte((uint8_t)value);
+    }
+    else if (value <= 0xffff)
+    {
+        write_byte(0xfd);
+        write_2_bytes_little_endian((uint16_t)value);
+    }
+    else if (value <= 0xffffffff)
+    {
+        write_byte(0xfe);
+        write_4_bytes_little_endian((uint32_t)value);
+    }
+    else
+    {
+        write_byte(0xff);
+        write_8_bytes_little_endian(value);
+    }
+}
+
+void sighash_writer::write_2_bytes_big_endian(uint16_t value)
+{
+    write_array(to_big_endian(value));
+}
+
+void sighash_writer::write_4_bytes_big_endian(uint32_t value)
+{
+    write_array(to_big_endian(value));
+}
+
+void sighash_writer::write_8_bytes_big_endian(uint64_t value)
+{
+    write_array(to_big_endian(value));
+}
+
+void sighash_writer::write_variable_uint_big_endian(uint64_t value)
+{
+    if (value < 0xfd)
+    {
+        write_byte((uint8_t)value);
+    }
+    else if (value <= 0xffff)
+    {
+        write_byte(0xfd);
+        write_2_bytes_big_endian((uint16_t)value);
+    }
+    else if (value <= 0xffffffff)
+    {
+        write_byte(0xfe);
+        write_4_bytes_big_endian((uint32_t)value);
+    }
+    else
+    {
+        write_byte(0xff);
+        write_8_bytes_big_endian(value);
+    }
+}
+
+void sighash_writer::write_fixed_string(const std::string& value, size_t size)
+{
+    const auto min_size = std::min(size, value.size());
+    write_data(reinterpret_cast<const uint8_t*>(value.data()), min_size);
+
+    for (auto pad = min_size; pad < size; ++pad)
+        write_byte(0);
+}
+
+void sighash_writer::write_string(const std::string& value)
+{
+    write_variable_uint_little_endian(value.size());
+    write_data(reinterpret_cast<const uint8_t*>(value.data()), value.size());
+}
+
+hash_digest sighash_writer::bitcoin_hash()
+{
+    hash_digest first;
+    SHA256Final(&context_, first.data());
+
+    hash_digest second;
+    SHA256_(first.data(), first.size(), second.data());
+    return second;
+}
+
+} // namespace chain
+} // namespace libbitcoin
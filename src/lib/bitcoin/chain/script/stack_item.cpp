@@ -0,0 +1,133 @@
+/**
+ * Copyright (c) 2011-2021 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2021 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "stack_item.hpp"
+
+#include <algorithm>
+#include <metaverse/bitcoin/utility/assert.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+stack_item::stack_item()
+  : size_(0)
+{
+}
+
+stack_item::stack_item(const data_chunk& data)
+  : stack_item(data.data(), data.data() + data.size())
+{
+}
+
+stack_item::stack_item(const uint8_t* begin, const uint8_t* end)
+  : size_(static_cast<uint32_t>(end - begin))
+{
+    if (is_inline())
+        std::copy(begin, end, inline_.begin());
+    else
+        overflow_.assign(begin, end);
+}
+
+bool stack_item::operator==(const stack_item& other) const
+{
+    return size_ == other.size_ &&
+        std::equal(begin(), end(), other.begin());
+}
+
+bool stack_item::operator!=(const stack_item& other) const
+{
+    return !(*this == other);
+}
+
+bool stack_item::operator==(const data_chunk& other) const
+{
+    return size_ == other.size() &&
+        std::equal(begin(), end(), other.begin());
+}
+
+bool stack_item::operator!=(const data_chunk& other) const
+{
+    return !(*this == other);
+}
+
+bool stack_item::is_inline() const
+{
+    return size_ <= inline_capacity;
+}
+
+const uint8_t* stack_item::data() const
+{
+    return is_inline() ? inline_.data() : overflow_.data();
+}
+
+size_t stack_item::size() const
+{
+    return size_;
+}
+
+bool stack_item::empty() const
+{
+    return size_ == 0;
+}
+
+stack_item::const_iterator stack_item::begin() const
+{
+    return data();
+}
+
+stack_item::const_iterator stack_item::end() const
+{
+    return data() + size_;
+}
+
+uint8_t stack_item::back() const
+{
+    BITCOIN_ASSERT(!empty());
+    return data()[size_ - 1];
+}
+
+void stack_item::pop_back()
+{
+    BITCOIN_ASSERT(!empty());
+
+    if (is_inline())
+    {
+        --size_;
+        return;
+    }
+
+    overflow_.pop_back();
+    --size_;
+
+    // Move back in place once the item fits again.
+    if (is_inline())
+    {
+        std::copy(overflow_.begin(), overflow_.end(), inline_.begin());
+        overflow_.clear();
+    }
+}
+
+data_chunk stack_item::to_chunk() const
+{
+    return data_chunk(begin(), end());
+}
+
+} // namespace chain
+} // namespace libbitcoin
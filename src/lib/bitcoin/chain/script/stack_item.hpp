@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2011-2021 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2021 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_CHAIN_STACK_ITEM_HPP
+#define MVS_CHAIN_STACK_ITEM_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <metaverse/bitcoin/compat.hpp>
+#include <metaverse/bitcoin/define.hpp>
+#include <metaverse/bitcoin/utility/data.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// A script evaluation stack item. Items up to inline_capacity bytes, which
+/// covers signatures, public keys, hashes and numbers, are held in place so
+/// that pushing, copying and popping them does not touch the heap.
+class stack_item
+{
+public:
+    typedef const uint8_t* const_iterator;
+
+    /// Fits a DER endorsement (73) and an uncompressed public key (65).
+    static BC_CONSTEXPR size_t inline_capacity = 80;
+
+    stack_item();
+    stack_item(const data_chunk& data);
+    stack_item(const uint8_t* begin, const uint8_t* end);
+
+    template <size_t Size>
+    stack_item(const byte_array<Size>& data)
+      : stack_item(data.data(), data.data() + Size)
+    {
+    }
+
+    bool operator==(const stack_item& other) const;
+    bool operator!=(const stack_item& other) const;
+    bool operator==(const data_chunk& other) const;
+    bool operator!=(const data_chunk& other) const;
+
+    const uint8_t* data() const;
+    size_t size() const;
+    bool empty() const;
+    const_iterator begin() const;
+    const_iterator end() const;
+    uint8_t back() const;
+    void pop_back();
+
+    data_chunk to_chunk() const;
+
+private:
+    bool is_inline() const;
+
+    uint32_t size_;
+    std::array<uint8_t, inline_capacity> inline_;
+    data_chunk overflow_;
+};
+
+typedef std::vector<stack_item> item_stack;
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
@@ -59,18 +59,18 @@ data_chunk script_number_serialize(const int64_t value)
     return result;
 }
 
-int64_t script_number_deserialize(const data_chunk& data)
+int64_t script_number_deserialize(data_slice data)
 {
     if (data.empty())
         return 0;
 
     int64_t result = 0;
     for (size_t i = 0; i != data.size(); ++i)
-        result |= static_cast<int64_t>(data[i]) << 8 * i;
+        result |= static_cast<int64_t>(data.data()[i]) << 8 * i;
 
     // If the input vector's most significant byte is 0x80, remove it from
     // the result's msb and return a negative.
-    if (data.back() & 0x80)
+    if (data.data()[data.size() - 1] & 0x80)
         return -(result & ~(0x80 << (8 * (data.size() - 1))));
 
     return result;
@@ -85,7 +85,7 @@ script_number::script_number()
     // You must call set_data() after.
 }
 
-bool script_number::set_data(const data_chunk& data, uint8_t max_size)
+bool script_number::set_data(data_slice data, uint8_t max_size)
 {
     if (data.size() > max_size)
         return false;
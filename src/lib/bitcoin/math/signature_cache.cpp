@@ -0,0 +1,126 @@
+/**
+ * Copyright (c) 2011-2021 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2021 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/bitcoin/math/signature_cache.hpp>
+
+#include <algorithm>
+#include <metaverse/bitcoin/utility/random.hpp>
+
+namespace libbitcoin {
+
+// About 10MB of keys and set overhead.
+static BC_CONSTEXPR size_t default_capacity = 1 << 17;
+static BC_CONSTEXPR size_t salt_size = 32;
+
+signature_cache& signature_cache::instance()
+{
+    static signature_cache cache(default_capacity);
+    return cache;
+}
+
+signature_cache::signature_cache(size_t capacity)
+  : shard_capacity_(std::max<size_t>(capacity / shard_count, 1)),
+    salt_(salt_size)
+{
+    // The salt keeps peers from predicting which entries share a shard.
+    pseudo_random_fill(salt_);
+
+    for (auto& shard: shards_)
+    {
+        shard.entries.reserve(shard_capacity_);
+        shard.ring.reserve(shard_capacity_);
+        shard.next = 0;
+    }
+}
+
+hash_digest signature_cache::to_key(const hash_digest& sighash,
+    data_slice public_key, data_slice signature) const
+{
+    return sha256_hash(build_chunk({ salt_, sighash, public_key,
+        signature }));
+}
+
+signature_cache::shard& signature_cache::shard_of(const hash_digest& key)
+{
+    return shards_[key.front() % shard_count];
+}
+
+const signature_cache::shard& signature_cache::shard_of(
+    const hash_digest& key) const
+{
+    return shards_[key.front() % shard_count];
+}
+
+bool signature_cache::contains(const hash_digest& sighash,
+    data_slice public_key, data_slice signature) const
+{
+    const auto key = to_key(sighash, public_key, signature);
+    const auto& shard = shard_of(key);
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(shard.mutex);
+    return shard.entries.find(key) != shard.entries.end();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void signature_cache::store(const hash_digest& sighash,
+    data_slice public_key, data_slice signature)
+{
+    const auto key = to_key(sighash, public_key, signature);
+    auto& shard = shard_of(key);
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(shard.mutex);
+
+    if (!shard.entries.insert(key).second)
+        return;
+
+    if (shard.ring.size() < shard_capacity_)
+    {
+        shard.ring.push_back(key);
+        return;
+    }
+
+    // The shard is full, overwrite its oldest entry.
+    shard.entries.erase(shard.ring[shard.next]);
+    shard.ring[shard.next] = key;
+    shard.next = (shard.next + 1) % shard_capacity_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t signature_cache::size() const
+{
+    size_t total = 0;
+
+    for (const auto& shard: shards_)
+    {
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section
+        shared_lock lock(shard.mutex);
+        total += shard.entries.size();
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    return total;
+}
+
+} // namespace libbitcoin
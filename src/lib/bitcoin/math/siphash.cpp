@@ -0,0 +1,108 @@
+/**
+ * Copyright (c) 2011-2021 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2021 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/bitcoin/math/siphash.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <metaverse/bitcoin/utility/endian.hpp>
+
+namespace libbitcoin {
+
+// SipHash-2-4, see https://131002.net/siphash/siphash.pdf
+//-----------------------------------------------------------------------------
+
+static BC_CONSTEXPR size_t block_size = sizeof(uint64_t);
+
+static inline uint64_t rotate_left(uint64_t value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static inline void sip_round(uint64_t& v0, uint64_t& v1, uint64_t& v2,
+    uint64_t& v3)
+{
+    v0 += v1;
+    v1 = rotate_left(v1, 13);
+    v1 ^= v0;
+    v0 = rotate_left(v0, 32);
+    v2 += v3;
+    v3 = rotate_left(v3, 16);
+    v3 ^= v2;
+    v0 += v3;
+    v3 = rotate_left(v3, 21);
+    v3 ^= v0;
+    v2 += v1;
+    v1 = rotate_left(v1, 17);
+    v1 ^= v2;
+    v2 = rotate_left(v2, 32);
+}
+
+static inline void compress(uint64_t& v0, uint64_t& v1, uint64_t& v2,
+    uint64_t& v3, uint64_t block)
+{
+    v3 ^= block;
+    sip_round(v0, v1, v2, v3);
+    sip_round(v0, v1, v2, v3);
+    v0 ^= block;
+}
+
+siphash_key to_siphash_key(const hash_digest& hash)
+{
+    const auto first = from_little_endian_unsafe<uint64_t>(hash.begin());
+    const auto second = from_little_endian_unsafe<uint64_t>(
+        hash.begin() + block_size);
+    return{ first, second };
+}
+
+uint64_t siphash(const siphash_key& key, data_slice message)
+{
+    uint64_t v0 = 0x736f6d6570736575ull ^ key.first;
+    uint64_t v1 = 0x646f72616e646f6dull ^ key.second;
+    uint64_t v2 = 0x6c7967656e657261ull ^ key.first;
+    uint64_t v3 = 0x7465646279746573ull ^ key.second;
+
+    const auto size = message.size();
+    const auto data = message.begin();
+    const auto blocks = size / block_size;
+
+    for (size_t block = 0; block < blocks; ++block)
+        compress(v0, v1, v2, v3, from_little_endian_unsafe<uint64_t>(
+            data + block * block_size));
+
+    // The last block carries the remaining bytes and the message length.
+    uint64_t last = static_cast<uint64_t>(size) << 56;
+    const auto tail = blocks * block_size;
+
+    for (size_t byte = 0; tail + byte < size; ++byte)
+        last |= static_cast<uint64_t>(data[tail + byte]) << (8 * byte);
+
+    compress(v0, v1, v2, v3, last);
+
+    v2 ^= 0xff;
+    sip_round(v0, v1, v2, v3);
+    sip_round(v0, v1, v2, v3);
+    sip_round(v0, v1, v2, v3);
+    sip_round(v0, v1, v2, v3);
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+} // namespace libbitcoin
+
@@ -20,11 +20,13 @@
  */
 #include <metaverse/bitcoin/message/compact_block.hpp>
 
+#include <algorithm>
 #include <initializer_list>
 #include <boost/iostreams/stream.hpp>
 #include <metaverse/bitcoin/message/version.hpp>
 #include <metaverse/bitcoin/utility/container_sink.hpp>
 #include <metaverse/bitcoin/utility/container_source.hpp>
+#include <metaverse/bitcoin/utility/endian.hpp>
 #include <metaverse/bitcoin/utility/istream_reader.hpp>
 #include <metaverse/bitcoin/utility/ostream_writer.hpp>
 
@@ -59,6 +61,58 @@ compact_block compact_block::factory_from_data(uint32_t version,
     return instance;
 }
 
+compact_block compact_block::factory_from_block(const chain::block& block,
+    uint64_t nonce)
+{
+    compact_block instance;
+    instance.header = block.header;
+    instance.nonce = nonce;
+
+    const auto key = instance.short_id_key();
+    const auto& transactions = block.transactions;
+    instance.short_ids.reserve(transactions.size());
+
+    // Prefilled indexes are differentially encoded, each relative to the
+    // index following the previous prefilled transaction.
+    uint64_t next = 0;
+
+    for (uint64_t index = 0; index < transactions.size(); ++index)
+    {
+        const auto& tx = transactions[index];
+
+        if (tx.is_coinbase() || tx.is_coinstake())
+        {
+            prefilled_transaction prefilled;
+            prefilled.index = index - next;
+            prefilled.transaction = tx;
+            instance.transactions.push_back(std::move(prefilled));
+            next = index + 1;
+            continue;
+        }
+
+        instance.short_ids.push_back(to_short_id(key, tx.hash()));
+    }
+
+    return instance;
+}
+
+compact_block::short_id compact_block::to_short_id(const siphash_key& key,
+    const hash_digest& hash)
+{
+    // The short id is the low six bytes of the siphash, little endian.
+    const auto value = to_little_endian(siphash(key, hash));
+    short_id out;
+    std::copy(value.begin(), value.begin() + out.size(), out.begin());
+    return out;
+}
+
+siphash_key compact_block::short_id_key() const
+{
+    auto data = header.to_data(false);
+    extend_data(data, to_little_endian(nonce));
+    return to_siphash_key(sha256_hash(data));
+}
+
 bool compact_block::is_valid() const
 {
     return header.is_valid() && !short_ids.empty() && !transactions.empty();
@@ -24,6 +24,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <thread>
 #include <algorithm>
 #include <algorithm>
 #include <utility>
@@ -59,12 +60,22 @@ using boost::filesystem::path;
 using string = std::string;
 
 
+// Zero configured threads selects the hardware concurrency.
+static size_t to_script_threads(const blockchain::settings& settings)
+{
+    const size_t threads = settings.script_verification_threads;
+    return threads != 0 ? threads :
+        std::max(std::thread::hardware_concurrency(), 1u);
+}
+
 block_chain_impl::block_chain_impl(threadpool& pool,
     const blockchain::settings& chain_settings,
     const database::settings& database_settings)
   : stopped_(true),
     sync_disabled_(false),
     settings_(chain_settings),
+    script_threads_(to_script_threads(chain_settings)),
+    script_pool_(script_threads_ - 1),
     organizer_(pool, *this, chain_settings),
     ////read_dispatch_(pool, NAME),
     ////write_dispatch_(pool, NAME),
@@ -107,6 +118,16 @@ const settings& block_chain_impl::chain_settings() const
     return settings_;
 }
 
+threadpool& block_chain_impl::script_pool()
+{
+    return script_pool_;
+}
+
+size_t block_chain_impl::script_threads() const
+{
+    return script_threads_;
+}
+
 // Startup and shutdown.
 // ----------------------------------------------------------------------------
 
@@ -560,10 +581,10 @@ void block_chain_impl::do_store(message::block_message::ptr block,
 
     const auto detail = std::make_shared<block_detail>(block);
 
-    // ...or if the block is already orphaned.
+    // ...or if the block is already orphaned or the orphan pool is full.
     if (!organizer_.add(detail))
     {
-        handler(error::duplicate, 0);
+        handler(detail->error() ? detail->error() : error::duplicate, 0);
         return;
     }
 
@@ -1750,6 +1771,32 @@ history::list block_chain_impl::get_address_history(const wallet::payment_addres
     return history::list();
 }
 
+database::address_utxo::list block_chain_impl::get_address_utxos(const wallet::payment_address& addr)
+{
+    if (stopped()) {
+        return {};
+    }
+
+    auto utxos = database_.address_utxos.get(addr.hash());
+
+    // the index is keyed by hash, drop outputs of other address versions.
+    const auto version = addr.version();
+    const auto mismatch = [version](const database::address_utxo& utxo) {
+        return utxo.version != version;
+    };
+    utxos.erase(std::remove_if(utxos.begin(), utxos.end(), mismatch), utxos.end());
+    return utxos;
+}
+
+uint64_t block_chain_impl::get_address_received(const wallet::payment_address& addr)
+{
+    if (stopped()) {
+        return 0;
+    }
+
+    return database_.address_utxos.received(addr.hash());
+}
+
 std::shared_ptr<asset_cert> block_chain_impl::get_account_asset_cert(
     const std::string& account, const std::string& symbol, asset_cert_type cert_type)
 {
@@ -1862,10 +1909,11 @@ std::shared_ptr<asset_mit_info> block_chain_impl::get_registered_mit(const std::
     return database_.mits.get(get_hash(symbol));
 }
 
-std::shared_ptr<asset_mit_info::list> block_chain_impl::get_registered_mits()
+std::shared_ptr<asset_mit_info::list> block_chain_impl::get_registered_mits(
+    const std::string& prefix, const std::string& after, uint64_t limit)
 {
     // return the registered identifiable assets, their status must be MIT_STATUS_REGISTER
-    return database_.mits.get_blockchain_mits();
+    return database_.mits.get_blockchain_mits_page(prefix, after, limit);
 }
 
 std::shared_ptr<asset_mit_info::list> block_chain_impl::get_mit_history(
@@ -1920,18 +1968,20 @@ uint64_t block_chain_impl::get_address_asset_volume(const std::string& addr, con
 {
     uint64_t asset_volume = 0;
     auto address = wallet::payment_address(addr);
-    auto&& rows = get_address_history(address);
+    auto&& utxos = get_address_utxos(address);
 
     chain::transaction tx_temp;
     uint64_t tx_height;
 
-    for (auto& row: rows)
+    for (auto& utxo: utxos)
     {
-        // spend unconfirmed (or no spend attempted)
-        if ((row.spend.hash == null_hash)
-            && get_transaction(tx_temp, tx_height, row.output.hash))
+        if (utxo.attachment_type != ASSET_TYPE) {
+            continue;
+        }
+
+        if (get_transaction(tx_temp, tx_height, utxo.output.hash))
         {
-            auto output = tx_temp.outputs.at(row.output.index);
+            auto output = tx_temp.outputs.at(utxo.output.index);
             if ((output.is_asset_transfer() || output.is_asset_issue() || output.is_asset_secondaryissue())) {
                 if (output.get_asset_symbol() == asset) {
                     asset_volume += output.get_asset_amount();
@@ -2103,7 +2153,7 @@ std::shared_ptr<business_history::list> block_chain_impl::get_address_business_h
 std::shared_ptr<business_history::list> block_chain_impl::get_address_business_history(const std::string& addr)
 {
     auto sp_asset_vec = std::make_shared<business_history::list>();
-    auto key = get_short_hash(addr);
+    auto key = database::to_address_key(addr);
     business_history::list asset_vec = database_.address_assets.get_business_history(key, 0);
     const auto add_asset = [&](const business_history& addr_asset)
     {
@@ -2119,7 +2169,7 @@ std::shared_ptr<business_record::list> block_chain_impl::get_address_business_re
     size_t from_height, size_t limit)
 {
     auto sp_asset_vec = std::make_shared<business_record::list>();
-    auto key = get_short_hash(addr);
+    auto key = database::to_address_key(addr);
     business_record::list asset_vec = database_.address_assets.get(key, from_height, limit);
     const auto add_asset = [&](const business_record& addr_asset)
     {
@@ -2130,6 +2180,74 @@ std::shared_ptr<business_record::list> block_chain_impl::get_address_business_re
     return sp_asset_vec;
 }
 
+std::vector<block_chain_impl::tx_position>
+block_chain_impl::get_addresses_transactions(
+    const std::vector<std::string>& addresses, uint64_t start_height,
+    uint64_t end_height, const tx_position& cursor, uint64_t limit,
+    const history_filter& filter) const
+{
+    const auto precedes = [](const tx_position& left, const tx_position& right)
+    {
+        return left.first > right.first ||
+            (left.first == right.first && right.second < left.second);
+    };
+
+    std::vector<tx_position> result;
+    const auto begin = (cursor.second == null_hash);
+
+    if (limit == 0 || (end_height != 0 && end_height <= start_height) ||
+        (!begin && cursor.first < start_height))
+        return result;
+
+    const auto top = begin ? (end_height == 0 ? max_uint64 : end_height - 1) :
+        cursor.first;
+
+    // Each address contributes its first limit transactions after the cursor,
+    // so the first limit of their union are the page.
+    for (const auto& address: addresses)
+    {
+        const wallet::payment_address payment(address);
+        if (!payment)
+            continue;
+
+        std::vector<tx_position> found;
+        auto to_height = top;
+
+        while (found.size() < limit)
+        {
+            // Pages above to_height are skipped, rows end on a whole height.
+            const auto rows = database_.history.get(payment.hash(), limit,
+                start_height, to_height);
+
+            for (const auto& row: rows)
+            {
+                const tx_position position{ row.height, row.point.hash };
+                if ((begin || precedes(cursor, position)) &&
+                    (!filter || filter(row)))
+                    found.push_back(position);
+            }
+
+            std::sort(found.begin(), found.end(), precedes);
+            found.erase(std::unique(found.begin(), found.end()), found.end());
+
+            if (rows.size() < limit || rows.back().height <= start_height)
+                break;
+
+            to_height = rows.back().height - 1;
+        }
+
+        result.insert(result.end(), found.begin(), found.end());
+    }
+
+    std::sort(result.begin(), result.end(), precedes);
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+
+    if (result.size() > limit)
+        result.resize(limit);
+
+    return result;
+}
+
 // get all assets belongs to the account/name
 std::shared_ptr<business_address_asset::list> block_chain_impl::get_account_assets(
     const std::string& name)
@@ -2249,6 +2367,23 @@ std::shared_ptr<asset_detail::list> block_chain_impl::get_issued_assets(
     return sp_vec;
 }
 
+std::shared_ptr<asset_detail::list> block_chain_impl::get_issued_assets_page(
+    const std::string& prefix, const std::string& after, uint64_t limit)
+{
+    // swallow forbidden symbols before paging, so pages stay full
+    const auto forbidden = [](const std::string& symbol) {
+        return bc::wallet::symbol::is_forbidden(symbol);
+    };
+
+    auto sp_vec = std::make_shared<asset_detail::list>();
+    auto sp_blockchain_vec = database_.assets.get_blockchain_assets_page(
+        prefix, after, limit, forbidden);
+    for (auto& each : *sp_blockchain_vec) {
+        sp_vec->push_back(each.get_asset());
+    }
+    return sp_vec;
+}
+
 std::shared_ptr<blockchain_asset::list> block_chain_impl::get_asset_register_output(const std::string& symbol)
 {
     return database_.assets.get_asset_history(symbol);
@@ -2362,13 +2497,18 @@ std::shared_ptr<did_detail> block_chain_impl::get_registered_did(const std::stri
 }
 
 /// get all the did in blockchain
-std::shared_ptr<did_detail::list> block_chain_impl::get_registered_dids()
+std::shared_ptr<did_detail::list> block_chain_impl::get_registered_dids(
+    const std::string& prefix, const std::string& after, uint64_t limit,
+    uint64_t skip)
 {
     auto sp_vec = std::make_shared<did_detail::list>();
     if (!sp_vec)
         return nullptr;
 
-    auto sp_blockchain_vec = database_.dids.get_blockchain_dids();
+    // Each symbol has one current record, so a page of symbols is a page
+    // of dids.
+    auto sp_blockchain_vec = database_.dids.get_blockchain_dids_page(prefix,
+        after, limit, skip);
     for (const auto& each : *sp_blockchain_vec){
         if (each.get_status() == blockchain_did::address_current){
             sp_vec->emplace_back(each.get_did());
@@ -2378,6 +2518,12 @@ std::shared_ptr<did_detail::list> block_chain_impl::get_registered_dids()
     return sp_vec;
 }
 
+uint64_t block_chain_impl::get_registered_dids_count(const std::string& prefix,
+    const std::string& after)
+{
+    return database_.dids.get_blockchain_dids_count(prefix, after);
+}
+
 std::shared_ptr<asset_detail> block_chain_impl::get_issued_asset(const std::string& symbol)
 {
     std::shared_ptr<asset_detail> sp_asset(nullptr);
@@ -3404,6 +3550,52 @@ bool block_chain_impl::is_utxo_spendable(const chain::transaction& tx, uint32_t
     return true;
 }
 
+// same rules as above, using the lock recorded in the address utxo index.
+bool block_chain_impl::is_utxo_spendable(const database::address_utxo& utxo, uint64_t latest_height, uint64_t confirmations) const
+{
+    const uint64_t tx_height = utxo.height;
+    if (confirmations > 0 && 0 == tx_height) {
+        return false;
+    }
+    if (confirmations > calc_number_of_blocks(tx_height, latest_height)){
+        return false;
+    }
+
+    switch (utxo.lock_kind) {
+        case database::utxo_lock_kind::lock_height:
+            // deposit utxo in block
+            return utxo.lock_value <= calc_number_of_blocks(tx_height, latest_height);
+
+        case database::utxo_lock_kind::sequence_lock: {
+            // lock sequence check
+            if (is_relative_locktime_time_locked(utxo.lock_value)) {
+                auto locked_seconds = get_relative_locktime_locked_seconds(utxo.lock_value);
+                auto prev_timestamp = get_block_timestamp(tx_height);
+                auto curr_timestamp = get_block_timestamp(latest_height);
+                return prev_timestamp + locked_seconds <= curr_timestamp;
+            }
+
+            // use any kind of blocks
+            auto locked_heights = get_relative_locktime_locked_heights(utxo.lock_value);
+            return tx_height + locked_heights <= latest_height;
+        }
+
+        case database::utxo_lock_kind::coinbase:
+            // coin base maturity check
+            return coinbase_maturity <= calc_number_of_blocks(tx_height, latest_height);
+
+        case database::utxo_lock_kind::locktime: {
+            // lock time check, as transaction::is_final at the next height
+            const uint64_t max_locktime = utxo.lock_value < locktime_threshold ?
+                latest_height + 1 : get_median_time_past(latest_height);
+            return utxo.lock_value < max_locktime;
+        }
+
+        default:
+            return true;
+    }
+}
+
 bool block_chain_impl::is_valid_symbol(const std::string& symbol, uint32_t tx_version)
 {
     if (symbol.empty() || symbol.length() > ASSET_DETAIL_SYMBOL_FIX_SIZE)
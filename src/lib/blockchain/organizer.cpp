@@ -190,7 +190,14 @@ void organizer::organize()
 
 bool organizer::add(block_detail::ptr block)
 {
-    return orphan_pool_.add(block);
+    block_detail::list evicted;
+    const auto added = orphan_pool_.add(block, evicted);
+
+    // Evicted orphans must not be processed from a stale queue.
+    for (const auto& orphan: evicted)
+        remove_processed(orphan);
+
+    return added;
 }
 
 void organizer::filter_orphans(message::get_data::ptr message)
@@ -22,19 +22,48 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <metaverse/blockchain/block.hpp>
 #include <metaverse/blockchain/block_detail.hpp>
 
 namespace libbitcoin {
 namespace blockchain {
 
 orphan_pool::orphan_pool(size_t capacity)
+  : sequence_(0), bytes_(0), capacity_(capacity)
 {
-    buffer_.reserve(capacity == 0 ? 1 : capacity);
+    entries_.reserve(capacity);
+}
+
+size_t orphan_pool::size() const
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(mutex_);
+
+    return entries_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+uint64_t orphan_pool::bytes() const
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(mutex_);
+
+    return bytes_;
+    ///////////////////////////////////////////////////////////////////////////
 }
 
-// There is no validation whatsoever of the block up to this pont.
 bool orphan_pool::add(block_detail::ptr block)
 {
+    block_detail::list evicted;
+    return add(block, evicted);
+}
+
+// There is no validation whatsoever of the block up to this pont.
+bool orphan_pool::add(block_detail::ptr block, block_detail::list& evicted)
+{
+    const auto hash = block->hash();
     const auto& header = block->actual()->header;
 
     ///////////////////////////////////////////////////////////////////////////
@@ -42,56 +71,78 @@ bool orphan_pool::add(block_detail::ptr block)
     mutex_.lock_upgrade();
 
     // No duplicates allowed.
-    if (exists(header))
+    if (exists(hash))
     {
         mutex_.unlock_upgrade();
         //-----------------------------------------------------------------
         return false;
     }
 
-    const auto old_size = buffer_.size();
+    const auto old_size = entries_.size();
     //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
     mutex_.unlock_upgrade_and_lock();
-    buffer_.push_back(block);
+
+    if (capacity_ != 0 && entries_.size() >= capacity_)
+    {
+        // Never split the chain the incoming block extends.
+        const auto dropped = evict(header.previous_block_hash);
+
+        if (!dropped)
+        {
+            mutex_.unlock();
+            //-----------------------------------------------------------------
+            block->set_error(error::pool_filled);
+            log::debug(LOG_BLOCKCHAIN)
+                << "Orphan pool refused block [" << encode_hash(hash)
+                << "] size (" << old_size << ").";
+            return false;
+        }
+
+        evicted.push_back(dropped);
+    }
+
+    insert(block);
+    const auto bytes = bytes_;
     mutex_.unlock();
     ///////////////////////////////////////////////////////////////////////////
 
     log::debug(LOG_BLOCKCHAIN)
-        << "Orphan pool added block [" << encode_hash(block->hash())
+        << "Orphan pool added block [" << encode_hash(hash)
         << "] previous [" << encode_hash(header.previous_block_hash)
-        << "] old size (" << old_size << ").";
+        << "] old size (" << old_size << ") bytes (" << bytes << ").";
 
     return true;
 }
 
 void orphan_pool::remove(block_detail::ptr block)
 {
+    const auto hash = block->hash();
+
     ///////////////////////////////////////////////////////////////////////////
     // Critical Section
     mutex_.lock_upgrade();
 
-    const auto it = std::find(buffer_.begin(), buffer_.end(), block);
+    const auto it = entries_.find(hash);
 
-    if (it == buffer_.end())
+    if (it == entries_.end() || it->second.block != block)
     {
         mutex_.unlock_upgrade();
         //-----------------------------------------------------------------
         return;
     }
 
-    const auto old_size = buffer_.size();
+    const auto old_size = entries_.size();
     //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
     mutex_.unlock_upgrade_and_lock();
-    buffer_.erase(it);
+    erase(it);
     mutex_.unlock();
     ///////////////////////////////////////////////////////////////////////////
 
     log::debug(LOG_BLOCKCHAIN)
-        << "Orphan pool removed block [" << encode_hash(block->hash())
+        << "Orphan pool removed block [" << encode_hash(hash)
         << "] old size (" << old_size << "). with status: " << block->error().message();
 }
 
-// TODO: use hash table pool to eliminate this O(n^2) search.
 void orphan_pool::filter(message::get_data::ptr message) const
 {
     auto& inventories = message->inventories;
@@ -111,7 +162,6 @@ void orphan_pool::filter(message::get_data::ptr message) const
 block_detail::list orphan_pool::trace(block_detail::ptr end) const
 {
     block_detail::list trace;
-    trace.reserve(buffer_.size());
     trace.push_back(end);
     auto hash = end->actual()->header.previous_block_hash;
 
@@ -119,10 +169,11 @@ block_detail::list orphan_pool::trace(block_detail::ptr end) const
     // Critical Section
     mutex_.lock_shared();
 
-    for (auto it = rfind(buffer_.rbegin(), hash); it != buffer_.rend(); it = rfind(it, hash))
+    for (auto it = entries_.find(hash); it != entries_.end();
+        it = entries_.find(hash))
     {
-        trace.push_back(*it);
-        hash = (*it)->actual()->header.previous_block_hash;
+        trace.push_back(it->second.block);
+        hash = it->second.block->actual()->header.previous_block_hash;
     }
 
     mutex_.unlock_shared();
@@ -130,23 +181,26 @@ block_detail::list orphan_pool::trace(block_detail::ptr end) const
 
     BITCOIN_ASSERT(!trace.empty());
     std::reverse(trace.begin(), trace.end());
-    trace.shrink_to_fit();
     return trace;
 }
 
 block_detail::list orphan_pool::unprocessed() const
 {
     block_detail::list unprocessed;
-    unprocessed.reserve(buffer_.size());
 
     ///////////////////////////////////////////////////////////////////////////
     // Critical Section
     mutex_.lock_shared();
 
+    unprocessed.reserve(entries_.size());
+
     // Earlier blocks enter pool first, so reversal helps avoid fragmentation.
-    for (auto it = buffer_.rbegin(); it != buffer_.rend(); ++it)
-        if (!(*it)->processed())
-            unprocessed.push_back(*it);
+    for (auto it = ages_.rbegin(); it != ages_.rend(); ++it)
+    {
+        const auto& block = entries_.at(it->second).block;
+        if (!block->processed())
+            unprocessed.push_back(block);
+    }
 
     mutex_.unlock_shared();
     ///////////////////////////////////////////////////////////////////////////
@@ -187,44 +241,110 @@ block_detail::ptr orphan_pool::delete_pending_block(const hash_digest& needed_bl
 
 bool orphan_pool::exists(const hash_digest& hash) const
 {
-    const auto match = [&hash](const block_detail::ptr& entry)
-    {
-        return hash == entry->hash();
-    };
+    return entries_.count(hash) != 0;
+}
 
-    return std::any_of(buffer_.begin(), buffer_.end(), match);
+bool orphan_pool::has_children(const hash_digest& hash) const
+{
+    return children_.count(hash) != 0;
 }
 
-bool orphan_pool::exists(const chain::header& header) const
+orphan_pool::leaf_key orphan_pool::to_leaf_key(const hash_digest& hash,
+    const entry& entry)
 {
-    const auto match = [&header](const block_detail::ptr& entry)
-    {
-        return header == entry->actual()->header;
-    };
+    return std::make_tuple(entry.work, entry.sequence, hash);
+}
 
-    return std::any_of(buffer_.begin(), buffer_.end(), match);
+void orphan_pool::insert(block_detail::ptr block)
+{
+    const auto hash = block->hash();
+    const auto& previous = block->actual()->header.previous_block_hash;
+    const auto size = static_cast<const chain::block&>(*block->actual())
+        .serialized_size();
+    const entry item{ block, sequence_++, size,
+        block_work(block->actual()->header.bits) };
+
+    // The parent is no longer a leaf.
+    const auto parent = entries_.find(previous);
+    if (parent != entries_.end() && !has_children(previous))
+        leaves_.erase(to_leaf_key(previous, parent->second));
+
+    children_.emplace(previous, hash);
+    ages_.emplace(item.sequence, hash);
+
+    // A child may have arrived before this block.
+    if (!has_children(hash))
+        leaves_.insert(to_leaf_key(hash, item));
+
+    entries_.emplace(hash, item);
+    bytes_ += size;
 }
 
-/*
-orphan_pool::const_iterator orphan_pool::find(buffer::const_iterator begin, const hash_digest& hash) const
+void orphan_pool::erase(entries::iterator it)
 {
-    const auto match = [&hash](const block_detail::ptr& entry)
+    const auto hash = it->first;
+    const auto& item = it->second;
+    const auto previous = item.block->actual()->header.previous_block_hash;
+
+    leaves_.erase(to_leaf_key(hash, item));
+    ages_.erase(item.sequence);
+    bytes_ -= item.size;
+
+    const auto siblings = children_.equal_range(previous);
+    for (auto child = siblings.first; child != siblings.second; ++child)
     {
-        return hash == entry->hash();
-    };
+        if (child->second == hash)
+        {
+            children_.erase(child);
+            break;
+        }
+    }
 
-    return std::find_if(begin, buffer_.end(), match);
+    entries_.erase(it);
+
+    // The parent becomes a leaf when its last child leaves.
+    const auto parent = entries_.find(previous);
+    if (parent != entries_.end() && !has_children(previous))
+        leaves_.insert(to_leaf_key(previous, parent->second));
 }
-*/
 
-orphan_pool::const_reverse_iterator orphan_pool::rfind(buffer::const_reverse_iterator begin, const hash_digest& hash) const
+// Drop the least work leaf, oldest first, keeping every orphan chain whole.
+// The 'keep' leaf is the parent of the incoming block and is skipped.
+block_detail::ptr orphan_pool::evict(const hash_digest& keep)
 {
-    const auto match = [&hash](const block_detail::ptr& entry)
+    for (const auto& leaf: leaves_)
     {
-        return hash == entry->hash();
-    };
+        const auto hash = std::get<2>(leaf);
+        if (hash == keep)
+            continue;
+
+        const auto it = entries_.find(hash);
+        BITCOIN_ASSERT(it != entries_.end());
+        const auto block = it->second.block;
+
+        log::debug(LOG_BLOCKCHAIN)
+            << "Orphan pool evicted block [" << encode_hash(hash)
+            << "] size (" << entries_.size() << ").";
+
+        erase(it);
+        erase_pending(hash);
+        return block;
+    }
+
+    return nullptr;
+}
+
+// An evicted block must not be resumed when its missing parent arrives.
+void orphan_pool::erase_pending(const hash_digest& hash)
+{
+    if (pending_blocks_hash_.erase(hash) == 0)
+        return;
 
-    return std::find_if(begin, buffer_.rend(), match);
+    for (auto it = pending_blocks_.begin(); it != pending_blocks_.end();)
+        if (it->second->hash() == hash)
+            it = pending_blocks_.erase(it);
+        else
+            ++it;
 }
 
 } // namespace blockchain
@@ -37,6 +37,7 @@ settings::settings()
     use_testnet_rules(false),
     collect_split_stake(true),
     disable_account_operations(false),
+    script_verification_threads(0),
     checkpoints(),
     basic_checkpoints()
 {
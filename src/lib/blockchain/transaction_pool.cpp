@@ -44,7 +44,8 @@ transaction_pool::transaction_pool(threadpool& pool, block_chain& chain,
                                    const settings& settings)
     : stopped_(true),
       maintain_consistency_(settings.transaction_pool_consistency),
-      buffer_(settings.transaction_pool_capacity),
+      sequence_(0),
+      capacity_(settings.transaction_pool_capacity),
       dispatch_(pool, NAME),
       blockchain_(chain),
       index_(pool, chain),
@@ -97,66 +98,85 @@ void transaction_pool::inventory(message::inventory::ptr inventory)
 
 void transaction_pool::validate(transaction_ptr tx, validate_handler handler)
 {
+    const auto handle_validated = [handler](const code& ec,
+        transaction_ptr tx, const indexes& unconfirmed, uint64_t)
+    {
+        handler(ec, tx, unconfirmed);
+    };
+
     dispatch_.ordered(&transaction_pool::do_validate,
-                      this, tx, handler);
+                      this, tx, validated_handler(handle_validated));
 }
 
 void transaction_pool::do_validate(transaction_ptr tx,
-                                   validate_handler handler)
+                                   validated_handler handler)
 {
     if (stopped())
     {
-        handler(error::service_stopped, tx, {});
+        handler(error::service_stopped, tx, {}, 0);
         return;
     }
 
     const auto validate = std::make_shared<validate_transaction>(
                               blockchain_, *tx, *this, dispatch_);
 
-    validate->start(
-        dispatch_.ordered_delegate(&transaction_pool::handle_validated,
-                                   this, _1, _2, _3, handler));
+    // The validator calls back from its own member, so it is alive here and
+    // the input value it summed can be carried back onto the pool strand.
+    const auto validator = validate.get();
+    const auto handle_validate = [this, validator, handler](const code& ec,
+        transaction_ptr tx, const indexes& unconfirmed)
+    {
+        dispatch_.ordered(&transaction_pool::handle_validated, this, ec, tx,
+            unconfirmed, validator->value_in(), handler);
+    };
+
+    validate->start(handle_validate);
 }
 
 void transaction_pool::handle_validated(const code& ec, transaction_ptr tx,
-                                        const indexes& unconfirmed, validate_handler handler)
+                                        const indexes& unconfirmed, uint64_t value_in,
+                                        validated_handler handler)
 {
     if (stopped())
     {
-        handler(error::service_stopped, tx, {});
+        handler(error::service_stopped, tx, {}, 0);
         return;
     }
 
     if (ec.value() == error::input_not_found || ec.value() == error::validate_inputs_failed)
     {
         BITCOIN_ASSERT(unconfirmed.size() == 1);
-        handler(ec, tx, unconfirmed);
+        handler(ec, tx, unconfirmed, 0);
         return;
     }
 
     if (ec)
     {
         BITCOIN_ASSERT(unconfirmed.empty());
-        handler(ec, tx, {});
+        handler(ec, tx, {}, 0);
         return;
     }
 
     // Recheck the memory pool, as a duplicate may have been added.
     if (is_in_pool(tx->hash()))
     {
-        handler(error::duplicate, tx, {});
+        handler(error::duplicate, tx, {}, 0);
         return;
     }
 
     code error = check_symbol_repeat(tx);
     if (error) {
-        handler(error, tx, {});
+        handler(error, tx, {}, 0);
         return;
     }
 
-    handler(error::success, tx, unconfirmed);
+    // A store indexes the fee from the input value summed in validation.
+    handler(error::success, tx, unconfirmed, value_in);
 }
 
+// The pool is consistent by construction, so only the new transaction can
+// conflict: check its outputs against the symbol index and its own earlier
+// outputs.
 code transaction_pool::check_symbol_repeat(transaction_ptr tx)
 {
     std::set<string> assets;
@@ -166,121 +186,121 @@ code transaction_pool::check_symbol_repeat(transaction_ptr tx)
     std::set<string> didaddreses;
     std::set<string> didattaches;
 
-    auto check_outputs = [&](transaction_ptr txs)->code
+    const auto claimed = [](const symbol_counts& pooled,
+        const std::set<string>& own, const string& symbol)
+    {
+        return pooled.count(symbol) != 0 || own.count(symbol) != 0;
+    };
+
+    for (auto &output : tx->outputs)
     {
-        for (auto &output : txs->outputs)
+        //add attachment check;avoid send with did while transfer
+        if (output.attach_data.get_version() == DID_ATTACH_VERIFY_VERSION)
         {
-            //add attachment check;avoid send with did while transfer
-            if (output.attach_data.get_version() == DID_ATTACH_VERIFY_VERSION)
-            {
-                auto check_did = [&dids, &didattaches](string attach_did) {
-                    if (!attach_did.empty() && dids.find(attach_did) != dids.end())
-                    {
-                        log::debug(LOG_BLOCKCHAIN)
-                        << "check_symbol_repeat attachment did: " + attach_did
-                        << " already exists in memorypool!";
-                        return false;
-                    }
-
-                    didattaches.insert(attach_did);
-                    return true;
-                };
-
-                if (!check_did(output.attach_data.get_from_did())
-                 || !check_did(output.attach_data.get_to_did())) {
+            auto check_did = [&](string attach_did) {
+                if (!attach_did.empty() && claimed(symbols_.dids, dids, attach_did))
+                {
                     log::debug(LOG_BLOCKCHAIN)
-                        << "check_symbol_repeat from_did " + output.attach_data.get_from_did()
-                        << " to_did " + output.attach_data.get_to_did()
-                        << " check failed!"
-                        << " " << tx->to_string(1);
-                    return error::did_exist;
+                    << "check_symbol_repeat attachment did: " + attach_did
+                    << " already exists in memorypool!";
+                    return false;
                 }
+
+                didattaches.insert(attach_did);
+                return true;
+            };
+
+            if (!check_did(output.attach_data.get_from_did())
+             || !check_did(output.attach_data.get_to_did())) {
+                log::debug(LOG_BLOCKCHAIN)
+                    << "check_symbol_repeat from_did " + output.attach_data.get_from_did()
+                    << " to_did " + output.attach_data.get_to_did()
+                    << " check failed!"
+                    << " " << tx->to_string(1);
+                return error::did_exist;
             }
+        }
 
-            if (output.is_asset_issue())
+        if (output.is_asset_issue())
+        {
+            const auto symbol = output.get_asset_symbol();
+            if (claimed(symbols_.assets, assets, symbol))
             {
-                auto r = assets.insert(output.get_asset_symbol());
-                if (r.second == false)
-                {
-                    log::debug(LOG_BLOCKCHAIN)
-                        << "check_symbol_repeat asset " + output.get_asset_symbol()
-                        << " already exists in memorypool!"
-                        << " " << tx->to_string(1);
-                    return error::asset_exist;
-                }
+                log::debug(LOG_BLOCKCHAIN)
+                    << "check_symbol_repeat asset " + symbol
+                    << " already exists in memorypool!"
+                    << " " << tx->to_string(1);
+                return error::asset_exist;
             }
-            else if (output.is_asset_cert())
+
+            assets.insert(symbol);
+        }
+        else if (output.is_asset_cert())
+        {
+            auto &&key = output.get_asset_cert().get_key();
+            if (claimed(symbols_.certs, asset_certs, key))
             {
-                auto &&key = output.get_asset_cert().get_key();
-                auto r = asset_certs.insert(key);
-                if (r.second == false)
-                {
-                    log::debug(LOG_BLOCKCHAIN)
-                        << "check_symbol_repeat cert " + output.get_asset_cert_symbol()
-                        << " with type " << output.get_asset_cert_type()
-                        << " already exists in memorypool!"
-                        << " " << tx->to_string(1);
-                    return error::asset_cert_exist;
-                }
+                log::debug(LOG_BLOCKCHAIN)
+                    << "check_symbol_repeat cert " + output.get_asset_cert_symbol()
+                    << " with type " << output.get_asset_cert_type()
+                    << " already exists in memorypool!"
+                    << " " << tx->to_string(1);
+                return error::asset_cert_exist;
             }
-            else if (output.is_asset_mit())
+
+            asset_certs.insert(key);
+        }
+        else if (output.is_asset_mit())
+        {
+            const auto symbol = output.get_asset_symbol();
+            if (claimed(symbols_.mits, asset_mits, symbol))
             {
-                auto r = asset_mits.insert(output.get_asset_symbol());
-                if (r.second == false)
-                {
-                    log::debug(LOG_BLOCKCHAIN)
-                        << "check_symbol_repeat mit " + output.get_asset_symbol()
-                        << " already exists in memorypool!"
-                        << " " << tx->to_string(1);
-                    return error::mit_exist;
-                }
+                log::debug(LOG_BLOCKCHAIN)
+                    << "check_symbol_repeat mit " + symbol
+                    << " already exists in memorypool!"
+                    << " " << tx->to_string(1);
+                return error::mit_exist;
             }
-            else if (output.is_did())
-            {
-                auto didsymbol = output.get_did_symbol();
-                auto didexist = dids.insert(didsymbol);
-                if (didexist.second == false) {
-                    log::debug(LOG_BLOCKCHAIN)
-                        << "check_symbol_repeat did " + didsymbol
-                        << " already exists in memorypool!"
-                        << " " << tx->to_string(1);
-                    return error::did_exist;
-                }
 
-                auto didaddress = didaddreses.insert(output.get_did_address());
-                if (didaddress.second == false)
-                {
-                    log::debug(LOG_BLOCKCHAIN)
-                        << "check_symbol_repeat did address " + output.get_did_address()
-                        << " already has did on it in memorypool!"
-                        << " " << tx->to_string(1);
-                    return error::address_registered_did;
-                }
+            asset_mits.insert(symbol);
+        }
+        else if (output.is_did())
+        {
+            auto didsymbol = output.get_did_symbol();
+            if (claimed(symbols_.dids, dids, didsymbol)) {
+                log::debug(LOG_BLOCKCHAIN)
+                    << "check_symbol_repeat did " + didsymbol
+                    << " already exists in memorypool!"
+                    << " " << tx->to_string(1);
+                return error::did_exist;
+            }
 
-                if (didattaches.find(didsymbol) != didattaches.end())
-                {
-                    log::debug(LOG_BLOCKCHAIN)
-                        << "check_symbol_repeat attachment did: " + didsymbol
-                        << " already transfer in memorypool!"
-                        << " " << tx->to_string(1);
-                    return error::did_exist;
-                }
+            dids.insert(didsymbol);
+
+            const auto didaddress = output.get_did_address();
+            if (claimed(symbols_.did_addresses, didaddreses, didaddress))
+            {
+                log::debug(LOG_BLOCKCHAIN)
+                    << "check_symbol_repeat did address " + didaddress
+                    << " already has did on it in memorypool!"
+                    << " " << tx->to_string(1);
+                return error::address_registered_did;
             }
-        }
-        return error::success;
-    };
 
-    code ec;
-    for (auto &item : buffer_)
-    {
-        if (!item.tx)
-            continue;
+            didaddreses.insert(didaddress);
 
-        if((ec = check_outputs(item.tx)))
-            break;
+            if (claimed(symbols_.did_attaches, didattaches, didsymbol))
+            {
+                log::debug(LOG_BLOCKCHAIN)
+                    << "check_symbol_repeat attachment did: " + didsymbol
+                    << " already transfer in memorypool!"
+                    << " " << tx->to_string(1);
+                return error::did_exist;
+            }
+        }
     }
 
-    return (ec.value() != error::success) ? ec : check_outputs(tx);
+    return error::success;
 }
 
 // handle_confirm will never fire if handle_validate returns a failure code.
@@ -293,14 +313,18 @@ void transaction_pool::store(transaction_ptr tx,
         return;
     }
 
-    validate(tx,
-             std::bind(&transaction_pool::do_store,
-                       this, _1, _2, _3, handle_confirm, handle_validate));
+    const validated_handler handle_validated =
+        std::bind(&transaction_pool::do_store,
+                  this, _1, _2, _3, _4, handle_confirm, handle_validate);
+
+    dispatch_.ordered(&transaction_pool::do_validate,
+                      this, tx, handle_validated);
 }
 
 // This is overly complex due to the transaction pool and index split.
 void transaction_pool::do_store(const code& ec, transaction_ptr tx,
-                                const indexes& unconfirmed, confirm_handler handle_confirm,
+                                const indexes& unconfirmed, uint64_t value_in,
+                                confirm_handler handle_confirm,
                                 validate_handler handle_validate)
 {
     if (ec)
@@ -313,6 +337,13 @@ void transaction_pool::do_store(const code& ec, transaction_ptr tx,
     const auto do_deindex = [this, handle_confirm](const code ec,
                             transaction_ptr tx)
     {
+        // A duplicate was never indexed under this entry, keep the original.
+        if (ec == error::duplicate)
+        {
+            handle_confirm(ec, tx);
+            return;
+        }
+
         const auto do_confirm = [handle_confirm, tx, ec](const code)
         {
             handle_confirm(ec, tx);
@@ -323,7 +354,12 @@ void transaction_pool::do_store(const code& ec, transaction_ptr tx,
     };
 
     // Add to pool, save confirmation handler.
-    add(tx, do_deindex);
+    if (!add(tx, do_deindex, value_in))
+    {
+        // The rejected tx is not indexed, validation itself succeeded.
+        handle_validate(error::success, tx, unconfirmed);
+        return;
+    }
 
     const auto handle_indexed = [this, handle_validate, tx, unconfirmed](
                                     const code ec)
@@ -332,7 +368,7 @@ void transaction_pool::do_store(const code& ec, transaction_ptr tx,
         notify_transaction(unconfirmed, tx);
 
         log::debug(LOG_BLOCKCHAIN)
-                << "Transaction saved to mempool (" << buffer_.size() << ")";
+                << "Transaction saved to mempool (" << entries_.size() << ")";
 
         // Notify caller that the tx has been validated and indexed.
         handle_validate(ec, tx, unconfirmed);
@@ -353,11 +389,10 @@ void transaction_pool::fetch(fetch_all_handler handler)
     const auto tx_fetcher = [this, handler]()
     {
         std::vector<transaction_ptr> transactions;
-        for (auto item : buffer_)
-        {
-            if (item.tx)
-                transactions.push_back(item.tx);
-        }
+        transactions.reserve(entries_.size());
+        for (const auto& item : entries_)
+            transactions.push_back(item.second.tx);
+
         handler(error::success, transactions);
     };
 
@@ -374,18 +409,43 @@ void transaction_pool::delete_tx(const hash_digest& tx_hash)
     log::debug(LOG_BLOCKCHAIN) << " delete_tx hash:" << libbitcoin::encode_hash(tx_hash);
     const auto tx_delete = [this, tx_hash]()
     {
-        for (auto item = buffer_.begin(); item != buffer_.end(); ++item)
+        entry removed;
+        if (erase_entry(tx_hash, removed))
+            log::debug(LOG_BLOCKCHAIN) << " delete_tx hash:" << libbitcoin::encode_hash(tx_hash) << " success";
+    };
+
+    dispatch_.ordered(tx_delete);
+}
+
+void transaction_pool::fetch_template(size_t max_size,
+                                      fetch_template_handler handler)
+{
+    if (stopped())
+    {
+        handler(error::service_stopped, {});
+        return;
+    }
+
+    const auto template_fetcher = [this, max_size, handler]()
+    {
+        std::vector<rated_transaction> transactions;
+        std::unordered_set<hash_digest> taken;
+        size_t size = 0;
+
+        // Walk down the fee rates, taking each package until full. A parent
+        // carries the rate of the first, best, package which takes it.
+        for (const auto& rate : fee_rates_)
         {
-            if (item->tx->hash() == tx_hash)
-            {
-                log::debug(LOG_BLOCKCHAIN) << " delete_tx hash:" << libbitcoin::encode_hash(tx_hash) << " success";
-                buffer_.erase(item);
+            if (size >= max_size)
                 break;
-            }
+
+            take_package(rate.second, rate.first, transactions, taken, size);
         }
+
+        handler(error::success, transactions);
     };
 
-    dispatch_.ordered(tx_delete);
+    dispatch_.ordered(template_fetcher);
 }
 
 void transaction_pool::fetch(const hash_digest& transaction_hash,
@@ -401,7 +461,7 @@ void transaction_pool::fetch(const hash_digest& transaction_hash,
     {
         const auto it = find(transaction_hash);
 
-        if (it == buffer_.end())
+        if (it == nullptr)
             handler(error::not_found, {});
         else
             handler(error::success, it->tx);
@@ -418,7 +478,6 @@ void transaction_pool::fetch_history(const payment_address& address,
     index_.fetch_all_history(address, limit, from_height, handler);
 }
 
-// TODO: use hash table pool to eliminate this O(n^2) search.
 void transaction_pool::filter(get_data_ptr message, result_handler handler)
 {
     if (stopped())
@@ -492,7 +551,7 @@ bool transaction_pool::handle_reorganized(const code& ec, size_t fork_point,
     else
     {
         log::debug(LOG_BLOCKCHAIN)
-                << "Reorganize: tx pool size (" << buffer_.size()
+                << "Reorganize: tx pool size (" << entries_.size()
                 << ") forked at (" << fork_point
                 << ") new blocks (" << new_blocks.size()
                 << ") replace blocks (" << replaced_blocks.size() << ")";
@@ -524,22 +583,48 @@ void transaction_pool::notify_transaction(const point::indexes& unconfirmed,
 // ----------------------------------------------------------------------------
 
 // A new transaction has been received, add it to the memory pool.
-void transaction_pool::add(transaction_ptr tx, confirm_handler handler)
+// A rejected transaction is reported through its handler and not stored.
+bool transaction_pool::add(transaction_ptr tx, confirm_handler handler,
+    uint64_t value_in)
 {
-    // When a new tx is added to the buffer drop the oldest.
-    if (maintain_consistency_ && buffer_.size() == buffer_.capacity())
+    // Validation already rejected duplicates on this strand.
+    if (is_in_pool(tx->hash()))
+    {
+        handler(error::duplicate, tx);
+        return false;
+    }
+
+    // A zero capacity pool stores nothing, as the circular buffer did.
+    if (capacity_ == 0)
+    {
+        handler(error::pool_filled, tx);
+        return false;
+    }
+
+    // When a new tx is added to the pool drop the oldest.
+    if (maintain_consistency_ && full())
         delete_package(error::pool_filled);
 
-    buffer_.push_back({ tx, handler });
+    // Otherwise only the oldest is dropped.
+    if (full())
+        delete_single(entries_.begin()->second.tx->hash(), error::pool_filled);
+
+    insert_entry(tx, handler, value_in);
+    return true;
 }
 
 // There has been a reorg, clear the memory pool using the given reason code.
 void transaction_pool::clear(const code& ec)
 {
-    for (const auto& entry : buffer_)
-        entry.handle_confirm(ec, entry.tx);
-
-    buffer_.clear();
+    for (const auto& entry : entries_)
+        entry.second.handle_confirm(ec, entry.second.tx);
+
+    entries_.clear();
+    hashes_.clear();
+    spenders_.clear();
+    symbols_ = {};
+    fee_entries_.clear();
+    fee_rates_.clear();
 }
 
 // Delete memory pool txs that are obsoleted by a new block acceptance.
@@ -559,7 +644,7 @@ void transaction_pool::remove(const block_list& blocks)
 // Delete mempool txs that are duplicated in the new blocks.
 void transaction_pool::delete_confirmed_in_blocks(const block_list& blocks)
 {
-    if (stopped() || buffer_.empty())
+    if (stopped() || entries_.empty())
         return;
 
     for (const auto& block : blocks)
@@ -570,7 +655,7 @@ void transaction_pool::delete_confirmed_in_blocks(const block_list& blocks)
 // Delete all txs that spend a previous output of any tx in the new blocks.
 void transaction_pool::delete_spent_in_blocks(const block_list& blocks)
 {
-    if (stopped() || buffer_.empty())
+    if (stopped() || entries_.empty())
         return;
 
     for (const auto& block : blocks)
@@ -580,110 +665,315 @@ void transaction_pool::delete_spent_in_blocks(const block_list& blocks)
                                     error::double_spend);
 }
 
-// Delete any tx that spends any output of this tx.
+// Delete any tx that spends this output, and its descendants.
 void transaction_pool::delete_dependencies(const output_point& point,
         const code& ec)
 {
-    const auto comparitor = [&point](const input & input)
+    // We queue deletion to protect the index iterators.
+    std::vector<transaction_ptr> dependencies;
+    const auto spenders = spenders_.equal_range(point);
+    for (auto it = spenders.first; it != spenders.second; ++it)
     {
-        return input.previous_output == point;
-    };
+        const auto spender = find(it->second);
+        if (spender != nullptr)
+            dependencies.push_back(spender->tx);
+    }
 
-    delete_dependencies(comparitor, ec);
+    for (const auto& dependency : dependencies)
+        delete_package(dependency, ec);
 }
 
-// Delete any tx that spends any output of this tx.
-void transaction_pool::delete_dependencies(const hash_digest& tx_hash,
-        const code& ec)
+void transaction_pool::delete_package(const code& ec)
 {
-    const auto comparitor = [&tx_hash](const input & input)
-    {
-        return input.previous_output.hash == tx_hash;
-    };
+    if (stopped() || entries_.empty())
+        return;
 
-    delete_dependencies(comparitor, ec);
+    // Must copy the tx because it is going to be deleted from the pool.
+    const auto oldest = entries_.begin()->second.tx;
+    delete_package(oldest, ec);
 }
 
-// This is horribly inefficient, but it's simple.
-// TODO: Create persistent multi-indexed memory pool (including age and
-// children) and perform this pruning trivialy (and add policy over it).
-void transaction_pool::delete_dependencies(input_compare is_dependency,
-        const code& ec)
+void transaction_pool::delete_package(transaction_ptr tx, const code& ec)
+{
+    const auto tx_hash = tx->hash();
+    if (!delete_single(tx_hash, ec))
+        return;
+
+    const auto outputs = static_cast<uint32_t>(tx->outputs.size());
+    for (uint32_t index = 0; index < outputs; ++index)
+        delete_dependencies({ tx_hash, index }, ec);
+}
+
+bool transaction_pool::delete_single(const hash_digest& tx_hash, const code& ec)
 {
-    std::vector<entry> dependencies;
-    for (const auto& entry : buffer_)
-        for (const auto& input : entry.tx->inputs)
-            if (is_dependency(input))
+    if (stopped())
+        return false;
+
+    entry removed;
+    if (!erase_entry(tx_hash, removed))
+        return false;
+
+    if (ec) {
+        log::debug(LOG_BLOCKCHAIN)
+            << "delete_tx " << encode_hash(tx_hash)
+            << ", error code is " << ec.message();
+    }
+
+    removed.handle_confirm(ec, removed.tx);
+    return true;
+}
+
+// Entry indexes.
+// ----------------------------------------------------------------------------
+
+bool transaction_pool::full() const
+{
+    return entries_.size() >= capacity_;
+}
+
+void transaction_pool::insert_entry(transaction_ptr tx,
+    confirm_handler handler, uint64_t value_in)
+{
+    const auto tx_hash = tx->hash();
+    const auto sequence = sequence_++;
+
+    entries_.emplace(sequence, entry{ tx, handler });
+    hashes_.emplace(tx_hash, sequence);
+
+    for (const auto& input : tx->inputs)
+        spenders_.emplace(input.previous_output, tx_hash);
+
+    index_symbols(*tx, true);
+    index_fee(tx, value_in);
+}
+
+bool transaction_pool::erase_entry(const hash_digest& tx_hash, entry& out)
+{
+    const auto hash = hashes_.find(tx_hash);
+    if (hash == hashes_.end())
+        return false;
+
+    const auto it = entries_.find(hash->second);
+    out = std::move(it->second);
+    entries_.erase(it);
+    hashes_.erase(hash);
+
+    for (const auto& input : out.tx->inputs)
+    {
+        const auto spenders = spenders_.equal_range(input.previous_output);
+        for (auto spender = spenders.first; spender != spenders.second;
+            ++spender)
+        {
+            if (spender->second == tx_hash)
             {
-                dependencies.push_back(entry);
+                spenders_.erase(spender);
                 break;
             }
+        }
+    }
 
-    // We queue deletion to protect the iterator.
-    for (const auto& dependency : dependencies)
-        delete_package(dependency.tx, ec);
+    index_symbols(*out.tx, false);
+    deindex_fee(tx_hash);
+    return true;
 }
 
-void transaction_pool::delete_package(const code& ec)
+// Mirrors the symbols check_symbol_repeat compares.
+void transaction_pool::index_symbols(const transaction& tx, bool add)
 {
-    if (stopped() || buffer_.empty())
-        return;
+    const auto update = [add](symbol_counts& counts, const string& symbol)
+    {
+        if (add)
+        {
+            ++counts[symbol];
+            return;
+        }
+
+        const auto it = counts.find(symbol);
+        if (it != counts.end() && --it->second == 0)
+            counts.erase(it);
+    };
 
-    // Must copy the entry because it is going to be deleted from the list.
-    const auto oldest = buffer_.front();
+    for (const auto& output : tx.outputs)
+    {
+        if (output.attach_data.get_version() == DID_ATTACH_VERIFY_VERSION)
+        {
+            const auto from_did = output.attach_data.get_from_did();
+            const auto to_did = output.attach_data.get_to_did();
+            if (!from_did.empty())
+                update(symbols_.did_attaches, from_did);
+            if (!to_did.empty())
+                update(symbols_.did_attaches, to_did);
+        }
 
-    oldest.handle_confirm(ec, oldest.tx);
-    delete_package(oldest.tx, ec);
+        if (output.is_asset_issue())
+        {
+            update(symbols_.assets, output.get_asset_symbol());
+        }
+        else if (output.is_asset_cert())
+        {
+            update(symbols_.certs, output.get_asset_cert().get_key());
+        }
+        else if (output.is_asset_mit())
+        {
+            update(symbols_.mits, output.get_asset_symbol());
+        }
+        else if (output.is_did())
+        {
+            update(symbols_.dids, output.get_did_symbol());
+            update(symbols_.did_addresses, output.get_did_address());
+        }
+    }
 }
 
-void transaction_pool::delete_package(transaction_ptr tx, const code& ec)
+// Fee rate index.
+// ----------------------------------------------------------------------------
+
+transaction_pool::fee_rate_key transaction_pool::to_fee_rate_key(
+    const hash_digest& tx_hash, uint64_t package_fee, uint64_t package_size)
 {
-    if (delete_single(tx->hash(), ec))
-        delete_dependencies(tx->hash(), ec);
+    const auto size = std::max<uint64_t>(package_size, 1);
+    return{ package_fee * 1000 / size, tx_hash };
 }
 
-bool transaction_pool::delete_single(const hash_digest& tx_hash, const code& ec)
+// The input value is summed by validation, over confirmed and pool parents.
+void transaction_pool::index_fee(transaction_ptr tx, uint64_t value_in)
 {
-    if (stopped())
-        return false;
+    const auto tx_hash = tx->hash();
+    if (fee_entries_.count(tx_hash) != 0)
+        return;
+
+    fee_entry entry{ tx, 0, tx->serialized_size(1), 0, 0, {}, {} };
 
-    const auto matched = [&tx_hash](const entry & entry)
+    for (const auto& input : tx->inputs)
     {
-        return entry.tx->hash() == tx_hash;
-    };
+        const auto& prevout = input.previous_output;
+        const auto parent = fee_entries_.find(prevout.hash);
 
-    const auto it = std::find_if(buffer_.begin(), buffer_.end(), matched);
+        // The previous output is unconfirmed, the parent is in the pool.
+        if (parent == fee_entries_.end())
+            continue;
 
-    if (it == buffer_.end())
-        return false;
+        auto& parents = entry.parents;
+        if (std::find(parents.begin(), parents.end(), prevout.hash) ==
+            parents.end())
+        {
+            parents.push_back(prevout.hash);
+            parent->second.children.push_back(tx_hash);
+        }
+    }
 
-    it->handle_confirm(ec, it->tx);
-    buffer_.erase(it);
+    const auto value_out = tx->total_output_value();
+    entry.fee = value_in > value_out ? value_in - value_out : 0;
 
-    if (ec) {
-        log::debug(LOG_BLOCKCHAIN)
-            << "delete_tx " << encode_hash(tx_hash)
-            << ", error code is " << ec.message();
+    fee_entries_.emplace(tx_hash, std::move(entry));
+    update_package(tx_hash);
+}
+
+void transaction_pool::deindex_fee(const hash_digest& tx_hash)
+{
+    const auto it = fee_entries_.find(tx_hash);
+    if (it == fee_entries_.end())
+        return;
+
+    const auto& entry = it->second;
+    fee_rates_.erase(to_fee_rate_key(tx_hash, entry.package_fee,
+        entry.package_size));
+
+    for (const auto& parent_hash : entry.parents)
+    {
+        const auto parent = fee_entries_.find(parent_hash);
+        if (parent == fee_entries_.end())
+            continue;
+
+        auto& children = parent->second.children;
+        children.erase(std::remove(children.begin(), children.end(), tx_hash),
+            children.end());
     }
 
-    while (1) {
-        const auto it = std::find_if(buffer_.begin(), buffer_.end(), matched);
+    const auto children = entry.children;
+    fee_entries_.erase(it);
 
-        if (it == buffer_.end())
-            break;
+    // The packages of the descendants no longer include this transaction.
+    std::unordered_set<hash_digest> updated;
+    for (const auto& child_hash : children)
+    {
+        const auto child = fee_entries_.find(child_hash);
+        if (child == fee_entries_.end())
+            continue;
 
-        it->handle_confirm(ec, it->tx);
-        buffer_.erase(it);
+        auto& parents = child->second.parents;
+        parents.erase(std::remove(parents.begin(), parents.end(), tx_hash),
+            parents.end());
+        update_descendants(child_hash, updated);
     }
+}
 
-    return true;
+// Sum the transaction with its unconfirmed ancestors and reindex its rate.
+void transaction_pool::update_package(const hash_digest& tx_hash)
+{
+    auto& entry = fee_entries_.at(tx_hash);
+    fee_rates_.erase(to_fee_rate_key(tx_hash, entry.package_fee,
+        entry.package_size));
+
+    uint64_t package_fee = entry.fee;
+    uint64_t package_size = entry.size;
+    std::unordered_set<hash_digest> ancestors;
+    hash_list pending(entry.parents);
+
+    while (!pending.empty())
+    {
+        const auto ancestor_hash = pending.back();
+        pending.pop_back();
+
+        if (!ancestors.insert(ancestor_hash).second)
+            continue;
+
+        const auto& ancestor = fee_entries_.at(ancestor_hash);
+        package_fee += ancestor.fee;
+        package_size += ancestor.size;
+        pending.insert(pending.end(), ancestor.parents.begin(),
+            ancestor.parents.end());
+    }
+
+    entry.package_fee = package_fee;
+    entry.package_size = package_size;
+    fee_rates_.insert(to_fee_rate_key(tx_hash, package_fee, package_size));
+}
+
+void transaction_pool::update_descendants(const hash_digest& tx_hash,
+    std::unordered_set<hash_digest>& updated)
+{
+    if (!updated.insert(tx_hash).second)
+        return;
+
+    update_package(tx_hash);
+
+    for (const auto& child_hash : fee_entries_.at(tx_hash).children)
+        update_descendants(child_hash, updated);
+}
+
+// Take the unconfirmed ancestors of the transaction and then the transaction.
+void transaction_pool::take_package(const hash_digest& tx_hash, uint64_t rate,
+    std::vector<rated_transaction>& out,
+    std::unordered_set<hash_digest>& taken, size_t& size) const
+{
+    if (taken.count(tx_hash) != 0)
+        return;
+
+    const auto& entry = fee_entries_.at(tx_hash);
+    for (const auto& parent_hash : entry.parents)
+        take_package(parent_hash, rate, out, taken, size);
+
+    taken.insert(tx_hash);
+    out.emplace_back(entry.tx, rate);
+    size += entry.size;
 }
 
 bool transaction_pool::find(transaction_ptr& out_tx,
                             const hash_digest& tx_hash) const
 {
     const auto it = find(tx_hash);
-    const auto found = it != buffer_.end();
+    const auto found = it != nullptr;
 
     if (found)
         out_tx = it->tx;
@@ -695,7 +985,7 @@ bool transaction_pool::find(chain::transaction& out_tx,
                             const hash_digest& tx_hash) const
 {
     const auto it = find(tx_hash);
-    const auto found = it != buffer_.end();
+    const auto found = it != nullptr;
 
     if (found)
     {
@@ -706,20 +996,19 @@ bool transaction_pool::find(chain::transaction& out_tx,
     return found;
 }
 
-transaction_pool::const_iterator transaction_pool::find(
+const transaction_pool::entry* transaction_pool::find(
     const hash_digest& tx_hash) const
 {
-    const auto found = [&tx_hash](const entry & entry)
-    {
-        return entry.tx->hash() == tx_hash;
-    };
+    const auto hash = hashes_.find(tx_hash);
+    if (hash == hashes_.end())
+        return nullptr;
 
-    return std::find_if(buffer_.begin(), buffer_.end(), found);
+    return &entries_.at(hash->second);
 }
 
 bool transaction_pool::is_in_pool(const hash_digest& tx_hash) const
 {
-    return find(tx_hash) != buffer_.end();
+    return hashes_.count(tx_hash) != 0;
 }
 
 bool transaction_pool::is_spent_in_pool(transaction_ptr tx) const
@@ -740,12 +1029,7 @@ bool transaction_pool::is_spent_in_pool(const transaction& tx) const
 
 bool transaction_pool::is_spent_in_pool(const output_point& outpoint) const
 {
-    const auto found = [&outpoint](const entry & entry)
-    {
-        return is_spent_by_tx(outpoint, entry.tx);
-    };
-
-    return std::any_of(buffer_.begin(), buffer_.end(), found);
+    return spenders_.count(outpoint) != 0;
 }
 
 bool transaction_pool::is_spent_by_tx(const output_point& outpoint,
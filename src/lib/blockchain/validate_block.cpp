@@ -23,9 +23,12 @@
 
 #include <set>
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <future>
+#include <memory>
 #include <system_error>
 #include <vector>
 #include <metaverse/bitcoin.hpp>
@@ -443,6 +446,67 @@ bool validate_block::is_valid_coinbase_height(uint64_t height, const block& bloc
     return std::equal(expected.begin(), expected.end(), actual.begin());
 }
 
+static bool verify_script_check(
+    const validate_transaction::script_check& check)
+{
+    return validate_transaction::check_consensus(check.prevout_script,
+        *check.tx, check.input_index, check.flags, *check.context);
+}
+
+// Verify the deferred script checks on the script pool and the calling
+// thread and return the index of the first failing check, or the count if
+// all pass. Checks are claimed in order from a shared counter and nothing
+// past a known failure is claimed, so the batch is cancelled early and the
+// result does not depend on scheduling.
+static size_t verify_script_checks(
+    const validate_transaction::script_check::list& checks,
+    block_chain_impl& chain, const std::function<bool()>& stopped)
+{
+    const auto count = checks.size();
+    std::atomic<size_t> next(0);
+    std::atomic<size_t> first_failure(count);
+
+    const auto verify = [&]()
+    {
+        while (!stopped())
+        {
+            const auto index = next++;
+            if (index >= first_failure.load())
+                break;
+
+            if (!verify_script_check(checks[index]))
+            {
+                auto failure = first_failure.load();
+                while (index < failure &&
+                    !first_failure.compare_exchange_weak(failure, index));
+                break;
+            }
+        }
+    };
+
+    const auto threads = std::min(chain.script_threads(), count);
+    const auto helpers = threads > 1 ? threads - 1 : 0;
+    std::vector<std::future<void>> results;
+    results.reserve(helpers);
+
+    for (size_t i = 0; i < helpers; ++i)
+    {
+        const auto job = std::make_shared<std::packaged_task<void()>>(verify);
+        results.push_back(job->get_future());
+        chain.script_pool().service().post([job]() { (*job)(); });
+    }
+
+    verify();
+
+    for (auto& result: results)
+        result.wait();
+
+    for (auto& result: results)
+        result.get();
+
+    return first_failure.load();
+}
+
 code validate_block::connect_block(hash_digest& err_tx, blockchain::block_chain_impl& chain) const
 {
     err_tx = null_hash;
@@ -451,7 +515,6 @@ code validate_block::connect_block(hash_digest& err_tx, blockchain::block_chain_
     // BIP30 duplicate exceptions are spent and are not indexed.
     if (is_active(script_context::bip30_enabled))
     {
-        ////////////// TODO: parallelize. //////////////
         for (const auto& tx : transactions)
         {
             if (is_spent_duplicate(tx))
@@ -472,7 +535,8 @@ code validate_block::connect_block(hash_digest& err_tx, blockchain::block_chain_
     uint64_t coinage_reward_coinbase_index = !is_pos ? 1 : 2;
     uint64_t get_coinage_reward_tx_count = 0;
 
-    ////////////// TODO: parallelize. //////////////
+    // Fees, sigops and coinage reward indexes accumulate in block order, so
+    // this stays sequential. Input scripts are verified in parallel below.
     for (uint64_t tx_index = 0; tx_index < count; ++tx_index)
     {
         auto is_coinstake = false;
@@ -587,11 +651,21 @@ code validate_block::connect_block(hash_digest& err_tx, blockchain::block_chain_
     std::set<string> dids;
     std::set<string> didaddreses;
     code first_tx_ec = error::success;
-    for (const auto& tx : transactions)
+    uint64_t first_tx_index = count;
+
+    // Input scripts dominate the cost of connecting a block, so they are
+    // collected here and verified in parallel after the sequential checks.
+    validate_transaction::script_check::list script_checks;
+    std::vector<uint64_t> script_check_tx_indexes;
+
+    for (uint64_t tx_index = 0; tx_index < count; ++tx_index)
     {
         RETURN_IF_STOPPED();
 
+        const auto& tx = transactions[tx_index];
+        const auto checks_begin = script_checks.size();
         const auto validate_tx = std::make_shared<validate_transaction>(chain, tx, *this);
+        validate_tx->defer_script_checks(script_checks);
         auto ec = validate_tx->check_transaction();
         if (!ec) {
             ec = validate_tx->check_transaction_connect_input(current_block_.header.number);
@@ -660,9 +734,51 @@ code validate_block::connect_block(hash_digest& err_tx, blockchain::block_chain_
         if (ec) {
             if (!first_tx_ec) {
                 first_tx_ec = ec;
+                first_tx_index = tx_index;
             }
+            script_checks.resize(checks_begin);
             chain.pool().delete_tx(tx.hash());
         }
+        else {
+            script_check_tx_indexes.resize(script_checks.size(), tx_index);
+        }
+    }
+
+    if (script_checks.empty()) {
+        return first_tx_ec;
+    }
+
+    const auto failed_check = verify_script_checks(script_checks, chain,
+        [this]() { return stopped(); });
+
+    RETURN_IF_STOPPED();
+
+    // The block is invalid, its remaining checks are run one by one on this
+    // thread only to drop every tx with a failed script from the pool. The
+    // block reports the error of its first failing tx.
+    auto last_failed_tx = count;
+    for (auto check = failed_check; check < script_checks.size(); ++check) {
+        RETURN_IF_STOPPED();
+
+        const auto tx_index = script_check_tx_indexes[check];
+        if (tx_index == last_failed_tx) {
+            continue;
+        }
+
+        if (check != failed_check && verify_script_check(script_checks[check])) {
+            continue;
+        }
+
+        last_failed_tx = tx_index;
+        const auto& tx = transactions[tx_index];
+        log::debug(LOG_BLOCKCHAIN) << "check_consensus failed. tx hash:"
+            << encode_hash(tx.hash());
+        chain.pool().delete_tx(tx.hash());
+
+        if (tx_index < first_tx_index) {
+            first_tx_index = tx_index;
+            first_tx_ec = error::validate_inputs_failed;
+        }
     }
 
     if (first_tx_ec) {
@@ -723,7 +839,6 @@ bool validate_block::is_spent_duplicate(const transaction& tx) const
         return false;
 
     // Are all outputs spent?
-    ////////////// TODO: parallelize. //////////////
     for (uint32_t output_index = 0; output_index < tx.outputs.size();
             ++output_index)
     {
@@ -739,7 +854,7 @@ bool validate_block::validate_inputs(const transaction& tx,
 {
     BITCOIN_ASSERT(!tx.is_coinbase());
 
-    ////////////// TODO: parallelize. //////////////
+    // Scripts are not run here, connect_block verifies them in parallel.
     for (uint64_t input_index = 0; input_index < tx.inputs.size(); ++input_index)
         if (!connect_input(index_in_parent, tx, input_index, value_in,
                            total_sigops))
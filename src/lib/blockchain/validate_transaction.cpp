@@ -56,7 +56,8 @@ validate_transaction::validate_transaction(block_chain& chain,
       pool_(nullptr),
       dispatch_(nullptr),
       validate_block_(&validate_block),
-      tx_hash_(tx.hash())
+      tx_hash_(tx.hash()),
+      deferred_checks_(nullptr)
 {
 }
 
@@ -67,7 +68,8 @@ validate_transaction::validate_transaction(block_chain& chain,
       pool_(&pool),
       dispatch_(&dispatch),
       validate_block_(nullptr),
-      tx_hash_(tx.hash())
+      tx_hash_(tx.hash()),
+      deferred_checks_(nullptr)
 {
 }
 
@@ -1348,6 +1350,11 @@ code validate_transaction::connect_attachment_from_did(const output& output) con
     return error::did_address_not_match;
 }
 
+void validate_transaction::defer_script_checks(script_check::list& checks)
+{
+    deferred_checks_ = &checks;
+}
+
 code validate_transaction::check_transaction_connect_input(uint64_t last_height)
 {
     if (last_height == 0 || tx_->is_coinbase()) {
@@ -1423,6 +1430,11 @@ code validate_transaction::check_transaction() const
     return ret;
 }
 
+uint64_t validate_transaction::value_in() const
+{
+    return value_in_;
+}
+
 uint64_t validate_transaction::get_height() const
 {
     uint64_t height = 0;
@@ -1713,8 +1725,40 @@ code validate_transaction::check_transaction_basic() const
 }
 
 // Validate script consensus conformance based on flags provided.
+struct validate_transaction::verify_context
+{
+#ifdef WITH_CONSENSUS
+    explicit verify_context(const data_chunk& transaction)
+      : transaction(transaction.data(), transaction.size())
+    {
+    }
+
+    // The transaction deserialized with its signature hash midstates.
+    const consensus::transaction_context transaction;
+#endif
+};
+
+validate_transaction::verify_context_ptr
+validate_transaction::create_verify_context(const transaction& tx)
+{
+#ifdef WITH_CONSENSUS
+    return std::make_shared<const verify_context>(tx.to_data());
+#else
+    return std::make_shared<const verify_context>();
+#endif
+}
+
 bool validate_transaction::check_consensus(const script& prevout_script,
         const transaction& current_tx, uint64_t input_index, uint32_t flags)
+{
+    const auto context = create_verify_context(current_tx);
+    return check_consensus(prevout_script, current_tx, input_index, flags,
+        *context);
+}
+
+bool validate_transaction::check_consensus(const script& prevout_script,
+        const transaction& current_tx, uint64_t input_index, uint32_t flags,
+        const verify_context& context)
 {
     BITCOIN_ASSERT(input_index <= max_uint32);
     BITCOIN_ASSERT(input_index < current_tx.inputs.size());
@@ -1723,7 +1767,6 @@ bool validate_transaction::check_consensus(const script& prevout_script,
 #ifdef WITH_CONSENSUS
     using namespace bc::consensus;
     const auto previous_output_script = prevout_script.to_data(false);
-    data_chunk current_transaction = current_tx.to_data();
 
     // Convert native flags to libbitcoin-consensus flags.
     uint32_t consensus_flags = verify_flags_none;
@@ -1743,18 +1786,16 @@ bool validate_transaction::check_consensus(const script& prevout_script,
     if ((flags & chain::script_context::bip112_enabled) != 0)
         consensus_flags |= verify_flags_checksequenceverify;
 
-    const auto result = verify_script(current_transaction.data(),
-                                      current_transaction.size(), previous_output_script.data(),
-                                      previous_output_script.size(), input_index32, consensus_flags);
+    const auto result = verify_script(context.transaction,
+                                      previous_output_script.data(), previous_output_script.size(),
+                                      input_index32, consensus_flags);
 
     const auto valid = (result == verify_result::verify_result_eval_true);
 #else
-    // Copy the const prevout script so it can be run.
-    auto previous_output_script = prevout_script;
     const auto& current_input_script = current_tx.inputs[input_index].script;
 
     const auto valid = script::verify(current_input_script,
-                                      previous_output_script, current_tx, input_index32, flags);
+                                      prevout_script, current_tx, input_index32, flags);
     const auto result = valid;
 #endif
 
@@ -1827,7 +1868,16 @@ bool validate_transaction::connect_input( const transaction& previous_tx, uint64
         }
     }
 
-    if (!check_consensus(previous_output.script, *tx_, current_input_, chain::get_script_context())) {
+    if (!verify_context_) {
+        verify_context_ = create_verify_context(*tx_);
+    }
+
+    if (deferred_checks_ != nullptr) {
+        deferred_checks_->push_back({ previous_output.script, tx_,
+            verify_context_, current_input_, chain::get_script_context() });
+    }
+    else if (!check_consensus(previous_output.script, *tx_, current_input_,
+        chain::get_script_context(), *verify_context_)) {
         log::debug(LOG_BLOCKCHAIN) << "check_consensus failed";
         return false;
     }
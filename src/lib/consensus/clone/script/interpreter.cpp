@@ -13,6 +13,7 @@
 #include "script/script.h"
 #include "uint256.h"
 #include <metaverse/bitcoin/constants.hpp>
+#include <metaverse/bitcoin/math/signature_cache.hpp>
 #include <metaverse/bitcoin/chain/attachment/asset/attenuation_model.hpp>
 
 using namespace std;
@@ -1129,9 +1130,60 @@ public:
     }
 };
 
+/** Stream that appends serialized data to a byte vector. */
+class CBufferWriter
+{
+private:
+    std::vector<unsigned char>& buffer;
+
+public:
+    int nType;
+    int nVersion;
+
+    CBufferWriter(std::vector<unsigned char>& bufferIn, int nTypeIn, int nVersionIn) : buffer(bufferIn), nType(nTypeIn), nVersion(nVersionIn) {}
+
+    CBufferWriter& write(const char *pch, size_t size) {
+        buffer.insert(buffer.end(), pch, pch + size);
+        return (*this);
+    }
+
+    template<typename T>
+    CBufferWriter& operator<<(const T& obj) {
+        ::Serialize(*this, obj, nType, nVersion);
+        return (*this);
+    }
+};
+
 } // anon namespace
 
-uint256 SignatureHash(const CScript& scriptCode, const CTransaction& txTo, unsigned int nIn, int nHashType)
+PrecomputedSignatureHash::PrecomputedSignatureHash(const CTransaction& txTo)
+{
+    const size_t nInputs = txTo.vin.size();
+    CBufferWriter inputs(blankedInputs, SER_GETHASH, 0);
+    blankedOffsets.reserve(nInputs + 1);
+    for (size_t nInput = 0; nInput < nInputs; nInput++) {
+        blankedOffsets.push_back(blankedInputs.size());
+        inputs << txTo.vin[nInput].prevout << CScriptBase() << txTo.vin[nInput].nSequence;
+    }
+    blankedOffsets.push_back(blankedInputs.size());
+
+    CHashWriter prefix(SER_GETHASH, 0);
+    prefix << txTo.nVersion;
+    WriteCompactSize(prefix, nInputs);
+    inputPrefixes.reserve(nInputs);
+    for (size_t nInput = 0; nInput < nInputs; nInput++) {
+        inputPrefixes.push_back(prefix);
+        prefix.write((const char*)blankedInputs.data() + blankedOffsets[nInput], blankedOffsets[nInput + 1] - blankedOffsets[nInput]);
+    }
+
+    CBufferWriter rest(tail, SER_GETHASH, 0);
+    WriteCompactSize(rest, txTo.vout.size());
+    for (size_t nOutput = 0; nOutput < txTo.vout.size(); nOutput++)
+        rest << txTo.vout[nOutput];
+    rest << txTo.nLockTime;
+}
+
+uint256 SignatureHash(const CScript& scriptCode, const CTransaction& txTo, unsigned int nIn, int nHashType, const PrecomputedSignatureHash* cache)
 {
     static const uint256 one(uint256S("0000000000000000000000000000000000000000000000000000000000000001"));
     if (nIn >= txTo.vin.size()) {
@@ -1150,6 +1202,20 @@ uint256 SignatureHash(const CScript& scriptCode, const CTransaction& txTo, unsig
     // Wrapper to serialize only the necessary parts of the transaction being signed
     CTransactionSignatureSerializer txTmp(txTo, scriptCode, nIn, nHashType);
 
+    // SIGHASH_ALL differs between inputs only in the signed input, so resume
+    // from the hash of what precedes it and append the precomputed remainder.
+    const bool fHashAll = !(nHashType & SIGHASH_ANYONECANPAY) &&
+        (nHashType & 0x1f) != SIGHASH_SINGLE && (nHashType & 0x1f) != SIGHASH_NONE;
+    if (cache && fHashAll) {
+        CHashWriter ss(cache->inputPrefixes[nIn]);
+        txTmp.SerializeInput(ss, nIn, SER_GETHASH, 0);
+        const size_t nNext = cache->blankedOffsets[nIn + 1];
+        ss.write((const char*)cache->blankedInputs.data() + nNext, cache->blankedInputs.size() - nNext);
+        ss.write((const char*)cache->tail.data(), cache->tail.size());
+        ss << nHashType;
+        return ss.GetHash();
+    }
+
     // Serialize and hash
     CHashWriter ss(SER_GETHASH, 0);
     ss << txTmp << nHashType;
@@ -1158,7 +1224,20 @@ uint256 SignatureHash(const CScript& scriptCode, const CTransaction& txTo, unsig
 
 bool TransactionSignatureChecker::VerifySignature(const std::vector<unsigned char>& vchSig, const CPubKey& pubkey, const uint256& sighash) const
 {
-    return pubkey.Verify(sighash, vchSig);
+    // Signatures seen valid in the pool are not verified again in a block.
+    bc::hash_digest digest;
+    std::copy(sighash.begin(), sighash.end(), digest.begin());
+    const bc::data_slice key(pubkey.begin(), pubkey.end());
+
+    auto& cache = bc::signature_cache::instance();
+    if (cache.contains(digest, key, vchSig))
+        return true;
+
+    if (!pubkey.Verify(sighash, vchSig))
+        return false;
+
+    cache.store(digest, key, vchSig);
+    return true;
 }
 
 bool TransactionSignatureChecker::CheckSig(const vector<unsigned char>& vchSigIn, const vector<unsigned char>& vchPubKey, const CScript& scriptCode) const
@@ -1174,7 +1253,7 @@ bool TransactionSignatureChecker::CheckSig(const vector<unsigned char>& vchSigIn
     int nHashType = vchSig.back();
     vchSig.pop_back();
 
-    uint256 sighash = SignatureHash(scriptCode, *txTo, nIn, nHashType);
+    uint256 sighash = SignatureHash(scriptCode, *txTo, nIn, nHashType, cache);
 
     if (!VerifySignature(vchSig, pubkey, sighash))
         return false;
@@ -7,6 +7,7 @@
 #define BITCOIN_SCRIPT_INTERPRETER_H
 
 #include "script_error.h"
+#include "hash.h"
 #include "primitives/transaction.h"
 
 #include <vector>
@@ -91,7 +92,24 @@ enum
 
 bool CheckSignatureEncoding(const std::vector<unsigned char> &vchSig, unsigned int flags, ScriptError* serror);
 
-uint256 SignatureHash(const CScript &scriptCode, const CTransaction& txTo, unsigned int nIn, int nHashType);
+/**
+ * The parts of the SIGHASH_ALL serialization of a transaction that do not
+ * depend on the input being signed, computed once for all of its inputs.
+ */
+struct PrecomputedSignatureHash
+{
+    //! Hash state of the serialization that precedes each input.
+    std::vector<CHashWriter> inputPrefixes;
+    //! Serialization of every input with a blank script, and the offset of each.
+    std::vector<unsigned char> blankedInputs;
+    std::vector<size_t> blankedOffsets;
+    //! Serialization of the outputs and nLockTime.
+    std::vector<unsigned char> tail;
+
+    explicit PrecomputedSignatureHash(const CTransaction& txTo);
+};
+
+uint256 SignatureHash(const CScript &scriptCode, const CTransaction& txTo, unsigned int nIn, int nHashType, const PrecomputedSignatureHash* cache = NULL);
 
 class BaseSignatureChecker
 {
@@ -119,12 +137,13 @@ class TransactionSignatureChecker : public BaseSignatureChecker
 private:
     const CTransaction* txTo;
     unsigned int nIn;
+    const PrecomputedSignatureHash* cache;
 
 protected:
     virtual bool VerifySignature(const std::vector<unsigned char>& vchSig, const CPubKey& vchPubKey, const uint256& sighash) const;
 
 public:
-    TransactionSignatureChecker(const CTransaction* txToIn, unsigned int nInIn) : txTo(txToIn), nIn(nInIn) {}
+    TransactionSignatureChecker(const CTransaction* txToIn, unsigned int nInIn, const PrecomputedSignatureHash* cacheIn = NULL) : txTo(txToIn), nIn(nInIn), cache(cacheIn) {}
     bool CheckSig(const std::vector<unsigned char>& scriptSig, const std::vector<unsigned char>& vchPubKey, const CScript& scriptCode) const override;
     bool CheckLockTime(const CScriptNum& nLockTime) const override;
     bool CheckSequence(const CScriptNum& nSequence) const override;
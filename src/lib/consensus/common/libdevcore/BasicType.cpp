@@ -7,8 +7,12 @@
 #include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <atomic>
 #include <chrono>
+#include <cmath>
 #include <ctime>
+#include <thread>
+#include <vector>
 
 using namespace libbitcoin;
 
@@ -44,9 +48,56 @@ Result LightAllocation::compute(h256& _headerHash, Nonce& _nonce)
 }
 
 /*****************************/
-FullAllocation::FullAllocation(ethash_light_t _light, ethash_callback_t _cb)
+// Compute the DAG items in parallel, each thread taking an interleaved share
+// of the nodes. The first thread reports progress through the callback.
+static bool generate_parallel(void* _context, void* _mem, uint64_t _fullSize,
+    ethash_light_t _light, ethash_callback_t _cb)
 {
-    full = ethash_full_new(_light, _cb);
+    if (_fullSize % (sizeof(uint32_t) * MIX_WORDS) != 0 ||
+        (_fullSize % sizeof(node)) != 0)
+        return false;
+
+    unsigned const threads = *static_cast<unsigned*>(_context);
+    uint32_t const count = (uint32_t)(_fullSize / sizeof(node));
+    uint32_t const stride = 1024;
+    node* const nodes = static_cast<node*>(_mem);
+    std::atomic<uint32_t> next{0};
+    std::atomic<bool> stopped{false};
+
+    auto work = [&](bool report)
+    {
+        for (uint32_t begin = next.fetch_add(stride); begin < count && !stopped;
+            begin = next.fetch_add(stride))
+        {
+            if (report && _cb && _cb((unsigned)std::ceil(100.0 * begin / count)) != 0)
+            {
+                stopped = true;
+                return;
+            }
+
+            uint32_t const end = std::min(count, begin + stride);
+            for (uint32_t n = begin; n != end; ++n)
+                ethash_calculate_dag_item(&nodes[n], n, _light);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < threads; ++i)
+        workers.emplace_back(work, false);
+
+    work(true);
+
+    for (auto& worker: workers)
+        worker.join();
+
+    return !stopped;
+}
+
+FullAllocation::FullAllocation(ethash_light_t _light, ethash_callback_t _cb, unsigned _threads)
+{
+    _threads = std::max(_threads, 1u);
+    full = _threads == 1 ? ethash_full_new(_light, _cb) :
+        ethash_full_new_generator(_light, _cb, generate_parallel, &_threads);
     if (!full)
     {
         BOOST_THROW_EXCEPTION(ExternalFunctionFailure("ethash_full_new"));
@@ -3,7 +3,10 @@
 #include <chrono>
 #include <array>
 #include <thread>
+#include <limits>
+#include <mutex>
 #include <random>
+#include <vector>
 #include <boost/filesystem.hpp>
 #include <boost/throw_exception.hpp>
 #include <metaverse/macros_define.hpp>
@@ -31,8 +34,32 @@ using namespace std;
 MinerAux* libbitcoin::MinerAux::s_this = nullptr;
 #define LOG_MINER "etp_hash"
 
+// The next epoch's DAG is generated in the background this many blocks
+// before the seed changes.
+static const uint64_t pregeneration_window = ETHASH_EPOCH_LENGTH / 30;
+
+// The interval at which the search threads check the exit condition.
+static const auto exit_poll_interval = std::chrono::milliseconds(50);
+
+static unsigned hardware_threads()
+{
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+MinerAux::MinerAux()
+  : m_cancelNext(false), m_rate(0), m_threads(hardware_threads())
+{
+}
+
 MinerAux::~MinerAux()
 {
+    std::lock_guard<Mutex> lock(x_nextThread);
+    join_next_epoch();
+}
+
+void MinerAux::set_threads(unsigned _threads)
+{
+    get()->m_threads = _threads ? _threads : hardware_threads();
 }
 
 MinerAux* MinerAux::get()
@@ -59,35 +86,121 @@ static int dagCallbackShim(unsigned _p)
 }
 
 FullType MinerAux::get_full(h256& _seedHash)
+{
+    FullType ret = generate_full(_seedHash, dagCallbackShim);
+    DEV_GUARDED(get()->x_fulls)
+    get()->m_lastUsedFull = ret;
+    return ret;
+}
+
+FullType MinerAux::generate_full(h256& _seedHash, ethash_callback_t _callback)
 {
     FullType ret;
     auto l = get_light(_seedHash);
-    DEV_GUARDED(get()->x_fulls)
-    if ((ret = get()->m_fulls[_seedHash].lock()))
     {
-        get()->m_lastUsedFull = ret;
-        return ret;
+        std::unique_lock<Mutex> lock(get()->x_fulls);
+
+        // Wait for a generation of the same DAG in progress on another thread.
+        get()->m_fullsChanged.wait(lock, [&_seedHash]{
+            return get()->m_generating.count(_seedHash) == 0;
+        });
+
+        if ((ret = get()->m_fulls[_seedHash].lock()))
+            return ret;
+
+        get()->m_generating.insert(_seedHash);
     }
+
     //s_dagCallback = _f;
-    ret = make_shared<FullAllocation>(l->light, dagCallbackShim);
+    try {
+        ret = make_shared<FullAllocation>(l->light, _callback, get()->m_threads);
+    } catch (...) {
+        DEV_GUARDED(get()->x_fulls)
+        get()->m_generating.erase(_seedHash);
+        get()->m_fullsChanged.notify_all();
+        throw;
+    }
+
     DEV_GUARDED(get()->x_fulls)
-    get()->m_fulls[_seedHash] = get()->m_lastUsedFull = ret;
+    {
+        get()->m_fulls[_seedHash] = ret;
+        get()->m_generating.erase(_seedHash);
+    }
+    get()->m_fullsChanged.notify_all();
     return ret;
 }
 
+// Generate the DAG of the next epoch in the background, shortly before the
+// seed changes, so that mining does not stall at the epoch boundary.
+void MinerAux::prepare_next_epoch(const chain::header& header)
+{
+    const uint64_t remaining = ETHASH_EPOCH_LENGTH - header.number % ETHASH_EPOCH_LENGTH;
+    if (remaining > pregeneration_window)
+        return;
+
+    chain::header next(header);
+    next.number = header.number + remaining;
+    h256 seed = HeaderAux::seedHash(next);
+
+    DEV_GUARDED(get()->x_fulls)
+    {
+        if (get()->m_nextSeed == seed)
+            return;
+        get()->m_nextSeed = seed;
+    }
+
+    log::debug(LOG_MINER) << "start generate dag of next epoch @ height: " << next.number << '\n';
+
+    std::lock_guard<Mutex> lock(get()->x_nextThread);
+    get()->join_next_epoch();
+    get()->m_cancelNext = false;
+    get()->m_nextThread = std::thread([seed]() mutable {
+        try {
+            auto full = generate_full(seed, next_epoch_callback);
+            DEV_GUARDED(get()->x_fulls)
+            get()->m_nextFull = full;
+        } catch (...) {
+            log::warning(LOG_MINER) << "failed to generate dag of next epoch\n";
+        }
+    });
+}
+
+// Stops the background generation at its next progress report.
+int MinerAux::next_epoch_callback(unsigned _progress)
+{
+    return get()->m_cancelNext ? 1 : 0;
+}
+
+// Callers hold x_nextThread.
+void MinerAux::join_next_epoch()
+{
+    if (!m_nextThread.joinable())
+        return;
+
+    m_cancelNext = true;
+    m_nextThread.join();
+}
+
+void MinerAux::stop()
+{
+    std::lock_guard<Mutex> lock(get()->x_nextThread);
+    get()->join_next_epoch();
+
+    // Let the next start generate the DAG again if it was cancelled.
+    DEV_GUARDED(get()->x_fulls)
+    get()->m_nextSeed = h256();
+}
+
 bool MinerAux::search(libbitcoin::chain::header& header, std::function<bool (void)> is_exit)
 {
     auto tid = std::this_thread::get_id();
     static std::mt19937_64 s_eng((utcTime() + std::hash<decltype(tid)>()(tid)));
-    uint64_t tryNonce = s_eng();
-    ethash_return_value ethashReturn;
     FullType dag;
     h256 seed = HeaderAux::seedHash(header);
     h256 header_hash = HeaderAux::hashHead(header);
     h256 boundary = HeaderAux::boundary(header);
     std::chrono::steady_clock::time_point timeStart;
     uint64_t ms;
-    uint64_t hashCount = 1;
 
     // quick check and exit
     if (is_exit() == true) {
@@ -103,30 +216,82 @@ bool MinerAux::search(libbitcoin::chain::header& header, std::function<bool (voi
         }
     }
 
-    log::debug(LOG_MINER) << "Start miner @ height:  "<< header.number << '\n';
+    prepare_next_epoch(header);
 
-    timeStart = std::chrono::steady_clock::now();
-    for (; ; tryNonce++, hashCount++) {
-        ethashReturn = ethash_full_compute(dag->full, *(ethash_h256_t*)header_hash.data(), tryNonce);
-        h256 value = h256((uint8_t*)&ethashReturn.result, h256::ConstructFromPointer);
-        h256 mixhash =h256((uint8_t*)&ethashReturn.mix_hash, h256::ConstructFromPointer);
-        if (value <= boundary ) {
-            MinerAux::setNonce(header, (u64)tryNonce);
-            MinerAux::setMixHash(header, mixhash);
-            log::debug(LOG_MINER) << "find slolution! block height: "<< header.number << '\n';
-            break;
+    // Each thread searches its own range of the nonce space.
+    const unsigned threads = get()->m_threads;
+    const uint64_t start = s_eng();
+    const uint64_t range = std::numeric_limits<uint64_t>::max() / threads;
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> hashCount{0};
+    std::mutex solvedMutex;
+    std::condition_variable solvedChanged;
+    bool solved = false;
+    uint64_t solvedNonce = 0;
+    h256 solvedMixHash;
+    bool success = false;
+
+    auto work = [&](uint64_t tryNonce) {
+        uint64_t count = 0;
+        for (; !stop.load(std::memory_order_relaxed); tryNonce++) {
+            auto ethashReturn = ethash_full_compute(dag->full, *(ethash_h256_t*)header_hash.data(), tryNonce);
+            ++count;
+            h256 value = h256((uint8_t*)&ethashReturn.result, h256::ConstructFromPointer);
+            if (value <= boundary ) {
+                std::lock_guard<std::mutex> lock(solvedMutex);
+                if (!solved) {
+                    solved = true;
+                    solvedNonce = tryNonce;
+                    solvedMixHash = h256((uint8_t*)&ethashReturn.mix_hash, h256::ConstructFromPointer);
+                    success = ethashReturn.success;
+                }
+                stop = true;
+                solvedChanged.notify_all();
+                break;
+            }
         }
+        hashCount += count;
+    };
 
-        if (is_exit() == true) {
-            return false;
+    log::debug(LOG_MINER) << "Start miner @ height:  "<< header.number << " with " << threads << " threads\n";
+
+    timeStart = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < threads; ++i) {
+        workers.emplace_back(work, start + i * range);
+    }
+
+    // Poll the exit condition until a thread finds a solution.
+    {
+        std::unique_lock<std::mutex> lock(solvedMutex);
+        while (!solvedChanged.wait_for(lock, exit_poll_interval, [&solved]{ return solved; })) {
+            lock.unlock();
+            const bool exit = is_exit();
+            lock.lock();
+            if (exit) {
+                break;
+            }
         }
     }
 
+    stop = true;
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
     ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - timeStart).count();
     ms = ms? ms : 1;
     get()->m_rate = hashCount * 1000 / ms;
 
-    return ethashReturn.success;
+    if (!solved) {
+        return false;
+    }
+
+    MinerAux::setNonce(header, (u64)solvedNonce);
+    MinerAux::setMixHash(header, solvedMixHash);
+    log::debug(LOG_MINER) << "find slolution! block height: "<< header.number << '\n';
+    return success;
 }
 
 bool MinerAux::verify_work(const libbitcoin::chain::header& header, const libbitcoin::chain::header::ptr parent)
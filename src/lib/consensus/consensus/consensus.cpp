@@ -181,37 +181,75 @@ unsigned int verify_flags_to_script_flags(unsigned int flags)
     return script_flags;
 }
 
-// This function is published. The implementation exposes no satoshi internals.
-verify_result_type verify_script(const unsigned char* transaction,
-    size_t transaction_size, const unsigned char* prevout_script,
-    size_t prevout_script_size, unsigned int tx_input_index,
-    unsigned int flags)
+struct transaction_context::implementation
+{
+    implementation(const unsigned char* transaction, size_t transaction_size)
+      : result(verify_result_eval_true), size_valid(false)
+    {
+        try
+        {
+            TxInputStream stream(transaction, transaction_size);
+            Unserialize(stream, tx, SER_NETWORK, PROTOCOL_VERSION);
+        }
+        catch (const std::exception& e)
+        {
+            result = verify_result_tx_invalid;
+            return;
+        }
+
+        size_valid = (tx.GetSerializeSize(SER_NETWORK, PROTOCOL_VERSION) ==
+            transaction_size);
+
+        if (size_valid)
+            sighash.reset(new PrecomputedSignatureHash(tx));
+    }
+
+    CTransaction tx;
+    std::unique_ptr<PrecomputedSignatureHash> sighash;
+    verify_result_type result;
+    bool size_valid;
+};
+
+transaction_context::transaction_context(const unsigned char* transaction,
+    size_t transaction_size)
 {
     if (transaction_size > 0 && transaction == NULL)
         throw std::invalid_argument("transaction");
 
+    impl_.reset(new implementation(transaction, transaction_size));
+}
+
+transaction_context::~transaction_context()
+{
+}
+
+const transaction_context::implementation& transaction_context::impl() const
+{
+    return *impl_;
+}
+
+// This function is published. The implementation exposes no satoshi internals.
+verify_result_type verify_script(const transaction_context& context,
+    const unsigned char* prevout_script, size_t prevout_script_size,
+    unsigned int tx_input_index, unsigned int flags)
+{
     if (prevout_script_size > 0 && prevout_script == NULL)
         throw std::invalid_argument("prevout_script");
 
-    CTransaction tx;
-    try
-    {
-        TxInputStream stream(transaction, transaction_size);
-        Unserialize(stream, tx, SER_NETWORK, PROTOCOL_VERSION);
-    }
-    catch (const std::exception& e)
-    {
-        return verify_result_tx_invalid;
-    }
+    const auto& impl = context.impl();
+    if (impl.result != verify_result_eval_true)
+        return impl.result;
 
+    const auto& tx = impl.tx;
     if (tx_input_index >= tx.vin.size())
         return verify_result_tx_input_invalid;
 
-    if (tx.GetSerializeSize(SER_NETWORK, PROTOCOL_VERSION) != transaction_size)
+    if (!impl.size_valid)
         return verify_result_tx_size_invalid;
 
     ScriptError_t error;
-    TransactionSignatureChecker checker(&tx, tx_input_index);
+    TransactionSignatureChecker checker(&tx, tx_input_index,
+        impl.sighash.get());
     const unsigned int script_flags = verify_flags_to_script_flags(flags);
     CScript output_script(prevout_script, prevout_script + prevout_script_size);
     const CScript& input_script = tx.vin[tx_input_index].scriptSig;
@@ -223,5 +261,16 @@ verify_result_type verify_script(const unsigned char* transaction,
     return script_error_to_verify_result(error);
 }
 
+// This function is published. The implementation exposes no satoshi internals.
+verify_result_type verify_script(const unsigned char* transaction,
+    size_t transaction_size, const unsigned char* prevout_script,
+    size_t prevout_script_size, unsigned int tx_input_index,
+    unsigned int flags)
+{
+    const transaction_context context(transaction, transaction_size);
+    return verify_script(context, prevout_script, prevout_script_size,
+        tx_input_index, flags);
+}
+
 } // namespace consensus
 } // namespace libbitcoin
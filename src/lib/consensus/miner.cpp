@@ -22,6 +22,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <set>
 #include <system_error>
 #include <chrono>
 #include <ctime>
@@ -47,27 +48,6 @@ namespace consensus {
 
 static BC_CONSTEXPR uint32_t min_tx_fee     = 10000;
 
-// tuples: (priority, fee_per_kb, fee, transaction_ptr)
-typedef boost::tuple<double, double, uint64_t, miner::transaction_ptr> transaction_priority;
-
-namespace {
-// fee : per kb
-bool sort_by_fee_per_kb(const transaction_priority& a, const transaction_priority& b)
-{
-    if (a.get<1>() == b.get<1>())
-        return a.get<0>() < b.get<0>();
-    return a.get<1>() < b.get<1>();
-};
-
-// priority : coin age
-bool sort_by_priority(const transaction_priority& a, const transaction_priority& b)
-{
-    if (a.get<0>() == b.get<0>())
-        return a.get<1>() < b.get<1>();
-    return a.get<0>() < b.get<0>();
-};
-} // end of anonymous namespace
-
 std::string timestamp_to_string(uint32_t timestamp)
 {
     typedef std::chrono::system_clock wall_clock;
@@ -157,18 +137,24 @@ bool miner::get_input_etp(const chain::transaction& tx, const std::vector<transa
 }
 
 bool miner::get_transaction(
-    uint64_t last_height,
+    uint64_t last_height, size_t max_size,
     std::vector<transaction_ptr>& transactions,
-    previous_out_map_t& previous_out_map, tx_fee_map_t& tx_fee_map) const
+    previous_out_map_t& previous_out_map, tx_fee_map_t& tx_fee_map,
+    tx_rate_map_t& tx_rate_map) const
 {
+    typedef blockchain::transaction_pool::rated_transaction rated_transaction;
+
     boost::mutex mutex;
     mutex.lock();
-    auto f = [&transactions, &mutex](const code&, const std::vector<transaction_ptr>& transactions_) -> void
+    auto f = [&transactions, &tx_rate_map, &mutex](const code&, const std::vector<rated_transaction>& transactions_) -> void
     {
-        transactions = transactions_;
+        for (const auto& entry : transactions_) {
+            transactions.push_back(entry.first);
+            tx_rate_map[entry.first->hash()] = entry.second;
+        }
         mutex.unlock();
     };
-    node_.pool().fetch(f);
+    node_.pool().fetch_template(max_size, f);
 
     boost::unique_lock<boost::mutex> lock(mutex);
 
@@ -509,17 +495,6 @@ uint64_t miner::calculate_mst_subsidy_dpos(
     return result;
 }
 
-struct transaction_dependent {
-    std::shared_ptr<hash_digest> hash;
-    unsigned short dpendens;
-    bool is_need_process;
-    transaction_priority transaction;
-
-    transaction_dependent() : dpendens(0), is_need_process(false) {}
-    transaction_dependent(const hash_digest& _hash, unsigned short _dpendens, bool _is_need_process)
-        : dpendens(_dpendens), is_need_process(_is_need_process) { hash = std::make_shared<hash_digest>(_hash);}
-};
-
 uint32_t miner::get_tx_sign_length(transaction_ptr tx)
 {
     return tx->legacy_sigops_count();
@@ -530,105 +505,57 @@ bool miner::get_block_transactions(
     std::vector<transaction_ptr>& txs, std::vector<transaction_ptr>& reward_txs,
     uint64_t& total_fee, uint32_t& total_tx_sig_length)
 {
-    blockchain::block_chain_impl& block_chain = node_.chain_impl();
     uint64_t current_height = last_height + 1;
 
-    std::vector<transaction_ptr> transactions;
-    std::vector<transaction_priority> transaction_prioritys;
-    std::map<hash_digest, transaction_dependent> transaction_dependents;
-    previous_out_map_t previous_out_map;
-    tx_fee_map_t tx_fee_map;
-
-    if (!witness::is_begin_of_epoch(current_height)) {
-        get_transaction(last_height, transactions, previous_out_map, tx_fee_map);
-    }
-
     // Largest block you're willing to create:
     uint32_t block_max_size = blockchain::max_block_size / 2;
     // Limit to betweeen 1K and max_block_size - 1K for sanity:
     block_max_size = std::max<uint32_t>(1000, std::min<uint32_t>((blockchain::max_block_size - 1000), block_max_size));
 
-    // How much of the block should be dedicated to high-priority transactions,
-    // included regardless of the fees they pay
-    uint32_t block_priority_size = 27000;
-    block_priority_size = std::min(block_max_size, block_priority_size);
-
-    // Minimum block size you want to create; block will be filled with free transactions
-    // until there are no more or the block reaches this size:
-    uint32_t block_min_size = 0;
-    block_min_size = std::min(block_max_size, block_min_size);
-
-    uint32_t block_size = 0;
-    for (auto tx : transactions)
-    {
-        auto tx_hash = tx->hash();
-        double priority = 0;
-        for (const auto& input : tx->inputs)
-        {
-            auto prev_pair = previous_out_map[input.previous_output];
-            uint64_t prev_height = prev_pair.first;
-            const auto& prev_output = prev_pair.second;
-
-            if (prev_height != max_uint64) {
-                uint64_t input_value = prev_output.value;
-                priority += (double)input_value * (last_height - prev_height + 1);
-            }
-            else {
-                transaction_dependents[input.previous_output.hash].hash = std::make_shared<hash_digest>(tx_hash);
-                transaction_dependents[tx_hash].dpendens++;
-            }
-        }
-
-        uint64_t serialized_size = tx->serialized_size(0);
+    // Packages paying below the minimum fee rate only fill the block up to
+    // this size, they are walked last:
+    const uint32_t low_fee_area = std::min<uint32_t>(block_max_size, 27000);
 
-        // Priority is sum(valuein * age) / txsize
-        priority /= serialized_size;
+    // The pool keeps its transactions ordered by ancestor fee rate, so only
+    // the top of it is fetched, with slack for transactions dropped below.
+    std::vector<transaction_ptr> transactions;
+    previous_out_map_t previous_out_map;
+    tx_fee_map_t tx_fee_map;
+    tx_rate_map_t tx_rate_map;
 
-        // This is a more accurate fee-per-kilobyte than is used by the client code, because the
-        // client code rounds up the size to the nearest 1K. That's good, because it gives an
-        // incentive to create smaller transactions.
-        auto tx_fee = tx_fee_map[tx_hash];
-        double fee_per_kb = double(tx_fee) / (double(serialized_size) / 1000.0);
-        transaction_prioritys.push_back(transaction_priority(priority, fee_per_kb, tx_fee, tx));
+    if (!witness::is_begin_of_epoch(current_height)) {
+        get_transaction(last_height, 2 * block_max_size, transactions, previous_out_map, tx_fee_map, tx_rate_map);
     }
 
-    auto sort_func = sort_by_fee_per_kb;
-    bool is_resort = false;
-    make_heap(transaction_prioritys.begin(), transaction_prioritys.end(), sort_func);
+    // Transactions arrive after their unconfirmed parents, a transaction is
+    // skipped if any of its unconfirmed parents was skipped.
+    std::set<hash_digest> included;
 
-    transaction_priority *next_transaction_priority = NULL;
-    while (!transaction_prioritys.empty() || next_transaction_priority)
+    uint32_t block_size = 0;
+    for (auto ptx : transactions)
     {
-        transaction_priority temp_priority;
-        if (next_transaction_priority) {
-            temp_priority = *next_transaction_priority;
-        } else {
-            temp_priority = transaction_prioritys.front();
-        }
-
-        double priority = temp_priority.get<0>();
-        double fee_per_kb = temp_priority.get<1>();
-        uint64_t fee = temp_priority.get<2>();
-        transaction_ptr ptx = temp_priority.get<3>();
-
-        if (next_transaction_priority) {
-            next_transaction_priority = NULL;
-        }
-        else {
-            pop_heap(transaction_prioritys.begin(), transaction_prioritys.end(), sort_func);
-            transaction_prioritys.pop_back();
+        hash_digest h = ptx->hash();
+        bool is_parent_included = true;
+        for (const auto& input : ptx->inputs) {
+            const auto& prev_pair = previous_out_map[input.previous_output];
+            if (prev_pair.first == max_uint64 && !included.count(input.previous_output.hash)) {
+                is_parent_included = false;
+                break;
+            }
         }
 
-        hash_digest h = ptx->hash();
-        if (transaction_dependents[h].dpendens != 0) {
-            transaction_dependents[h].transaction = temp_priority;
-            transaction_dependents[h].is_need_process = true;
+        if (!is_parent_included)
             continue;
-        }
+
+        uint64_t fee = tx_fee_map[h];
 
         // Size limits
         uint64_t serialized_size = ptx->serialized_size(1);
 
+        // The fee rate is that of the package, a parent is paid for by the
+        // children that pulled it into the template.
+        uint64_t fee_per_kb = tx_rate_map[h];
+
         // add coinage reward coinbase
         std::vector<transaction_ptr> coinage_reward_coinbases;
         if (current_height < pos_enabled_height) {
@@ -659,19 +586,9 @@ bool miner::get_block_transactions(
         if (total_tx_sig_length + tx_sig_length >= blockchain::max_block_script_sigops)
             continue;
 
-        // Skip free transactions if we're past the minimum block size:
-        if (is_resort && (fee_per_kb < min_tx_fee_per_kb) && (block_size + serialized_size >= block_min_size))
-            break;
-
-        // Prioritize by fee once past the priority size or we run out of high-priority
-        // transactions:
-        if (is_resort == false &&
-                ((block_size + serialized_size >= block_priority_size) || (priority < coin_price() * 144 / 250)))
-        {
-            sort_func = sort_by_priority;
-            is_resort = true;
-            make_heap(transaction_prioritys.begin(), transaction_prioritys.end(), sort_func);
-        }
+        // Skip low fee rate packages past the area open to them:
+        if ((fee_per_kb < min_tx_fee_per_kb) && (block_size + serialized_size >= low_fee_area))
+            continue;
 
         uint64_t c;
         if (!miner::script_hash_signature_operations_count(c, ptx->inputs, transactions)
@@ -681,6 +598,7 @@ bool miner::get_block_transactions(
 
         // update txs
         txs.push_back(ptx);
+        included.insert(h);
         for (auto i : coinage_reward_coinbases) {
             reward_txs.push_back(i);
         }
@@ -689,13 +607,6 @@ bool miner::get_block_transactions(
         block_size += serialized_size;
         total_tx_sig_length += tx_sig_length;
         total_fee += fee;
-
-        if (transaction_dependents[h].hash) {
-            transaction_dependent &d = transaction_dependents[*transaction_dependents[h].hash];
-            if (--d.dpendens == 0 && d.is_need_process) {
-                next_transaction_priority = &d.transaction;
-            }
-        }
     }
 
     return true;
@@ -1402,6 +1313,7 @@ bool miner::stop()
         thread_.reset();
     }
 
+    MinerAux::stop();
     state_ = state::init_;
     new_block_number_ = 0;
     new_block_limit_ = 0;
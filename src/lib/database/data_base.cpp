@@ -22,13 +22,19 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
 #include <memory>
 #include <stdexcept>
 #include <algorithm>
+#include <thread>
+#include <vector>
 #include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/bitcoin/utility/path.hpp>
 #include <metaverse/bitcoin/config/base16.hpp>  // used by db_metadata and push_attachment
+#include <metaverse/database/address_key.hpp>
 #include <metaverse/database/memory/memory_map.hpp>
 #include <metaverse/database/settings.hpp>
 #include <metaverse/database/version.hpp>
@@ -59,6 +65,13 @@ bool data_base::touch_file(const path& file_path)
     return true;
 }
 
+bool data_base::move_file(const path& from, const path& to)
+{
+    boost::system::error_code ec;
+    boost::filesystem::rename(from, to, ec);
+    return !ec;
+}
+
 bool data_base::initialize(const path& prefix, const chain::block& genesis)
 {
     // Create paths.
@@ -171,6 +184,191 @@ bool data_base::initialize_witness_profiles(const path& prefix)
     return instance.stop();
 }
 
+bool data_base::initialize_address_utxos(const path& prefix,
+    size_t history_height)
+{
+    const store paths(prefix);
+    if (paths.address_utxos_exist())
+        return true;
+
+    // Replaying the chain requires the current block and transaction tables.
+    if (!initialize_growable_tables(prefix))
+        return false;
+
+    // Build under temporary names so that an interrupted replay is started
+    // over rather than leaving a partial index in place.
+    store building(prefix);
+    building.address_utxos_lookup += ".building";
+    building.address_utxos_buckets += ".building";
+    building.address_utxos_rows += ".building";
+    building.address_utxos_rows_buckets += ".building";
+    if (!building.touch_address_utxos())
+        return false;
+
+    {
+        data_base instance(building, history_height, 0);
+        if (!instance.create_address_utxos())
+            return false;
+
+        // The index is derived data, replay the existing chain to populate it.
+        if (!instance.blocks.start() || !instance.transactions.start())
+            return false;
+
+        instance.rebuild_address_utxos();
+        if (!instance.stop())
+            return false;
+    }
+
+    // The lookup table is moved last, its presence marks completion.
+    boost::system::error_code ec;
+    boost::filesystem::rename(building.address_utxos_rows_buckets,
+        paths.address_utxos_rows_buckets, ec);
+    if (!ec)
+        boost::filesystem::rename(building.address_utxos_rows,
+            paths.address_utxos_rows, ec);
+    if (!ec)
+        boost::filesystem::rename(building.address_utxos_buckets,
+            paths.address_utxos_buckets, ec);
+    if (!ec)
+        boost::filesystem::rename(building.address_utxos_lookup,
+            paths.address_utxos_lookup, ec);
+    if (ec)
+        return false;
+
+    log::info(LOG_DATABASE)
+        << "Upgrading address utxo table is complete.";
+
+    return true;
+}
+
+bool data_base::initialize_growable_tables(const path& prefix)
+{
+    const store paths(prefix);
+    if (paths.growable_tables_exist())
+        return true;
+    if (!paths.touch_growable_tables())
+        return false;
+
+    // The existing buckets are kept, only the entries must be counted.
+    data_base instance(prefix, 0, 0);
+    if (!instance.blocks.convert() ||
+        !instance.spends.convert() ||
+        !instance.transactions.convert())
+        return false;
+
+    log::info(LOG_DATABASE)
+        << "Upgrading block, spend and transaction tables is complete.";
+
+    return instance.stop();
+}
+
+bool data_base::initialize_history(const path& prefix,
+    size_t history_height)
+{
+    const store paths(prefix);
+    if (paths.history_exist())
+        return true;
+
+    // Build under temporary names so that an interrupted replay is started
+    // over rather than leaving a partial history in place.
+    store building(prefix);
+    building.history_lookup += ".building";
+    building.history_pages += ".building";
+    if (!building.touch_history())
+        return false;
+
+    {
+        data_base instance(building, history_height, 0);
+        if (!instance.create_history())
+            return false;
+
+        // The rows are derived data, replay the existing chain to populate them.
+        if (!instance.blocks.start() || !instance.transactions.start())
+            return false;
+
+        instance.rebuild_history();
+        if (!instance.stop())
+            return false;
+    }
+
+    // The lookup table is moved last, its presence marks completion.
+    if (!move_file(building.history_pages, paths.history_pages) ||
+        !move_file(building.history_lookup, paths.history_lookup))
+        return false;
+
+    // Remove the files of the previous (linked row) history format.
+    boost::system::error_code ec;
+    boost::filesystem::remove(prefix / "history_table", ec);
+    boost::filesystem::remove(prefix / "history_rows", ec);
+
+    log::info(LOG_DATABASE)
+        << "Upgrading history table is complete.";
+
+    return true;
+}
+
+bool data_base::initialize_address_keys(const path& prefix,
+    size_t history_height)
+{
+    const store paths(prefix);
+    if (paths.address_keys_exist())
+        return true;
+
+    // Replaying the chain requires the current block and transaction tables.
+    if (!initialize_growable_tables(prefix))
+        return false;
+
+    // Build under temporary names so that an interrupted replay is started
+    // over rather than leaving partial rows in place.
+    store building(prefix);
+    building.address_assets_lookup += ".building";
+    building.address_assets_rows += ".building";
+    building.address_dids_lookup += ".building";
+    building.address_dids_rows += ".building";
+    building.address_mits_lookup += ".building";
+    building.address_mits_rows += ".building";
+    if (!building.touch_address_keys())
+        return false;
+
+    {
+        data_base instance(building, history_height, 0);
+        if (!instance.create_address_keys())
+            return false;
+
+        // The rows are derived data, replay the existing chain to rekey them.
+        if (!instance.blocks.start() || !instance.transactions.start())
+            return false;
+
+        instance.rebuild_address_keys();
+        if (!instance.stop())
+            return false;
+    }
+
+    // The address asset lookup is moved last, its presence marks completion.
+    if (!move_file(building.address_mits_rows, paths.address_mits_rows) ||
+        !move_file(building.address_mits_lookup, paths.address_mits_lookup) ||
+        !move_file(building.address_dids_rows, paths.address_dids_rows) ||
+        !move_file(building.address_dids_lookup, paths.address_dids_lookup) ||
+        !move_file(building.address_assets_rows, paths.address_assets_rows) ||
+        !move_file(building.address_assets_lookup,
+            paths.address_assets_lookup))
+        return false;
+
+    // Remove the files keyed by the hash of the encoded address.
+    boost::system::error_code ec;
+    boost::filesystem::remove(prefix / "address_asset_table", ec);
+    boost::filesystem::remove(prefix / "address_asset_row", ec);
+    boost::filesystem::remove(prefix / "address_did_table", ec);
+    boost::filesystem::remove(prefix / "address_did_row", ec);
+    boost::filesystem::remove(prefix / "address_mit_table", ec);
+    boost::filesystem::remove(prefix / "address_mit_row", ec);
+
+    log::info(LOG_DATABASE)
+        << "Upgrading address asset, did and mit tables is complete.";
+
+    return true;
+}
+
 bool data_base::upgrade_version_63(const path& prefix)
 {
     auto metadata_path = prefix / db_metadata::file_name;
@@ -243,6 +441,60 @@ bool data_base::upgrade_version_64(const path& prefix)
     return true;
 }
 
+bool data_base::upgrade_version(const path& prefix, uint32_t version,
+    size_t history_height)
+{
+    auto metadata_path = prefix / db_metadata::file_name;
+    if (!boost::filesystem::exists(metadata_path))
+        return false;
+
+    data_base::db_metadata metadata;
+    data_base::read_metadata(metadata_path, metadata);
+    if (metadata.version_.empty()) {
+        return false; // no version before, initialize all instead of upgrade.
+    }
+
+    bool upgraded;
+    std::string tables;
+    switch (version)
+    {
+        case 65:
+            upgraded = initialize_address_utxos(prefix, history_height);
+            tables = "address utxo database";
+            break;
+        case 66:
+            upgraded = initialize_growable_tables(prefix);
+            tables = "block, spend and transaction databases";
+            break;
+        case 67:
+            upgraded = initialize_history(prefix, history_height);
+            tables = "history database";
+            break;
+        case 68:
+            upgraded = initialize_address_keys(prefix, history_height);
+            tables = "address asset, did and mit databases";
+            break;
+        default:
+            log::error(LOG_DATABASE)
+                << "No upgrade to database version " << version << ".";
+            return false;
+    }
+
+    if (!upgraded) {
+        log::error(LOG_DATABASE)
+            << "Failed to upgrade " << tables << ".";
+        return false;
+    }
+
+    if (metadata.version_ != db_metadata::current_version) {
+        // write new db version to metadata
+        metadata = db_metadata(db_metadata::current_version);
+        data_base::write_metadata(metadata_path, metadata);
+    }
+
+    return true;
+}
+
 void data_base::set_admin(const std::string& name, const std::string& passwd)
 {
     accounts.set_admin(name, passwd);
@@ -254,8 +506,7 @@ void data_base::set_blackhole_did()
     const std::string& did_address = wallet::payment_address::blackhole_address;
     did_detail diddetail(did_symbol, did_address);
 
-    data_chunk data(did_address.begin(), did_address.end());
-    short_hash hash = ripemd160_hash(data);
+    const auto hash = to_address_key(did_address);
 
     output_point outpoint = { null_hash, max_uint32 };
     uint32_t output_height = max_uint32;
@@ -269,7 +520,7 @@ data_base::store::store(const path& prefix)
 {
     // Hash-based lookup (hash tables).
     blocks_lookup = prefix / "block_table";
-    history_lookup = prefix / "history_table";
+    history_lookup = prefix / "history_page_table";
     spends_lookup = prefix / "spend_table";
     transactions_lookup = prefix / "transaction_table";
     /* begin database for account, asset, address_asset relationship */
@@ -277,28 +528,37 @@ data_base::store::store(const path& prefix)
     assets_lookup = prefix / "asset_table";  // for blockchain assets
     certs_lookup = prefix / "cert_table";   // for blockchain certs
     witness_certs_lookup = prefix / "witness_cert_table";   // for blockchain witness certs
-    address_assets_lookup = prefix / "address_asset_table"; // for blockchain
-    address_assets_rows = prefix / "address_asset_row"; // for blockchain
+    address_assets_lookup = prefix / "address_asset_key_table"; // for blockchain
+    address_assets_rows = prefix / "address_asset_key_row"; // for blockchain
     account_assets_lookup = prefix / "account_asset_table";
     account_assets_rows = prefix / "account_asset_row";
     dids_lookup = prefix / "did_table";
-    address_dids_lookup = prefix / "address_did_table"; // for blockchain
-    address_dids_rows = prefix / "address_did_row"; // for blockchain
+    address_dids_lookup = prefix / "address_did_key_table"; // for blockchain
+    address_dids_rows = prefix / "address_did_key_row"; // for blockchain
     account_addresses_lookup = prefix / "account_address_table";
     account_addresses_rows = prefix / "account_address_rows";
     /* end database for account, asset, address_asset relationship */
     mits_lookup = prefix / "mit_table";
-    address_mits_lookup = prefix / "address_mit_table"; // for blockchain
-    address_mits_rows = prefix / "address_mit_row"; // for blockchain
+    address_mits_lookup = prefix / "address_mit_key_table"; // for blockchain
+    address_mits_rows = prefix / "address_mit_key_row"; // for blockchain
     mit_history_lookup = prefix / "mit_history_table"; // for blockchain
     mit_history_rows = prefix / "mit_history_row"; // for blockchain
     witness_profiles_lookup = prefix / "witness_profile_table";   // for blockchain witness profiles
+    address_utxos_lookup = prefix / "address_utxo_table";
+    address_utxos_rows = prefix / "address_utxo_rows";
+
+    // Buckets added to hash tables as they grow.
+    blocks_buckets = prefix / "block_table_buckets";
+    spends_buckets = prefix / "spend_table_buckets";
+    transactions_buckets = prefix / "transaction_table_buckets";
+    address_utxos_buckets = prefix / "address_utxo_table_buckets";
+    address_utxos_rows_buckets = prefix / "address_utxo_rows_buckets";
 
     // Height-based (reverse) lookup.
     blocks_index = prefix / "block_index";
 
     // One (address) to many (rows).
-    history_rows = prefix / "history_rows";
+    history_pages = prefix / "history_pages";
     stealth_rows = prefix / "stealth_rows";
 
     // Exclusive database access reserved by this process.
@@ -310,12 +570,15 @@ bool data_base::store::touch_all() const
     // Return the result of the database file create.
     return
         touch_file(blocks_lookup) &&
+        touch_file(blocks_buckets) &&
         touch_file(blocks_index) &&
         touch_file(history_lookup) &&
-        touch_file(history_rows) &&
+        touch_file(history_pages) &&
         touch_file(stealth_rows) &&
         touch_file(spends_lookup) &&
+        touch_file(spends_buckets) &&
         touch_file(transactions_lookup) &&
+        touch_file(transactions_buckets) &&
         /* begin database for account, asset, address_asset relationship */
         touch_file(accounts_lookup) &&
         touch_file(assets_lookup) &&
@@ -336,7 +599,11 @@ bool data_base::store::touch_all() const
         touch_file(address_mits_rows) &&
         touch_file(mit_history_lookup) &&
         touch_file(mit_history_rows) &&
-        touch_file(witness_profiles_lookup);
+        touch_file(witness_profiles_lookup) &&
+        touch_file(address_utxos_lookup) &&
+        touch_file(address_utxos_buckets) &&
+        touch_file(address_utxos_rows) &&
+        touch_file(address_utxos_rows_buckets);
 }
 
 bool data_base::store::dids_exist() const
@@ -405,6 +672,68 @@ bool data_base::store::touch_witness_profiles() const
     return touch_file(witness_profiles_lookup);
 }
 
+// The lookup table is moved into place last by the upgrade.
+bool data_base::store::address_utxos_exist() const
+{
+    return boost::filesystem::exists(address_utxos_lookup);
+}
+
+bool data_base::store::touch_address_utxos() const
+{
+    return
+        touch_file(address_utxos_lookup) &&
+        touch_file(address_utxos_buckets) &&
+        touch_file(address_utxos_rows) &&
+        touch_file(address_utxos_rows_buckets);
+}
+
+// The lookup table is moved into place last by the upgrade.
+bool data_base::store::history_exist() const
+{
+    return boost::filesystem::exists(history_lookup);
+}
+
+bool data_base::store::touch_history() const
+{
+    return
+        touch_file(history_lookup) &&
+        touch_file(history_pages);
+}
+
+// The asset rows are only created with the database or by this upgrade,
+// which moves the address asset lookup table into place last.
+bool data_base::store::address_keys_exist() const
+{
+    return boost::filesystem::exists(address_assets_lookup);
+}
+
+bool data_base::store::touch_address_keys() const
+{
+    return
+        touch_file(address_assets_lookup) &&
+        touch_file(address_assets_rows) &&
+        touch_file(address_dids_lookup) &&
+        touch_file(address_dids_rows) &&
+        touch_file(address_mits_lookup) &&
+        touch_file(address_mits_rows);
+}
+
+bool data_base::store::growable_tables_exist() const
+{
+    return
+        boost::filesystem::exists(blocks_buckets) ||
+        boost::filesystem::exists(spends_buckets) ||
+        boost::filesystem::exists(transactions_buckets);
+}
+
+bool data_base::store::touch_growable_tables() const
+{
+    return
+        touch_file(blocks_buckets) &&
+        touch_file(spends_buckets) &&
+        touch_file(transactions_buckets);
+}
+
 data_base::db_metadata::db_metadata():version_("")
 {
 }
@@ -547,11 +876,16 @@ data_base::data_base(const store& paths, size_t history_height,
     stealth_height_(stealth_height),
     sequential_lock_(0),
     mutex_(std::make_shared<shared_mutex>()),
-    blocks(paths.blocks_lookup, paths.blocks_index, mutex_),
-    history(paths.history_lookup, paths.history_rows, mutex_),
+    address_rows_only_(false),
+    blocks(paths.blocks_lookup, paths.blocks_buckets, paths.blocks_index,
+        mutex_),
+    history(paths.history_lookup, paths.history_pages, mutex_),
+    address_utxos(paths.address_utxos_lookup, paths.address_utxos_buckets,
+        paths.address_utxos_rows, paths.address_utxos_rows_buckets, mutex_),
     stealth(paths.stealth_rows, mutex_),
-    spends(paths.spends_lookup, mutex_),
-    transactions(paths.transactions_lookup, mutex_),
+    spends(paths.spends_lookup, paths.spends_buckets, mutex_),
+    transactions(paths.transactions_lookup, paths.transactions_buckets,
+        mutex_),
     /* begin database for account, asset, address_asset, did relationship */
     accounts(paths.accounts_lookup, mutex_),
     assets(paths.assets_lookup, mutex_),
@@ -628,7 +962,8 @@ bool data_base::create()
         mits.create() &&
         address_mits.create() &&
         mit_history.create() &&
-        witness_profiles.create()
+        witness_profiles.create() &&
+        address_utxos.create()
         ;
 }
 
@@ -665,6 +1000,26 @@ bool data_base::create_witness_profiles()
         witness_profiles.create();
 }
 
+bool data_base::create_address_utxos()
+{
+    return
+        address_utxos.create();
+}
+
+bool data_base::create_history()
+{
+    return
+        history.create();
+}
+
+bool data_base::create_address_keys()
+{
+    return
+        address_assets.create() &&
+        address_dids.create() &&
+        address_mits.create();
+}
+
 // Start must be called before performing queries.
 // Start may be called after stop and/or after close in order to restart.
 bool data_base::start()
@@ -704,7 +1059,8 @@ bool data_base::start()
         mits.start() &&
         address_mits.start() &&
         mit_history.start() &&
-        witness_profiles.start()
+        witness_profiles.start() &&
+        address_utxos.start()
         ;
     const auto end_exclusive = end_write();
 
@@ -736,6 +1092,7 @@ bool data_base::stop()
     const auto address_mits_stop = address_mits.stop();
     const auto mit_history_stop = mit_history.stop();
     const auto witness_profiles_stop = witness_profiles.stop();
+    const auto address_utxos_stop = address_utxos.stop();
     const auto end_exclusive = end_write();
 
     // This should remove the lock file. This is not important for locking
@@ -766,6 +1123,7 @@ bool data_base::stop()
         address_mits_stop &&
         mit_history_stop &&
         witness_profiles_stop &&
+        address_utxos_stop &&
         end_exclusive;
 }
 
@@ -792,6 +1150,7 @@ bool data_base::close()
     const auto address_mits_close = address_mits.close();
     const auto mit_history_close = mit_history.close();
     const auto witness_profiles_close = witness_profiles.close();
+    const auto address_utxos_close = address_utxos.close();
 
     // Return the cumulative result of the database closes.
     return
@@ -814,7 +1173,8 @@ bool data_base::close()
         mits_close &&
         address_mits_close &&
         mit_history_close &&
-        witness_profiles_close
+        witness_profiles_close &&
+        address_utxos_close
         ;
 }
 
@@ -891,6 +1251,7 @@ void data_base::synchronize()
     mit_history.sync();
     blocks.sync();
     witness_profiles.sync();
+    address_utxos.sync();
 }
 
 void data_base::synchronize_dids()
@@ -921,98 +1282,276 @@ void data_base::synchronize_witness_profiles()
     witness_profiles.sync();
 }
 
+void data_base::synchronize_address_utxos()
+{
+    address_utxos.sync();
+}
+
+void data_base::synchronize_history()
+{
+    history.sync();
+}
+
+void data_base::synchronize_address_keys()
+{
+    address_assets.sync();
+    address_dids.sync();
+    address_mits.sync();
+}
+
 void data_base::push(const block& block)
 {
     // Height is unsafe unless database locked.
     push(block, get_next_height(blocks));
 }
 
+// Each task writes its own stores, in block order, so the stores are written
+// concurrently and then synchronized once.
 void data_base::push(const block& block, uint64_t height)
 {
-    for (size_t index = 0; index < block.transactions.size(); ++index)
+    // Skip BIP30 allowed duplicates (coinbase txs of excepted blocks).
+    // We handle here because this is the lowest public level exposed.
+    const auto& txs = block.transactions;
+    const size_t first = is_allowed_duplicate(block.header, height) ? 1 : 0;
+
+    hash_list tx_hashes;
+    tx_hashes.reserve(txs.size());
+    for (const auto& tx: txs)
+        tx_hashes.push_back(tx.hash());
+
+    // Extract each address once for all of the address keyed stores.
+    std::vector<tx_addresses> addresses(txs.size());
+    if (height >= history_height_)
+        for (auto index = first; index < txs.size(); ++index)
+            addresses[index] = to_tx_addresses(txs[index]);
+
+    timestamp_ = block.header.timestamp; // for address_asset_database store_input/store_output used only
+
+    const auto for_each_tx = [&](std::function<void(size_t)> write)
     {
-        // Skip BIP30 allowed duplicates (coinbase txs of excepted blocks).
-        // We handle here because this is the lowest public level exposed.
-        if (index == 0 && is_allowed_duplicate(block.header, height))
-            continue;
+        return [&txs, first, write]()
+        {
+            for (auto index = first; index < txs.size(); ++index)
+                write(index);
+        };
+    };
 
-        const auto& tx = block.transactions[index];
-        const auto tx_hash = tx.hash();
+    // Each store is written by exactly one task. A store's memory maps are
+    // resized under their own lock and the shared remap mutex, on every
+    // platform, so the concurrent tasks never remap a file under another.
+    const std::vector<std::function<void()>> tasks
+    {
+        for_each_tx([&](size_t index)
+        {
+            if (!txs[index].is_coinbase())
+                push_spends(tx_hashes[index], txs[index].inputs);
+        }),
+        for_each_tx([&](size_t index)
+        {
+            push_address_utxos(tx_hashes[index], height, txs[index],
+                addresses[index]);
+        }),
+        for_each_tx([&](size_t index)
+        {
+            push_history(tx_hashes[index], height, txs[index],
+                addresses[index]);
+        }),
+        for_each_tx([&](size_t index)
+        {
+            push_business(tx_hashes[index], height, txs[index],
+                addresses[index]);
+        }),
+        for_each_tx([&](size_t index)
+        {
+            push_stealth(tx_hashes[index], height, txs[index].outputs);
+        }),
+        for_each_tx([&](size_t index)
+        {
+            transactions.store(height, index, txs[index]);
+        }),
+        [&]()
+        {
+            blocks.store(block, height);
+        }
+    };
 
-        timestamp_ = block.header.timestamp; // for address_asset_database store_input/store_output used only
+    run_parallel(tasks);
 
-        // Add inputs
-        if (!tx.is_coinbase())
-            push_inputs(tx_hash, height, tx.inputs);
+    // Synchronise everything that was added.
+    synchronize();
+}
 
-        // Add outputs
-        push_outputs(tx_hash, height, tx.outputs);
+// Waits for every task, then rethrows the first failure (a failed resize).
+void data_base::run_parallel(const std::vector<std::function<void()>>& tasks)
+{
+    std::vector<std::future<void>> results;
+    results.reserve(tasks.size());
 
-        // Add stealth outputs
-        push_stealth(tx_hash, height, tx.outputs);
+    // Only an instance that pushes blocks starts the pool, with a thread
+    // for each task where the hardware allows.
+    if (!write_pool_)
+    {
+        const size_t cores = std::max(std::thread::hardware_concurrency(), 1u);
+        write_pool_ = std::make_shared<threadpool>(
+            std::min(cores, tasks.size()));
+    }
 
-        // Add transaction
-        transactions.store(height, index, tx);
+    for (const auto& task: tasks)
+    {
+        const auto job = std::make_shared<std::packaged_task<void()>>(task);
+        results.push_back(job->get_future());
+        write_pool_->service().post([job]() { (*job)(); });
     }
 
-    // Add block itself.
-    blocks.store(block, height);
+    for (auto& result: results)
+        result.wait();
 
-    // Synchronise everything that was added.
-    synchronize();
+    for (auto& result: results)
+        result.get();
 }
 
-void data_base::push_inputs(const hash_digest& tx_hash, size_t height,
+void data_base::push_spends(const hash_digest& tx_hash,
     const input::list& inputs)
 {
     for (uint32_t index = 0; index < inputs.size(); ++index)
     {
-        // We also push spends in the inputs loop.
-        const auto& input = inputs[index];
         const chain::input_point point{ tx_hash, index };
-        spends.store(input.previous_output, point);
+        spends.store(inputs[index].previous_output, point);
+    }
+}
 
-        if (height < history_height_)
+data_base::tx_addresses data_base::to_tx_addresses(const transaction& tx)
+{
+    tx_addresses addresses;
+    addresses.outputs.reserve(tx.outputs.size());
+
+    if (!tx.is_coinbase())
+    {
+        addresses.inputs.reserve(tx.inputs.size());
+        for (const auto& input: tx.inputs)
+            addresses.inputs.push_back(payment_address::extract(input.script));
+    }
+
+    for (const auto& output: tx.outputs)
+        addresses.outputs.push_back(payment_address::extract(output.script));
+
+    return addresses;
+}
+
+void data_base::push_history(const hash_digest& tx_hash, size_t height,
+    const transaction& tx, const tx_addresses& addresses)
+{
+    if (height < history_height_)
+        return;
+
+    for (uint32_t index = 0; index < addresses.inputs.size(); ++index)
+    {
+        const auto& address = addresses.inputs[index];
+        if (!address)
             continue;
 
-        // Try to extract an address.
-        const auto address = payment_address::extract(input.script);
+        const chain::input_point point{ tx_hash, index };
+        history.add_input(address.hash(), point, height,
+            tx.inputs[index].previous_output);
+    }
+
+    for (uint32_t index = 0; index < addresses.outputs.size(); ++index)
+    {
+        const auto& address = addresses.outputs[index];
         if (!address)
             continue;
 
-        const auto& previous = input.previous_output;
-        history.add_input(address.hash(), point, height, previous);
+        const chain::output_point point{ tx_hash, index };
+        history.add_output(address.hash(), point, height,
+            tx.outputs[index].value);
+    }
+}
+
+// Address assets rows and the asset, did, cert and mit tables.
+void data_base::push_business(const hash_digest& tx_hash, size_t height,
+    const transaction& tx, const tx_addresses& addresses)
+{
+    if (height < history_height_)
+        return;
+
+    for (uint32_t index = 0; index < addresses.inputs.size(); ++index)
+    {
+        const auto& address = addresses.inputs[index];
+        if (!address)
+            continue;
 
         /* begin added for asset issue/transfer */
-        auto address_str = address.encoded();
-        data_chunk data(address_str.begin(), address_str.end());
-        short_hash key = ripemd160_hash(data);
-        address_assets.store_input(key, point, height, previous, timestamp_);
-        address_assets.sync();
+        const chain::input_point point{ tx_hash, index };
+        address_assets.store_input(address.hash(), point, height,
+            tx.inputs[index].previous_output, timestamp_);
         /* end added for asset issue/transfer */
     }
+
+    for (uint32_t index = 0; index < addresses.outputs.size(); ++index)
+    {
+        const auto& address = addresses.outputs[index];
+        if (!address)
+            continue;
+
+        const auto& output = tx.outputs[index];
+        const chain::output_point point{ tx_hash, index };
+        push_attachment(output.attach_data, address, point, height,
+            output.value);
+    }
 }
 
-void data_base::push_outputs(const hash_digest& tx_hash, size_t height,
-    const output::list& outputs)
+static address_utxo to_address_utxo(const transaction& tx,
+    const output_point& point, size_t height, uint8_t version)
+{
+    const auto& output = tx.outputs[point.index];
+    const auto& ops = output.script.operations;
+    address_utxo utxo{ point, static_cast<uint32_t>(height), output.value,
+        version, utxo_lock_kind::none, 0, output.attach_data.get_type() };
+
+    // Mirrors the precedence of block_chain_impl::is_utxo_spendable.
+    if (operation::is_pay_key_hash_with_lock_height_pattern(ops)) {
+        utxo.lock_kind = utxo_lock_kind::lock_height;
+        utxo.lock_value = static_cast<uint32_t>(
+            operation::get_lock_height_from_pay_key_hash_with_lock_height(ops));
+    }
+    else if (operation::is_pay_key_hash_with_sequence_lock_pattern(ops)) {
+        utxo.lock_kind = utxo_lock_kind::sequence_lock;
+        utxo.lock_value = output.get_lock_sequence();
+    }
+    else if (tx.is_coinbase()) {
+        utxo.lock_kind = utxo_lock_kind::coinbase;
+    }
+    // Not final at height and time zero: the lock time is set and some
+    // input sequence is not final, so the lock time applies on spend.
+    else if (tx.version >= relative_locktime_min_version
+        && !tx.is_final(0, 0)) {
+        utxo.lock_kind = utxo_lock_kind::locktime;
+        utxo.lock_value = tx.locktime;
+    }
+
+    return utxo;
+}
+
+void data_base::push_address_utxos(const hash_digest& tx_hash,
+    size_t height, const transaction& tx, const tx_addresses& addresses)
 {
+    const auto coinbase = tx.is_coinbase();
+    if (!coinbase)
+        for (const auto& input: tx.inputs)
+            address_utxos.spend(input.previous_output);
+
     if (height < history_height_)
         return;
 
-    for (uint32_t index = 0; index < outputs.size(); ++index)
+    for (uint32_t index = 0; index < addresses.outputs.size(); ++index)
     {
-        const auto& output = outputs[index];
-        const chain::output_point point{ tx_hash, index };
-
-        // Try to extract an address.
-        const auto address = payment_address::extract(output.script);
+        const auto& address = addresses.outputs[index];
         if (!address)
             continue;
 
-        const auto value = output.value;
-        history.add_output(address.hash(), point, height, value);
-
-        push_attachment(output.attach_data, address, point, height, value);
+        const chain::output_point point{ tx_hash, index };
+        address_utxos.store(address.hash(), to_address_utxo(tx, point,
+            height, address.version()));
     }
 }
 
@@ -1055,6 +1594,128 @@ void data_base::push_stealth(const hash_digest& tx_hash, size_t height,
     }
 }
 
+// Replays the stored transactions from the height to the top, in chain
+// order, used on upgrade to populate derived tables.
+void data_base::replay_blocks(size_t from, replay_visitor visitor,
+    std::function<void()> synchronize)
+{
+    size_t top;
+    if (!blocks.top(top))
+        return;
+
+    for (auto height = from; height <= top; ++height)
+    {
+        const auto block_result = blocks.get(height);
+        if (!block_result)
+            continue;
+
+        // Business rows carry the timestamp of their block.
+        timestamp_ = block_result.header().timestamp;
+
+        const auto count = block_result.transaction_count();
+        for (size_t index = 0; index < count; ++index)
+        {
+            const auto tx_hash = block_result.transaction_hash(index);
+            const auto tx_result = transactions.get(tx_hash);
+            if (tx_result)
+                visitor(height, tx_hash, tx_result.transaction());
+        }
+
+        if (height % 100000 == 0)
+        {
+            log::info(LOG_DATABASE)
+                << "Replaying blocks at height " << height;
+            synchronize();
+        }
+    }
+
+    synchronize();
+}
+
+// Replays the stored chain into the address utxo index, used on upgrade.
+// As in push_address_utxos no outputs are stored below the history height,
+// so spends below it have nothing to drop and the replay starts there.
+void data_base::rebuild_address_utxos()
+{
+    const auto visitor = [this](size_t height, const hash_digest& tx_hash,
+        const transaction& tx)
+    {
+        if (!tx.is_coinbase())
+            for (const auto& input: tx.inputs)
+                address_utxos.spend(input.previous_output);
+
+        for (uint32_t out = 0; out < tx.outputs.size(); ++out)
+        {
+            const auto& output = tx.outputs[out];
+            const auto address = payment_address::extract(output.script);
+            if (!address)
+                continue;
+
+            const output_point point{ tx_hash, out };
+            address_utxos.store(address.hash(), to_address_utxo(tx, point,
+                height, address.version()));
+        }
+    };
+
+    replay_blocks(history_height_, visitor,
+        [this]() { synchronize_address_utxos(); });
+}
+
+void data_base::rebuild_history()
+{
+    // Rows are added in the order of push_history.
+    const auto visitor = [this](size_t height, const hash_digest& tx_hash,
+        const transaction& tx)
+    {
+        for (uint32_t in = 0; in < tx.inputs.size(); ++in)
+        {
+            const auto& input = tx.inputs[in];
+            const auto address = payment_address::extract(input.script);
+            if (!address)
+                continue;
+
+            const input_point point{ tx_hash, in };
+            history.add_input(address.hash(), point, height,
+                input.previous_output);
+        }
+
+        for (uint32_t out = 0; out < tx.outputs.size(); ++out)
+        {
+            const auto& output = tx.outputs[out];
+            const auto address = payment_address::extract(output.script);
+            if (!address)
+                continue;
+
+            const output_point point{ tx_hash, out };
+            history.add_output(address.hash(), point, height, output.value);
+        }
+    };
+
+    replay_blocks(history_height_, visitor,
+        [this]() { synchronize_history(); });
+}
+
+// Replays the stored chain into the address asset, did and mit rows, used
+// on upgrade. The symbol tables are already current and are not written.
+void data_base::rebuild_address_keys()
+{
+    const auto visitor = [this](size_t height, const hash_digest& tx_hash,
+        const transaction& tx)
+    {
+        push_business(tx_hash, height, tx, to_tx_addresses(tx));
+    };
+
+    address_rows_only_ = true;
+    replay_blocks(history_height_, visitor,
+        [this]() { synchronize_address_keys(); });
+
+    // The blackhole did is registered with the database, not by a block.
+    set_blackhole_did();
+    address_rows_only_ = false;
+
+    synchronize_address_keys();
+}
+
 bool data_base::pop(chain::block& block)
 {
     size_t height;
@@ -1095,14 +1756,14 @@ bool data_base::pop(chain::block& block)
     // Remove txs, then outputs, then inputs (also reverse order).
     for (auto tx = txs.rbegin(); tx != txs.rend(); ++tx)
     {
-        transactions.remove(tx->hash());
-        pop_outputs(tx->outputs, height);
+        const auto tx_hash = tx->hash();
+        transactions.remove(tx_hash);
+        pop_outputs(tx_hash, tx->outputs, height);
 
         if (!tx->is_coinbase())
             pop_inputs(tx->inputs, height);
     }
 
-    // Stealth unlink is not implemented.
     stealth.unlink(height);
     blocks.unlink(height);
     blocks.remove(block.header.hash()); // wdy remove block from block hash table
@@ -1119,6 +1780,7 @@ void data_base::pop_inputs(const input::list& inputs, size_t height)
     for (auto input = inputs.rbegin(); input != inputs.rend(); ++input)
     {
         spends.remove(input->previous_output);
+        restore_address_utxo(input->previous_output);
 
         if (height < history_height_)
             continue;
@@ -1129,15 +1791,33 @@ void data_base::pop_inputs(const input::list& inputs, size_t height)
         if (address) {
             history.delete_last_row(address.hash());
             // delete address asset record
-            auto address_str = address.encoded();
-            data_chunk data(address_str.begin(), address_str.end());
-            short_hash hash = ripemd160_hash(data);
-            address_assets.delete_last_row(hash);
+            address_assets.delete_last_row(address.hash());
         }
     }
 }
 
-void data_base::pop_outputs(const output::list& outputs, size_t height)
+// Store again the output row dropped when the popped input spent it.
+void data_base::restore_address_utxo(const output_point& point)
+{
+    const auto result = transactions.get(point.hash);
+    if (!result || result.height() < history_height_)
+        return;
+
+    const auto tx = result.transaction();
+    if (point.index >= tx.outputs.size())
+        return;
+
+    const auto& output = tx.outputs[point.index];
+    const auto address = payment_address::extract(output.script);
+    if (!address)
+        return;
+
+    address_utxos.restore(address.hash(), to_address_utxo(tx, point,
+        result.height(), address.version()));
+}
+
+void data_base::pop_outputs(const hash_digest& tx_hash,
+    const output::list& outputs, size_t height)
 {
     if (height < history_height_)
         return;
@@ -1149,11 +1829,12 @@ void data_base::pop_outputs(const output::list& outputs, size_t height)
         const auto address = payment_address::extract(output->script);
 
         if (address) {
+            const auto index = std::distance(output, outputs.rend()) - 1;
+            const output_point point{ tx_hash, static_cast<uint32_t>(index) };
+            address_utxos.remove(point);
             history.delete_last_row(address.hash());
             // delete address asset record
-            auto address_str = address.encoded();
-            data_chunk data(address_str.begin(), address_str.end());
-            short_hash hash = ripemd160_hash(data);
+            const auto hash = address.hash();
             bc::chain::output op = *output;
             // NOTICE: pop only the pushed row, at present did and mit is
             // not stored in address_asset, but stored separately
@@ -1188,8 +1869,7 @@ void data_base::pop_outputs(const output::list& outputs, size_t height)
                     if(blockchain_did_)
                     {
                         auto old_address = blockchain_did_->get_did().get_address();
-                        data_chunk data_old(old_address.begin(), old_address.end());
-                        short_hash old_hash = ripemd160_hash(data_old);
+                        const auto old_hash = to_address_key(old_address);
 
                         address_dids.delete_last_row(old_hash);
                         address_dids.delete_last_row(hash);
@@ -1242,11 +1922,8 @@ using namespace libbitcoin::config;
 void data_base::push_attachment(const attachment& attach, const payment_address& address,
     const output_point& outpoint, uint32_t output_height, uint64_t value)
 {
-    auto address_str = address.encoded();
-    log::trace(LOG_DATABASE) << "push_attachment address_str=" << address_str;
-    log::trace(LOG_DATABASE) << "push_attachment address hash=" << base16(address.hash());
-    data_chunk data(address_str.begin(), address_str.end());
-    short_hash hash = ripemd160_hash(data);
+    const auto hash = address.hash();
+    log::trace(LOG_DATABASE) << "push_attachment address hash=" << base16(hash);
     auto visitor = attachment_visitor(this, hash, outpoint, output_height, value,
         attach.get_from_did(), attach.get_to_did());
     boost::apply_visitor(visitor, const_cast<attachment&>(attach).get_attach());
@@ -1258,7 +1935,6 @@ void data_base::push_etp(const etp& etp, const short_hash& key,
     address_assets.store_output(key, outpoint, output_height, value,
         static_cast<typename std::underlying_type<business_kind>::type>(business_kind::etp),
         timestamp_, etp);
-    address_assets.sync();
 }
 
 void data_base::push_etp_award(const etp_award& award, const short_hash& key,
@@ -1267,7 +1943,6 @@ void data_base::push_etp_award(const etp_award& award, const short_hash& key,
     address_assets.store_output(key, outpoint, output_height, value,
         static_cast<typename std::underlying_type<business_kind>::type>(business_kind::etp_award),
         timestamp_, award);
-    address_assets.sync();
 }
 
 void data_base::push_message(const chain::blockchain_message& msg, const short_hash& key,
@@ -1276,7 +1951,6 @@ void data_base::push_message(const chain::blockchain_message& msg, const short_h
     address_assets.store_output(key, outpoint, output_height, value,
         static_cast<typename std::underlying_type<business_kind>::type>(business_kind::message),
         timestamp_, msg);
-    address_assets.sync();
 }
 
 void data_base::push_asset(const asset& sp, const short_hash& key,
@@ -1289,35 +1963,33 @@ void data_base::push_asset(const asset& sp, const short_hash& key,
 void data_base::push_asset_cert(const asset_cert& sp_cert, const short_hash& key,
     const output_point& outpoint, uint32_t output_height, uint64_t value)
 {
-    if (sp_cert.is_newly_generated()) {
+    if (sp_cert.is_newly_generated() && !address_rows_only_) {
         certs.store(sp_cert);
-        certs.sync();
 
         if (sp_cert.get_type() == asset_cert_ns::witness) {
             auto bc_cert = blockchain_cert(0, outpoint, output_height, sp_cert);
             witness_certs.store(bc_cert);
-            witness_certs.sync();
         }
     }
 
     address_assets.store_output(key, outpoint, output_height, value,
         static_cast<typename std::underlying_type<business_kind>::type>(business_kind::asset_cert),
         timestamp_, sp_cert);
-    address_assets.sync();
 }
 
 void data_base::push_asset_detail(const asset_detail& sp_detail, const short_hash& key,
     const output_point& outpoint, uint32_t output_height, uint64_t value)
 {
-    const data_chunk& data = data_chunk(sp_detail.get_symbol().begin(), sp_detail.get_symbol().end());
-    const auto hash = sha256_hash(data);
-    auto bc_asset = blockchain_asset(0, outpoint,output_height, sp_detail);
-    assets.store(hash, bc_asset);
-    assets.sync();
+    if (!address_rows_only_) {
+        const data_chunk& data = data_chunk(sp_detail.get_symbol().begin(), sp_detail.get_symbol().end());
+        const auto hash = sha256_hash(data);
+        auto bc_asset = blockchain_asset(0, outpoint,output_height, sp_detail);
+        assets.store(hash, bc_asset);
+    }
+
     address_assets.store_output(key, outpoint, output_height, value,
         static_cast<typename std::underlying_type<business_kind>::type>(business_kind::asset_issue),
         timestamp_, sp_detail);
-    address_assets.sync();
 }
 
 void data_base::push_asset_transfer(const asset_transfer& sp_transfer, const short_hash& key,
@@ -1326,7 +1998,6 @@ void data_base::push_asset_transfer(const asset_transfer& sp_transfer, const sho
     address_assets.store_output(key, outpoint, output_height, value,
         static_cast<typename std::underlying_type<business_kind>::type>(business_kind::asset_transfer),
         timestamp_, sp_transfer);
-    address_assets.sync();
 }
 /* end store asset related info into database */
 
@@ -1340,15 +2011,16 @@ void data_base::push_did(const did& sp, const short_hash& key,
 void data_base::push_did_detail(const did_detail& sp_detail, const short_hash& key,
     const output_point& outpoint, uint32_t output_height, uint64_t value)
 {
-    const data_chunk& data = data_chunk(sp_detail.get_symbol().begin(), sp_detail.get_symbol().end());
-    const auto hash = sha256_hash(data);
-    auto bc_did = blockchain_did(0, outpoint,output_height, blockchain_did::address_current,sp_detail);
-    dids.store(hash, bc_did);
-    dids.sync();
+    if (!address_rows_only_) {
+        const data_chunk& data = data_chunk(sp_detail.get_symbol().begin(), sp_detail.get_symbol().end());
+        const auto hash = sha256_hash(data);
+        auto bc_did = blockchain_did(0, outpoint,output_height, blockchain_did::address_current,sp_detail);
+        dids.store(hash, bc_did);
+    }
+
     address_dids.store_output(key, outpoint, output_height, value,
         static_cast<typename std::underlying_type<business_kind>::type>(business_kind::did_register),
         timestamp_, sp_detail);
-    address_dids.sync();
 }
 
 /* end store did related info into database */
@@ -1360,18 +2032,17 @@ void data_base::push_mit(const asset_mit& mit, const short_hash& key,
 {
     asset_mit_info mit_info{output_height, timestamp_, to_did, mit};
 
-    if (mit.is_register_status()) {
+    if (mit.is_register_status() && !address_rows_only_) {
         mits.store(mit_info);
-        mits.sync();
     }
 
     address_mits.store_output(key, outpoint, output_height, value,
         static_cast<typename std::underlying_type<business_kind>::type>(business_kind::asset_mit),
         timestamp_, mit);
-    address_mits.sync();
 
-    mit_history.store(mit_info);
-    mit_history.sync();
+    if (!address_rows_only_) {
+        mit_history.store(mit_info);
+    }
 }
 /* end store mit related info into database */
 
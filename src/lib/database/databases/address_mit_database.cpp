@@ -24,6 +24,7 @@
 #include <memory>
 #include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
+#include <metaverse/database/address_key.hpp>
 #include <metaverse/database/memory/memory.hpp>
 #include <metaverse/database/primitives/record_multimap_iterable.hpp>
 #include <metaverse/database/primitives/record_multimap_iterator.hpp>
@@ -243,8 +244,7 @@ business_record::list address_mit_database::get(const short_hash& key,
 std::shared_ptr<std::vector<business_record>> address_mit_database::get(const std::string& address, const std::string& symbol,
     size_t start_height, size_t end_height, uint64_t limit, uint64_t page_number) const
 {
-    data_chunk addr_data(address.begin(), address.end());
-    auto key = ripemd160_hash(addr_data);
+    const auto key = to_address_key(address);
 
     // Read the height value from the row.
     const auto read_height = [](uint8_t* data)
@@ -331,8 +331,7 @@ std::shared_ptr<std::vector<business_record>> address_mit_database::get(const st
 std::shared_ptr<std::vector<business_record>> address_mit_database::get(const std::string& address, size_t start_height,
     size_t end_height) const
 {
-    data_chunk addr_data(address.begin(), address.end());
-    auto key = ripemd160_hash(addr_data);
+    const auto key = to_address_key(address);
 
     // Read the height value from the row.
     const auto read_height = [](uint8_t* data)
@@ -548,8 +547,7 @@ business_history::list address_mit_database::get_business_history(const short_ha
 std::shared_ptr<std::vector<business_history>> address_mit_database::get_address_business_history(const std::string& address,
     size_t from_height) const
 {
-    data_chunk data(address.begin(), address.end());
-    auto key = ripemd160_hash(data);
+    const auto key = to_address_key(address);
     business_history::list result = get_business_history(key, from_height);
     auto unspent = std::make_shared<std::vector<business_history>>();
 
@@ -578,8 +576,7 @@ std::shared_ptr<std::vector<business_history>> address_mit_database::get_address
 business_history::list address_mit_database::get_business_history(const std::string& address,
     size_t from_height, uint8_t status) const
 {
-    data_chunk data(address.begin(), address.end());
-    auto key = ripemd160_hash(data);
+    const auto key = to_address_key(address);
     business_history::list result = get_business_history(key, from_height);
     business_history::list unspent;
 
@@ -600,8 +597,7 @@ business_history::list address_mit_database::get_business_history(const std::str
 business_history::list address_mit_database::get_business_history(const std::string& address,
     size_t from_height, uint32_t time_begin, uint32_t time_end) const
 {
-    data_chunk data(address.begin(), address.end());
-    auto key = ripemd160_hash(data);
+    const auto key = to_address_key(address);
     business_history::list result = get_business_history(key, from_height);
     business_history::list unspent;
 
@@ -631,8 +627,7 @@ business_history::list address_mit_database::get_business_history(const std::str
 business_address_mit::list address_mit_database::get_mits(const std::string& address,
     size_t from_height, asset_mit::mit_status kind) const
 {
-    data_chunk data(address.begin(), address.end());
-    auto key = ripemd160_hash(data);
+    const auto key = to_address_key(address);
     business_history::list result = get_business_history(key, from_height);
     business_address_mit::list unspent;
 
@@ -0,0 +1,473 @@
+/**
+ * Copyright (c) 2011-2021 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2021 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/database/databases/address_utxo_database.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/memory/memory.hpp>
+
+/// -- address entry (lookup) --
+/// [ head:4 ][ received:8 ]
+
+/// -- output row (rows, keyed by output point) --
+/// [ next:4 ][ prev:4 ][ address:20 ][ height:4 ][ value:8 ]
+/// [ version:1 ][ lock_kind:1 ][ lock_value:4 ][ attachment_type:4 ]
+
+/// -- rows file --
+/// [ header ][ free:4 ][ records ]
+
+namespace libbitcoin {
+namespace database {
+
+using namespace boost::filesystem;
+using namespace bc::chain;
+
+// Both tables start small and split buckets as they fill.
+BC_CONSTEXPR size_t number_buckets = 99991;
+BC_CONSTEXPR size_t header_size = record_hash_table_header_size(number_buckets);
+BC_CONSTEXPR size_t initial_lookup_file_size = header_size + minimum_records_size;
+
+BC_CONSTEXPR size_t number_row_buckets = 99991;
+BC_CONSTEXPR size_t row_header_size = record_hash_table_header_size(number_row_buckets);
+BC_CONSTEXPR file_offset free_position = row_header_size;
+BC_CONSTEXPR size_t row_records_offset = free_position + sizeof(array_index);
+BC_CONSTEXPR size_t initial_rows_file_size = row_records_offset + minimum_records_size;
+
+BC_CONSTEXPR size_t entry_size = 4 + 8;
+BC_CONSTEXPR size_t record_size = hash_table_record_size<short_hash>(entry_size);
+
+BC_CONSTEXPR file_offset next_position = 0;
+BC_CONSTEXPR file_offset prev_position = 4;
+BC_CONSTEXPR file_offset address_position = 8;
+BC_CONSTEXPR file_offset height_position = address_position + short_hash_size;
+BC_CONSTEXPR size_t row_size = height_position + 4 + 8 + 1 + 1 + 4 + 4;
+BC_CONSTEXPR size_t row_record_size = hash_table_record_size<chain::point>(row_size);
+
+// The row follows the output point key and the bucket chain index.
+BC_CONSTEXPR file_offset row_position = std::tuple_size<chain::point>::value +
+    sizeof(array_index);
+
+static const array_index empty_row = bc::max_uint32;
+
+address_utxo_database::address_utxo_database(const path& lookup_filename,
+    const path& lookup_growth_filename, const path& rows_filename,
+    const path& rows_growth_filename, std::shared_ptr<shared_mutex> mutex)
+  : lookup_file_(lookup_filename, mutex),
+    lookup_growth_file_(lookup_growth_filename, mutex),
+    lookup_header_(lookup_file_, lookup_growth_file_, number_buckets),
+    lookup_manager_(lookup_file_, header_size, record_size),
+    lookup_map_(lookup_header_, lookup_manager_),
+    rows_file_(rows_filename, mutex),
+    rows_growth_file_(rows_growth_filename, mutex),
+    rows_header_(rows_file_, rows_growth_file_, number_row_buckets),
+    rows_manager_(rows_file_, row_records_offset, row_record_size),
+    rows_map_(rows_header_, rows_manager_)
+{
+}
+
+// Close does not call stop because there is no way to detect thread join.
+address_utxo_database::~address_utxo_database()
+{
+    close();
+}
+
+// Create.
+// ----------------------------------------------------------------------------
+
+// Initialize files and start.
+bool address_utxo_database::create()
+{
+    // Resize and create require a started file.
+    if (!lookup_file_.start() ||
+        !lookup_growth_file_.start() ||
+        !rows_file_.start() ||
+        !rows_growth_file_.start())
+        return false;
+
+    // These will throw if insufficient disk space.
+    lookup_file_.resize(initial_lookup_file_size);
+    rows_file_.resize(initial_rows_file_size);
+
+    if (!lookup_header_.create() ||
+        !lookup_manager_.create() ||
+        !rows_header_.create() ||
+        !rows_manager_.create())
+        return false;
+
+    write_free(empty_row);
+
+    // Should not call start after create, already started.
+    return
+        lookup_header_.start() &&
+        lookup_manager_.start() &&
+        rows_header_.start() &&
+        rows_manager_.start();
+}
+
+// Startup and shutdown.
+// ----------------------------------------------------------------------------
+
+bool address_utxo_database::start()
+{
+    return
+        lookup_file_.start() &&
+        lookup_growth_file_.start() &&
+        rows_file_.start() &&
+        rows_growth_file_.start() &&
+        lookup_header_.start() &&
+        lookup_manager_.start() &&
+        rows_header_.start() &&
+        rows_manager_.start();
+}
+
+bool address_utxo_database::stop()
+{
+    return
+        lookup_file_.stop() &&
+        lookup_growth_file_.stop() &&
+        rows_file_.stop() &&
+        rows_growth_file_.stop();
+}
+
+bool address_utxo_database::close()
+{
+    return
+        lookup_file_.close() &&
+        lookup_growth_file_.close() &&
+        rows_file_.close() &&
+        rows_growth_file_.close();
+}
+
+// ----------------------------------------------------------------------------
+
+void address_utxo_database::store(const short_hash& key,
+    const address_utxo& utxo)
+{
+    insert(key, utxo, true);
+}
+
+void address_utxo_database::restore(const short_hash& key,
+    const address_utxo& utxo)
+{
+    insert(key, utxo, false);
+}
+
+bool address_utxo_database::spend(const output_point& outpoint)
+{
+    return erase(outpoint, false);
+}
+
+void address_utxo_database::remove(const output_point& outpoint)
+{
+    erase(outpoint, true);
+}
+
+address_utxo::list address_utxo_database::get(const short_hash& key) const
+{
+    address_utxo::list result;
+    const auto entry = lookup_map_.find(key);
+    if (!entry)
+        return result;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    auto current = from_little_endian_unsafe<array_index>(REMAP_ADDRESS(entry));
+    const auto count = rows_manager_.count();
+
+    while (current != empty_row && result.size() < count)
+    {
+        const auto memory = rows_manager_.get(current);
+        const auto record = REMAP_ADDRESS(memory);
+        const auto row = record + row_position;
+        auto deserial = make_deserializer_unsafe(row + height_position);
+
+        address_utxo utxo;
+        utxo.output = read_key<chain::point>(record);
+        utxo.height = deserial.read_4_bytes_little_endian();
+        utxo.value = deserial.read_8_bytes_little_endian();
+        utxo.version = deserial.read_byte();
+        utxo.lock_kind = static_cast<utxo_lock_kind>(deserial.read_byte());
+        utxo.lock_value = deserial.read_4_bytes_little_endian();
+        utxo.attachment_type = deserial.read_4_bytes_little_endian();
+        result.emplace_back(std::move(utxo));
+
+        current = from_little_endian_unsafe<array_index>(row + next_position);
+    }
+
+    return result;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+uint64_t address_utxo_database::received(const short_hash& key) const
+{
+    const auto entry = lookup_map_.find(key);
+    if (!entry)
+        return 0;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return from_little_endian_unsafe<uint64_t>(REMAP_ADDRESS(entry) + 4);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void address_utxo_database::sync()
+{
+    lookup_manager_.sync();
+    rows_manager_.sync();
+}
+
+address_utxo_statinfo address_utxo_database::statinfo() const
+{
+    return
+    {
+        lookup_header_.size(),
+        lookup_manager_.count(),
+        rows_manager_.count()
+    };
+}
+
+// privates
+
+// Link the row of the output at the head of its address list.
+void address_utxo_database::insert(const short_hash& key,
+    const address_utxo& utxo, bool receive)
+{
+    if (!lookup_map_.find(key))
+    {
+        const auto write_entry = [](memory_ptr data)
+        {
+            auto serial = make_serializer(REMAP_ADDRESS(data));
+            serial.write_4_bytes_little_endian(empty_row);
+            serial.write_8_bytes_little_endian(0);
+        };
+        lookup_map_.store(key, write_entry);
+    }
+
+    const auto write_row = [&key, &utxo](memory_ptr data)
+    {
+        auto serial = make_serializer(REMAP_ADDRESS(data));
+        serial.write_4_bytes_little_endian(empty_row);
+        serial.write_4_bytes_little_endian(empty_row);
+        serial.write_short_hash(key);
+        serial.write_4_bytes_little_endian(utxo.height);
+        serial.write_8_bytes_little_endian(utxo.value);
+        serial.write_byte(utxo.version);
+        serial.write_byte(static_cast<uint8_t>(utxo.lock_kind));
+        serial.write_4_bytes_little_endian(utxo.lock_value);
+        serial.write_4_bytes_little_endian(utxo.attachment_type);
+    };
+
+    // Reuse a row released by a spend, otherwise allocate (may remap).
+    const auto released = take_free();
+    const auto index = released == empty_row ?
+        rows_map_.store(utxo.output, write_row) :
+        rows_map_.store(utxo.output, write_row, released);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+    link(index);
+
+    if (!receive)
+        return;
+
+    const auto entry = lookup_map_.find(key);
+    const auto received_address = REMAP_ADDRESS(entry) + 4;
+    const auto received = from_little_endian_unsafe<uint64_t>(received_address);
+    auto serial = make_serializer(received_address);
+    serial.write_8_bytes_little_endian(received + utxo.value);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Drop the row of the output, moving it to the free list for reuse.
+bool address_utxo_database::erase(const output_point& outpoint,
+    bool unreceive)
+{
+    array_index next;
+    array_index prev;
+    uint64_t value;
+    short_hash key;
+    {
+        const auto memory = rows_map_.find(outpoint);
+        if (!memory)
+            return false;
+
+        const auto row = REMAP_ADDRESS(memory);
+        next = from_little_endian_unsafe<array_index>(row + next_position);
+        prev = from_little_endian_unsafe<array_index>(row + prev_position);
+        value = from_little_endian_unsafe<uint64_t>(row + height_position + 4);
+        std::copy(row + address_position,
+            row + address_position + short_hash_size, key.begin());
+    }
+
+    const auto entry = lookup_map_.find(key);
+    BITCOIN_ASSERT(entry);
+    if (!entry)
+        return false;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    {
+        unique_lock lock(mutex_);
+
+        // The row is found through its predecessor (or the list head).
+        array_index index;
+        if (prev == empty_row)
+        {
+            const auto head_address = REMAP_ADDRESS(entry);
+            index = from_little_endian_unsafe<array_index>(head_address);
+            auto serial = make_serializer(head_address);
+            serial.write_4_bytes_little_endian(next);
+        }
+        else
+        {
+            const auto memory = rows_manager_.get(prev);
+            const auto prev_next = REMAP_ADDRESS(memory) + row_position +
+                next_position;
+            index = from_little_endian_unsafe<array_index>(prev_next);
+            auto serial = make_serializer(prev_next);
+            serial.write_4_bytes_little_endian(next);
+        }
+
+        if (next != empty_row)
+        {
+            const auto memory = rows_manager_.get(next);
+            auto serial = make_serializer(REMAP_ADDRESS(memory) +
+                row_position + prev_position);
+            serial.write_4_bytes_little_endian(prev);
+        }
+
+        if (unreceive)
+        {
+            const auto received_address = REMAP_ADDRESS(entry) + 4;
+            const auto received = from_little_endian_unsafe<uint64_t>(
+                received_address);
+            BITCOIN_ASSERT(received >= value);
+            auto serial = make_serializer(received_address);
+            serial.write_8_bytes_little_endian(received - value);
+        }
+
+        DEBUG_ONLY(bool success =) rows_map_.unlink(outpoint);
+        BITCOIN_ASSERT(success);
+        give_free(index);
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    return true;
+}
+
+// Insert the row at the head of its address list.
+void address_utxo_database::link(array_index index)
+{
+    short_hash key;
+    {
+        const auto memory = rows_manager_.get(index);
+        const auto row = REMAP_ADDRESS(memory) + row_position;
+        std::copy(row + address_position,
+            row + address_position + short_hash_size, key.begin());
+    }
+
+    const auto entry = lookup_map_.find(key);
+    BITCOIN_ASSERT(entry);
+    if (!entry)
+        return;
+
+    const auto head_address = REMAP_ADDRESS(entry);
+    const auto head = from_little_endian_unsafe<array_index>(head_address);
+
+    if (head != empty_row)
+    {
+        const auto memory = rows_manager_.get(head);
+        auto serial = make_serializer(REMAP_ADDRESS(memory) + row_position +
+            prev_position);
+        serial.write_4_bytes_little_endian(index);
+    }
+
+    {
+        const auto memory = rows_manager_.get(index);
+        auto serial = make_serializer(REMAP_ADDRESS(memory) + row_position +
+            next_position);
+        serial.write_4_bytes_little_endian(head);
+        serial.write_4_bytes_little_endian(empty_row);
+    }
+
+    auto serial = make_serializer(head_address);
+    serial.write_4_bytes_little_endian(index);
+}
+
+// Released rows are chained through their next index.
+array_index address_utxo_database::take_free()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+    const auto index = read_free();
+    if (index == empty_row)
+        return index;
+
+    array_index next;
+    {
+        const auto memory = rows_manager_.get(index);
+        next = from_little_endian_unsafe<array_index>(REMAP_ADDRESS(memory) +
+            row_position + next_position);
+    }
+
+    write_free(next);
+    return index;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// This must be called under the exclusive lock.
+void address_utxo_database::give_free(array_index index)
+{
+    const auto next = read_free();
+    {
+        const auto memory = rows_manager_.get(index);
+        auto serial = make_serializer(REMAP_ADDRESS(memory) + row_position +
+            next_position);
+        serial.write_4_bytes_little_endian(next);
+        serial.write_4_bytes_little_endian(empty_row);
+    }
+
+    write_free(index);
+}
+
+array_index address_utxo_database::read_free()
+{
+    const auto memory = rows_file_.access();
+    return from_little_endian_unsafe<array_index>(REMAP_ADDRESS(memory) +
+        free_position);
+}
+
+void address_utxo_database::write_free(array_index index)
+{
+    const auto memory = rows_file_.access();
+    auto serial = make_serializer(REMAP_ADDRESS(memory) + free_position);
+    serial.write_4_bytes_little_endian(index);
+}
+
+} // namespace database
+} // namespace libbitcoin
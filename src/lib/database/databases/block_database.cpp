@@ -52,9 +52,11 @@ const file_offset block_database::empty = 0;
 //  [ [    ...     ] ]
 
 block_database::block_database(const path& map_filename,
-    const path& index_filename, std::shared_ptr<shared_mutex> mutex)
+    const path& growth_filename, const path& index_filename,
+    std::shared_ptr<shared_mutex> mutex)
   : lookup_file_(map_filename, mutex),
-    lookup_header_(lookup_file_, number_buckets),
+    growth_file_(growth_filename, mutex),
+    lookup_header_(lookup_file_, growth_file_, number_buckets),
     lookup_manager_(lookup_file_, header_size),
     lookup_map_(lookup_header_, lookup_manager_),
     index_file_(index_filename, mutex),
@@ -74,8 +76,9 @@ block_database::~block_database()
 // Initialize files and start.
 bool block_database::create()
 {
-    // Resize and create require a started file.
+    // Resize and create require started files.
     if (!lookup_file_.start() ||
+        !growth_file_.start() ||
         !index_file_.start())
         return false;
 
@@ -103,6 +106,7 @@ bool block_database::start()
 {
     return
         lookup_file_.start() &&
+        growth_file_.start() &&
         index_file_.start() &&
         lookup_header_.start() &&
         lookup_manager_.start() &&
@@ -114,6 +118,7 @@ bool block_database::stop()
 {
     return
         lookup_file_.stop() &&
+        growth_file_.stop() &&
         index_file_.stop();
 }
 
@@ -122,9 +127,24 @@ bool block_database::close()
 {
     return
         lookup_file_.close() &&
+        growth_file_.close() &&
         index_file_.close();
 }
 
+// Convert a lookup table created with a fixed bucket count (offline).
+// The existing buckets remain in place, so only entries are counted.
+bool block_database::convert()
+{
+    if (!lookup_file_.start() ||
+        !growth_file_.start() ||
+        !lookup_header_.convert() ||
+        !lookup_manager_.start())
+        return false;
+
+    lookup_header_.set_entries(lookup_map_.count());
+    return true;
+}
+
 // ----------------------------------------------------------------------------
 
 block_result block_database::get(size_t height) const
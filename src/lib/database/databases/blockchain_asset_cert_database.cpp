@@ -42,7 +42,8 @@ blockchain_asset_cert_database::blockchain_asset_cert_database(const path& map_f
   : lookup_file_(map_filename, mutex),
     lookup_header_(lookup_file_, number_buckets),
     lookup_manager_(lookup_file_, header_size),
-    lookup_map_(lookup_header_, lookup_manager_)
+    lookup_map_(lookup_header_, lookup_manager_),
+    symbols_(std::bind(&blockchain_asset_cert_database::load_symbols, this, std::placeholders::_1))
 {
 }
 
@@ -69,6 +70,8 @@ bool blockchain_asset_cert_database::create()
         !lookup_manager_.create())
         return false;
 
+    symbols_.clear();
+
     // Should not call start after create, already started.
     return
         lookup_header_.start() &&
@@ -105,6 +108,9 @@ void blockchain_asset_cert_database::remove(const hash_digest& hash)
 {
     DEBUG_ONLY(bool success =) lookup_map_.unlink(hash);
     BITCOIN_ASSERT(success);
+
+    if (!lookup_map_.find(hash))
+        symbols_.erase(hash);
 }
 
 void blockchain_asset_cert_database::sync()
@@ -128,18 +134,19 @@ std::shared_ptr<chain::asset_cert> blockchain_asset_cert_database::get(const has
 }
 
 std::shared_ptr<std::vector<chain::asset_cert>> blockchain_asset_cert_database::get_blockchain_asset_certs() const
+{
+    return get_blockchain_asset_certs_page("");
+}
+
+std::shared_ptr<std::vector<chain::asset_cert>> blockchain_asset_cert_database::get_blockchain_asset_certs_page(
+    const std::string& prefix, const std::string& after, size_t limit) const
 {
     auto vec_acc = std::make_shared<std::vector<chain::asset_cert>>();
-    for( uint64_t i = 0; i < number_buckets; i++ ) {
-        auto memo = lookup_map_.find(i);
-        if (memo->size()) {
-            const auto action = [&](memory_ptr elem)
-            {
-                const auto memory = REMAP_ADDRESS(elem);
-                auto deserial = make_deserializer_unsafe(memory);
-                vec_acc->push_back(chain::asset_cert::factory_from_data(deserial));
-            };
-            std::for_each(memo->begin(), memo->end(), action);
+    for (const auto& key : symbols_.scan(prefix, after, limit)) {
+        for (const auto& elem : lookup_map_.finds(key)) {
+            const auto memory = REMAP_ADDRESS(elem);
+            auto deserial = make_deserializer_unsafe(memory);
+            vec_acc->push_back(chain::asset_cert::factory_from_data(deserial));
         }
     }
     return vec_acc;
@@ -167,8 +174,22 @@ void blockchain_asset_cert_database::store(const chain::asset_cert& sp_cert)
         serial.write_data(sp_cert.to_data());
     };
     lookup_map_.store(key, write, value_size);
+    symbols_.insert(key_str, key);
 }
 
+// Walks every bucket once to build the symbol index.
+void blockchain_asset_cert_database::load_symbols(symbol_index::visitor visit) const
+{
+    for (uint64_t i = 0; i < number_buckets; i++) {
+        auto memo = lookup_map_.find(i);
+        for (const auto& elem : *memo) {
+            const auto memory = REMAP_ADDRESS(elem);
+            auto deserial = make_deserializer_unsafe(memory);
+            const auto symbol = chain::asset_cert::factory_from_data(deserial).get_key();
+            visit(symbol, sha256_hash(data_chunk(symbol.begin(), symbol.end())));
+        }
+    }
+}
 
 } // namespace database
 } // namespace libbitcoin
@@ -42,7 +42,8 @@ blockchain_asset_database::blockchain_asset_database(const path& map_filename,
   : lookup_file_(map_filename, mutex),
     lookup_header_(lookup_file_, number_buckets),
     lookup_manager_(lookup_file_, header_size),
-    lookup_map_(lookup_header_, lookup_manager_)
+    lookup_map_(lookup_header_, lookup_manager_),
+    symbols_(std::bind(&blockchain_asset_database::load_symbols, this, std::placeholders::_1))
 {
 }
 
@@ -69,6 +70,8 @@ bool blockchain_asset_database::create()
         !lookup_manager_.create())
         return false;
 
+    symbols_.clear();
+
     // Should not call start after create, already started.
     return
         lookup_header_.start() &&
@@ -105,6 +108,9 @@ void blockchain_asset_database::remove(const hash_digest& hash)
 {
     DEBUG_ONLY(bool success =) lookup_map_.unlink(hash);
     BITCOIN_ASSERT(success);
+
+    if (!lookup_map_.find(hash))
+        symbols_.erase(hash);
 }
 
 void blockchain_asset_database::sync()
@@ -151,19 +157,19 @@ std::shared_ptr<std::vector<chain::blockchain_asset>> blockchain_asset_database:
         return get_asset_history(asset_symbol);
     }
 
+    return get_blockchain_assets_page("");
+}
+
+std::shared_ptr<std::vector<chain::blockchain_asset>> blockchain_asset_database::get_blockchain_assets_page(
+    const std::string& prefix, const std::string& after, size_t limit,
+    const symbol_index::filter& exclude) const
+{
     auto vec_acc = std::make_shared<std::vector<chain::blockchain_asset>>();
-    uint64_t i = 0;
-    for( i = 0; i < number_buckets; i++ ) {
-        auto memo = lookup_map_.find(i);
-        //log::debug("get_accounts size=")<<memo->size();
-        if (memo->size()) {
-            const auto action = [&](memory_ptr elem)
-            {
-                const auto memory = REMAP_ADDRESS(elem);
-                auto deserial = make_deserializer_unsafe(memory);
-                vec_acc->push_back(chain::blockchain_asset::factory_from_data(deserial));
-            };
-            std::for_each(memo->begin(), memo->end(), action);
+    for (const auto& key : symbols_.scan(prefix, after, limit, 0, exclude)) {
+        for (const auto& elem : lookup_map_.finds(key)) {
+            const auto memory = REMAP_ADDRESS(elem);
+            auto deserial = make_deserializer_unsafe(memory);
+            vec_acc->push_back(chain::blockchain_asset::factory_from_data(deserial));
         }
     }
     return vec_acc;
@@ -234,8 +240,22 @@ void blockchain_asset_database::store(const hash_digest& hash, const chain::bloc
         serial.write_data(sp_detail.to_data());
     };
     lookup_map_.store(key, write, value_size);
+    symbols_.insert(sp_detail.get_asset().get_symbol(), key);
 }
 
+// Walks every bucket once to build the symbol index.
+void blockchain_asset_database::load_symbols(symbol_index::visitor visit) const
+{
+    for (uint64_t i = 0; i < number_buckets; i++) {
+        auto memo = lookup_map_.find(i);
+        for (const auto& elem : *memo) {
+            const auto memory = REMAP_ADDRESS(elem);
+            auto deserial = make_deserializer_unsafe(memory);
+            const auto symbol = chain::blockchain_asset::factory_from_data(deserial).get_asset().get_symbol();
+            visit(symbol, sha256_hash(data_chunk(symbol.begin(), symbol.end())));
+        }
+    }
+}
 
 } // namespace database
 } // namespace libbitcoin
@@ -42,7 +42,8 @@ blockchain_did_database::blockchain_did_database(const path& map_filename,
   : lookup_file_(map_filename, mutex),
     lookup_header_(lookup_file_, number_buckets),
     lookup_manager_(lookup_file_, header_size),
-    lookup_map_(lookup_header_, lookup_manager_)
+    lookup_map_(lookup_header_, lookup_manager_),
+    symbols_(std::bind(&blockchain_did_database::load_symbols, this, std::placeholders::_1))
 {
 }
 
@@ -69,6 +70,8 @@ bool blockchain_did_database::create()
         !lookup_manager_.create())
         return false;
 
+    symbols_.clear();
+
     // Should not call start after create, already started.
     return
         lookup_header_.start() &&
@@ -105,6 +108,9 @@ void blockchain_did_database::remove(const hash_digest& hash)
 {
     DEBUG_ONLY(bool success =) lookup_map_.unlink(hash);
     BITCOIN_ASSERT(success);
+
+    if (!lookup_map_.find(hash))
+        symbols_.erase(hash);
 }
 
 void blockchain_did_database::sync()
@@ -147,26 +153,31 @@ std::shared_ptr<std::vector<chain::blockchain_did>> blockchain_did_database::get
 
 ///
 std::shared_ptr<std::vector<chain::blockchain_did>> blockchain_did_database::get_blockchain_dids() const
+{
+    return get_blockchain_dids_page("");
+}
+
+std::shared_ptr<std::vector<chain::blockchain_did>> blockchain_did_database::get_blockchain_dids_page(
+    const std::string& prefix, const std::string& after, size_t limit,
+    size_t skip) const
 {
     auto vec_acc = std::make_shared<std::vector<chain::blockchain_did>>();
-    uint64_t i = 0;
-    for( i = 0; i < number_buckets; i++ ) {
-        auto memo = lookup_map_.find(i);
-        //log::debug("get_accounts size=")<<memo->size();
-        if(memo->size())
-        {
-            const auto action = [&](memory_ptr elem)
-            {
-                const auto memory = REMAP_ADDRESS(elem);
-                auto deserial = make_deserializer_unsafe(memory);
-                vec_acc->push_back(chain::blockchain_did::factory_from_data(deserial));
-            };
-            std::for_each(memo->begin(), memo->end(), action);
+    for (const auto& key : symbols_.scan(prefix, after, limit, skip)) {
+        for (const auto& elem : lookup_map_.finds(key)) {
+            const auto memory = REMAP_ADDRESS(elem);
+            auto deserial = make_deserializer_unsafe(memory);
+            vec_acc->push_back(chain::blockchain_did::factory_from_data(deserial));
         }
     }
     return vec_acc;
 }
 
+size_t blockchain_did_database::get_blockchain_dids_count(
+    const std::string& prefix, const std::string& after) const
+{
+    return symbols_.size(prefix, after);
+}
+
 ///
 std::shared_ptr<chain::blockchain_did> blockchain_did_database::get_register_history(const std::string & did_symbol) const
 {
@@ -217,6 +228,7 @@ void blockchain_did_database::store(const hash_digest& hash, const chain::blockc
         serial.write_data(sp_detail.to_data());
     };
     lookup_map_.store(key, write, value_size);
+    symbols_.insert(sp_detail.get_did().get_symbol(), key);
 }
 
 std::shared_ptr<chain::blockchain_did> blockchain_did_database::update_address_status(const hash_digest &hash,uint32_t status )
@@ -285,5 +297,19 @@ std::shared_ptr<chain::blockchain_did> blockchain_did_database::pop_did_transfer
     return update_address_status(hash, chain::blockchain_did::address_current);
 }
 
+// Walks every bucket once to build the symbol index.
+void blockchain_did_database::load_symbols(symbol_index::visitor visit) const
+{
+    for (uint64_t i = 0; i < number_buckets; i++) {
+        auto memo = lookup_map_.find(i);
+        for (const auto& elem : *memo) {
+            const auto memory = REMAP_ADDRESS(elem);
+            auto deserial = make_deserializer_unsafe(memory);
+            const auto symbol = chain::blockchain_did::factory_from_data(deserial).get_did().get_symbol();
+            visit(symbol, sha256_hash(data_chunk(symbol.begin(), symbol.end())));
+        }
+    }
+}
+
 } // namespace database
 } // namespace libbitcoin
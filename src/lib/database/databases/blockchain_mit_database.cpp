@@ -40,7 +40,8 @@ blockchain_mit_database::blockchain_mit_database(const path& map_filename,
   : lookup_file_(map_filename, mutex),
     lookup_header_(lookup_file_, number_buckets),
     lookup_manager_(lookup_file_, header_size),
-    lookup_map_(lookup_header_, lookup_manager_)
+    lookup_map_(lookup_header_, lookup_manager_),
+    symbols_(std::bind(&blockchain_mit_database::load_symbols, this, std::placeholders::_1))
 {
 }
 
@@ -67,6 +68,8 @@ bool blockchain_mit_database::create()
         !lookup_manager_.create())
         return false;
 
+    symbols_.clear();
+
     // Should not call start after create, already started.
     return
         lookup_header_.start() &&
@@ -103,6 +106,9 @@ void blockchain_mit_database::remove(const hash_digest& hash)
 {
     DEBUG_ONLY(bool success =) lookup_map_.unlink(hash);
     BITCOIN_ASSERT(success);
+
+    if (!lookup_map_.find(hash))
+        symbols_.erase(hash);
 }
 
 void blockchain_mit_database::sync()
@@ -126,18 +132,19 @@ std::shared_ptr<chain::asset_mit_info> blockchain_mit_database::get(const hash_d
 }
 
 std::shared_ptr<chain::asset_mit_info::list> blockchain_mit_database::get_blockchain_mits() const
+{
+    return get_blockchain_mits_page("");
+}
+
+std::shared_ptr<chain::asset_mit_info::list> blockchain_mit_database::get_blockchain_mits_page(
+    const std::string& prefix, const std::string& after, size_t limit) const
 {
     auto vec_acc = std::make_shared<std::vector<chain::asset_mit_info>>();
-    for( uint64_t i = 0; i < number_buckets; i++ ) {
-        auto memo = lookup_map_.find(i);
-        if (memo->size()) {
-            const auto action = [&vec_acc](memory_ptr elem)
-            {
-                const auto memory = REMAP_ADDRESS(elem);
-                auto deserial = make_deserializer_unsafe(memory);
-                vec_acc->push_back(chain::asset_mit_info::factory_from_data(deserial));
-            };
-            std::for_each(memo->begin(), memo->end(), action);
+    for (const auto& key : symbols_.scan(prefix, after, limit)) {
+        for (const auto& elem : lookup_map_.finds(key)) {
+            const auto memory = REMAP_ADDRESS(elem);
+            auto deserial = make_deserializer_unsafe(memory);
+            vec_acc->push_back(chain::asset_mit_info::factory_from_data(deserial));
         }
     }
     return vec_acc;
@@ -193,8 +200,22 @@ void blockchain_mit_database::store(const chain::asset_mit_info& mit_info)
         serial.write_data(mit_info.to_data());
     };
     lookup_map_.store(key, write, value_size);
+    symbols_.insert(key_str, key);
 }
 
+// Walks every bucket once to build the symbol index.
+void blockchain_mit_database::load_symbols(symbol_index::visitor visit) const
+{
+    for (uint64_t i = 0; i < number_buckets; i++) {
+        auto memo = lookup_map_.find(i);
+        for (const auto& elem : *memo) {
+            const auto memory = REMAP_ADDRESS(elem);
+            auto deserial = make_deserializer_unsafe(memory);
+            const auto symbol = chain::asset_mit_info::factory_from_data(deserial).mit.get_symbol();
+            visit(symbol, sha256_hash(data_chunk(symbol.begin(), symbol.end())));
+        }
+    }
+}
 
 } // namespace database
 } // namespace libbitcoin
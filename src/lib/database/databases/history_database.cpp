@@ -20,14 +20,13 @@
  */
 #include <metaverse/database/databases/history_database.hpp>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstddef>
 #include <memory>
 #include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/database/memory/memory.hpp>
-#include <metaverse/database/primitives/record_multimap_iterable.hpp>
-#include <metaverse/database/primitives/record_multimap_iterator.hpp>
 
 namespace libbitcoin {
 namespace database {
@@ -39,21 +38,132 @@ BC_CONSTEXPR size_t number_buckets = 97210744;
 BC_CONSTEXPR size_t header_size = record_hash_table_header_size(number_buckets);
 BC_CONSTEXPR size_t initial_lookup_file_size = header_size + minimum_records_size;
 
-BC_CONSTEXPR size_t record_size = hash_table_multimap_record_size<short_hash>();
+BC_CONSTEXPR size_t value_size = sizeof(file_offset);
+BC_CONSTEXPR size_t record_size = hash_table_record_size<short_hash>(value_size);
 
-BC_CONSTEXPR size_t value_size = 1 + 36 + 4 + 8;
-BC_CONSTEXPR size_t row_record_size = hash_table_record_size<hash_digest>(value_size);
+// Valid file offsets should never be zero.
+BC_CONSTEXPR file_offset empty_page = 0;
+
+// Pages double in capacity from the first, most addresses have few rows.
+BC_CONSTEXPR uint16_t minimum_capacity = 2;
+BC_CONSTEXPR uint16_t maximum_capacity = 128;
+
+// Page format:
+//  [ previous:8            ]
+//  [ capacity:2            ]
+//  [ count:2               ]
+//  [ height:4  * capacity  ]
+//  [ kind:1    * capacity  ]
+//  [ point:36  * capacity  ]
+//  [ value:8   * capacity  ]
+// Rows are in the order added, so heights are ascending within a page and
+// every row of a page is at or above the heights of the previous page.
+
+BC_CONSTEXPR size_t page_header_size = 8 + 2 + 2;
+BC_CONSTEXPR size_t point_size = 36;
+BC_CONSTEXPR size_t row_size = 4 + 1 + point_size + 8;
+
+static size_t page_size(uint16_t capacity)
+{
+    return page_header_size + capacity * row_size;
+}
+
+static uint8_t* height_column(uint8_t* page, uint16_t)
+{
+    return page + page_header_size;
+}
+
+static uint8_t* kind_column(uint8_t* page, uint16_t capacity)
+{
+    return height_column(page, capacity) + capacity * 4;
+}
+
+static uint8_t* point_column(uint8_t* page, uint16_t capacity)
+{
+    return kind_column(page, capacity) + capacity * 1;
+}
+
+static uint8_t* value_column(uint8_t* page, uint16_t capacity)
+{
+    return point_column(page, capacity) + capacity * point_size;
+}
+
+static uint32_t read_height(uint8_t* page, uint16_t capacity, uint16_t slot)
+{
+    const auto address = height_column(page, capacity) + slot * 4;
+    return from_little_endian_unsafe<uint32_t>(address);
+}
+
+// The first slot of the page at or above the height, heights are ascending.
+static uint16_t lower_bound(uint8_t* page, uint16_t capacity, uint16_t count,
+    size_t height)
+{
+    uint16_t low = 0;
+    auto high = count;
+
+    while (low < high)
+    {
+        const uint16_t middle = low + (high - low) / 2;
+        if (read_height(page, capacity, middle) < height)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+// Write a row to an unused slot of the page.
+static void write_row(uint8_t* page, uint16_t capacity, uint16_t slot,
+    point_kind kind, const point& point, uint32_t height, uint64_t value)
+{
+    auto height_serial = make_serializer(height_column(page, capacity) +
+        slot * 4);
+    height_serial.write_4_bytes_little_endian(height);
+
+    kind_column(page, capacity)[slot] = static_cast<uint8_t>(kind);
+
+    auto point_serial = make_serializer(point_column(page, capacity) +
+        slot * point_size);
+    point_serial.write_data(point.to_data());
+
+    auto value_serial = make_serializer(value_column(page, capacity) +
+        slot * 8);
+    value_serial.write_8_bytes_little_endian(value);
+}
+
+// Read a row from the page for the history list.
+static history_compact read_row(uint8_t* page, uint16_t capacity,
+    uint16_t slot)
+{
+    auto deserial = make_deserializer_unsafe(point_column(page, capacity) +
+        slot * point_size);
+    const auto value_address = value_column(page, capacity) + slot * 8;
+
+    return history_compact
+    {
+        // output or spend?
+        static_cast<point_kind>(kind_column(page, capacity)[slot]),
+
+        // point
+        point::factory_from_data(deserial),
+
+        // height
+        read_height(page, capacity, slot),
+
+        // value or checksum
+        { from_little_endian_unsafe<uint64_t>(value_address) }
+    };
+}
 
 history_database::history_database(const path& lookup_filename,
-    const path& rows_filename, std::shared_ptr<shared_mutex> mutex)
+    const path& pages_filename, std::shared_ptr<shared_mutex> mutex)
   : lookup_file_(lookup_filename, mutex),
     lookup_header_(lookup_file_, number_buckets),
     lookup_manager_(lookup_file_, header_size, record_size),
     lookup_map_(lookup_header_, lookup_manager_),
-    rows_file_(rows_filename, mutex),
-    rows_manager_(rows_file_, 0, row_record_size),
-    rows_list_(rows_manager_),
-    rows_multimap_(lookup_map_, rows_list_)
+    pages_file_(pages_filename, mutex),
+    pages_manager_(pages_file_, 0)
 {
 }
 
@@ -71,23 +181,23 @@ bool history_database::create()
 {
     // Resize and create require a started file.
     if (!lookup_file_.start() ||
-        !rows_file_.start())
+        !pages_file_.start())
         return false;
 
     // These will throw if insufficient disk space.
     lookup_file_.resize(initial_lookup_file_size);
-    rows_file_.resize(minimum_records_size);
+    pages_file_.resize(minimum_slabs_size);
 
     if (!lookup_header_.create() ||
         !lookup_manager_.create() ||
-        !rows_manager_.create())
+        !pages_manager_.create())
         return false;
 
     // Should not call start after create, already started.
     return
         lookup_header_.start() &&
         lookup_manager_.start() &&
-        rows_manager_.start();
+        pages_manager_.start();
 }
 
 // Startup and shutdown.
@@ -97,24 +207,24 @@ bool history_database::start()
 {
     return
         lookup_file_.start() &&
-        rows_file_.start() &&
+        pages_file_.start() &&
         lookup_header_.start() &&
         lookup_manager_.start() &&
-        rows_manager_.start();
+        pages_manager_.start();
 }
 
 bool history_database::stop()
 {
     return
         lookup_file_.stop() &&
-        rows_file_.stop();
+        pages_file_.stop();
 }
 
 bool history_database::close()
 {
     return
         lookup_file_.close() &&
-        rows_file_.close();
+        pages_file_.close();
 }
 
 // ----------------------------------------------------------------------------
@@ -122,95 +232,272 @@ bool history_database::close()
 void history_database::add_output(const short_hash& key,
     const output_point& outpoint, uint32_t output_height, uint64_t value)
 {
-    auto write = [&](memory_ptr data)
-    {
-        auto serial = make_serializer(REMAP_ADDRESS(data));
-        serial.write_byte(static_cast<uint8_t>(point_kind::output));
-        serial.write_data(outpoint.to_data());
-        serial.write_4_bytes_little_endian(output_height);
-        serial.write_8_bytes_little_endian(value);
-    };
-    rows_multimap_.add_row(key, write);
+    add_row(key, point_kind::output, outpoint, output_height, value);
 }
 
 void history_database::add_input(const short_hash& key,
     const output_point& inpoint, uint32_t input_height,
     const input_point& previous)
 {
-    auto write = [&](memory_ptr data)
+    add_row(key, point_kind::spend, inpoint, input_height,
+        previous.checksum());
+}
+
+void history_database::add_row(const short_hash& key, point_kind kind,
+    const point& point, uint32_t height, uint64_t value)
+{
+    const auto head_memory = lookup_map_.find(key);
+
+    if (!head_memory)
     {
-        auto serial = make_serializer(REMAP_ADDRESS(data));
-        serial.write_byte(static_cast<uint8_t>(point_kind::spend));
-        serial.write_data(inpoint.to_data());
-        serial.write_4_bytes_little_endian(input_height);
-        serial.write_8_bytes_little_endian(previous.checksum());
-    };
-    rows_multimap_.add_row(key, write);
+        const auto position = new_page(empty_page, minimum_capacity);
+        const auto memory = pages_manager_.get(position);
+        const auto page = REMAP_ADDRESS(memory);
+        write_row(page, minimum_capacity, 0, kind, point, height, value);
+        auto serial = make_serializer(page + 8 + 2);
+        serial.write_2_bytes_little_endian(1);
+
+        const auto write = [position](memory_ptr data)
+        {
+            auto serial = make_serializer(REMAP_ADDRESS(data));
+            serial.write_8_bytes_little_endian(position);
+        };
+        lookup_map_.store(key, write);
+        return;
+    }
+
+    const auto head_address = REMAP_ADDRESS(head_memory);
+    uint16_t capacity;
+
+    // The accessor must be released before a page may be allocated.
+    {
+        ///////////////////////////////////////////////////////////////////////
+        mutex_.lock_shared();
+        const auto head = from_little_endian_unsafe<file_offset>(head_address);
+        mutex_.unlock_shared();
+        ///////////////////////////////////////////////////////////////////////
+
+        const auto memory = pages_manager_.get(head);
+        const auto page = REMAP_ADDRESS(memory);
+        capacity = from_little_endian_unsafe<uint16_t>(page + 8);
+
+        ///////////////////////////////////////////////////////////////////////
+        mutex_.lock_shared();
+        const auto count = from_little_endian_unsafe<uint16_t>(page + 8 + 2);
+        mutex_.unlock_shared();
+        ///////////////////////////////////////////////////////////////////////
+
+        if (count < capacity)
+        {
+            write_row(page, capacity, count, kind, point, height, value);
+            auto serial = make_serializer(page + 8 + 2);
+
+            // Critical Section
+            ///////////////////////////////////////////////////////////////////
+            unique_lock lock(mutex_);
+            serial.write_2_bytes_little_endian(count + 1);
+            return;
+            ///////////////////////////////////////////////////////////////////
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_shared();
+    const auto head = from_little_endian_unsafe<file_offset>(head_address);
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    const auto next_capacity = static_cast<uint16_t>(
+        std::min<size_t>(capacity * 2u, maximum_capacity));
+    const auto position = new_page(head, next_capacity);
+    const auto memory = pages_manager_.get(position);
+    const auto page = REMAP_ADDRESS(memory);
+    write_row(page, next_capacity, 0, kind, point, height, value);
+    auto count_serial = make_serializer(page + 8 + 2);
+    count_serial.write_2_bytes_little_endian(1);
+
+    auto serial = make_serializer(head_address);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+    serial.write_8_bytes_little_endian(position);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+file_offset history_database::new_page(file_offset previous,
+    uint16_t capacity)
+{
+    const auto position = pages_manager_.new_slab(page_size(capacity));
+    const auto memory = pages_manager_.get(position);
+    auto serial = make_serializer(REMAP_ADDRESS(memory));
+    serial.write_8_bytes_little_endian(previous);
+    serial.write_2_bytes_little_endian(capacity);
+    serial.write_2_bytes_little_endian(0);
+    return position;
 }
 
 void history_database::delete_last_row(const short_hash& key)
 {
-    rows_multimap_.delete_last_row(key);
+    file_offset previous;
+
+    // The accessor must be released before the key may be unlinked.
+    {
+        const auto head_memory = lookup_map_.find(key);
+        if (!head_memory)
+            return;
+
+        const auto head_address = REMAP_ADDRESS(head_memory);
+
+        ///////////////////////////////////////////////////////////////////////
+        mutex_.lock_shared();
+        const auto head = from_little_endian_unsafe<file_offset>(head_address);
+        mutex_.unlock_shared();
+        ///////////////////////////////////////////////////////////////////////
+
+        const auto memory = pages_manager_.get(head);
+        const auto page = REMAP_ADDRESS(memory);
+        previous = from_little_endian_unsafe<file_offset>(page);
+
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        unique_lock lock(mutex_);
+        const auto count = from_little_endian_unsafe<uint16_t>(page + 8 + 2);
+        BITCOIN_ASSERT(count > 0);
+
+        if (count > 1)
+        {
+            auto serial = make_serializer(page + 8 + 2);
+            serial.write_2_bytes_little_endian(count - 1);
+            return;
+        }
+
+        // The emptied page is abandoned, as are deleted rows elsewhere.
+        if (previous != empty_page)
+        {
+            auto serial = make_serializer(head_address);
+            serial.write_8_bytes_little_endian(previous);
+            return;
+        }
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    DEBUG_ONLY(bool success =) lookup_map_.unlink(key);
+    BITCOIN_ASSERT(success);
 }
 
 history_compact::list history_database::get(const short_hash& key,
     size_t limit, size_t from_height) const
 {
-    // Read the height value from the row.
-    const auto read_height = [](uint8_t* data)
-    {
-        static constexpr file_offset height_position = 1 + 36;
-        const auto height_address = data + height_position;
-        return from_little_endian_unsafe<uint32_t>(height_address);
-    };
-
-    // Read a row from the data for the history list.
-    const auto read_row = [](uint8_t* data)
+    history_compact::list result;
+    const auto head_memory = lookup_map_.find(key);
+    if (!head_memory)
+        return result;
+
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_shared();
+    auto position = from_little_endian_unsafe<file_offset>(
+        REMAP_ADDRESS(head_memory));
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    while (position != empty_page)
     {
-        auto deserial = make_deserializer_unsafe(data);
-        return history_compact
+        // This obtains a remap safe address pointer against the pages file.
+        const auto memory = pages_manager_.get(position);
+        const auto page = REMAP_ADDRESS(memory);
+        const auto capacity = from_little_endian_unsafe<uint16_t>(page + 8);
+
+        ///////////////////////////////////////////////////////////////////////
+        mutex_.lock_shared();
+        const auto count = from_little_endian_unsafe<uint16_t>(page + 8 + 2);
+        mutex_.unlock_shared();
+        ///////////////////////////////////////////////////////////////////////
+
+        const auto first = from_height == 0 ? 0 :
+            lower_bound(page, capacity, count, from_height);
+
+        // Rows are returned newest first.
+        for (auto slot = count; slot > first; --slot)
         {
-            // output or spend?
-            static_cast<point_kind>(deserial.read_byte()),
+            // Stop once we reach the limit (if specified).
+            if (limit > 0 && result.size() >= limit)
+                return result;
 
-            // point
-            point::factory_from_data(deserial),
+            result.emplace_back(read_row(page, capacity, slot - 1));
+        }
 
-            // height
-            deserial.read_4_bytes_little_endian(),
+        // Rows of all previous pages are below from_height.
+        if (first > 0)
+            break;
 
-            // value or checksum
-            { deserial.read_8_bytes_little_endian() }
-        };
-    };
+        position = from_little_endian_unsafe<file_offset>(page);
+    }
 
-    history_compact::list result;
-    const auto start = rows_multimap_.lookup(key);
-    const auto records = record_multimap_iterable(rows_list_, start);
+    return result;
+}
 
-    for (const auto& index: records)
+history_compact::list history_database::get(const short_hash& key,
+    size_t limit, size_t from_height, size_t to_height) const
+{
+    history_compact::list result;
+    const auto head_memory = lookup_map_.find(key);
+    if (!head_memory || to_height < from_height)
+        return result;
+
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_shared();
+    auto position = from_little_endian_unsafe<file_offset>(
+        REMAP_ADDRESS(head_memory));
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    while (position != empty_page)
     {
-        // Stop once we reach the limit (if specified).
-        if (limit > 0 && result.size() >= limit)
-            break;
+        // This obtains a remap safe address pointer against the pages file.
+        const auto memory = pages_manager_.get(position);
+        const auto page = REMAP_ADDRESS(memory);
+        const auto capacity = from_little_endian_unsafe<uint16_t>(page + 8);
+        position = from_little_endian_unsafe<file_offset>(page);
+
+        ///////////////////////////////////////////////////////////////////////
+        mutex_.lock_shared();
+        const auto count = from_little_endian_unsafe<uint16_t>(page + 8 + 2);
+        mutex_.unlock_shared();
+        ///////////////////////////////////////////////////////////////////////
+
+        // Skip the page if all of its rows are above to_height.
+        if (count == 0 || read_height(page, capacity, 0) > to_height)
+            continue;
+
+        const auto first = from_height == 0 ? 0 :
+            lower_bound(page, capacity, count, from_height);
+        const auto end = to_height == max_size_t ? count :
+            lower_bound(page, capacity, count, to_height + 1);
+
+        for (auto slot = end; slot > first; --slot)
+        {
+            // Stop once the limit is reached and the last height complete.
+            if (limit > 0 && result.size() >= limit &&
+                read_height(page, capacity, slot - 1) !=
+                result.back().height)
+                return result;
 
-        // This obtains a remap safe address pointer against the rows file.
-        const auto record = rows_list_.get(index);
-        const auto address = REMAP_ADDRESS(record);
+            result.emplace_back(read_row(page, capacity, slot - 1));
+        }
 
-        // Skip rows below from_height.
-        if (from_height == 0 || read_height(address) >= from_height)
-            result.emplace_back(read_row(address));
+        // Rows of all previous pages are below from_height.
+        if (first > 0)
+            break;
     }
 
-    // TODO: we could sort result here.
     return result;
 }
 
 void history_database::sync()
 {
     lookup_manager_.sync();
-    rows_manager_.sync();
+    pages_manager_.sync();
 }
 
 history_statinfo history_database::statinfo() const
@@ -219,7 +506,7 @@ history_statinfo history_database::statinfo() const
     {
         lookup_header_.size(),
         lookup_manager_.count(),
-        rows_manager_.count()
+        pages_manager_.payload_size()
     };
 }
 
@@ -42,9 +42,10 @@ BC_CONSTEXPR size_t value_size = std::tuple_size<chain::point>::value;
 BC_CONSTEXPR size_t record_size = hash_table_record_size<chain::point>(value_size);
 
 spend_database::spend_database(const path& filename,
-    std::shared_ptr<shared_mutex> mutex)
+    const path& growth_filename, std::shared_ptr<shared_mutex> mutex)
   : lookup_file_(filename, mutex),
-    lookup_header_(lookup_file_, number_buckets),
+    growth_file_(growth_filename, mutex),
+    lookup_header_(lookup_file_, growth_file_, number_buckets),
     lookup_manager_(lookup_file_, header_size, record_size),
     lookup_map_(lookup_header_, lookup_manager_)
 {
@@ -62,8 +63,9 @@ spend_database::~spend_database()
 // Initialize files and start.
 bool spend_database::create()
 {
-    // Resize and create require a started file.
-    if (!lookup_file_.start())
+    // Resize and create require started files.
+    if (!lookup_file_.start() ||
+        !growth_file_.start())
         return false;
 
     // This will throw if insufficient disk space.
@@ -86,18 +88,37 @@ bool spend_database::start()
 {
     return
         lookup_file_.start() &&
+        growth_file_.start() &&
         lookup_header_.start() &&
         lookup_manager_.start();
 }
 
 bool spend_database::stop()
 {
-    return lookup_file_.stop();
+    return
+        lookup_file_.stop() &&
+        growth_file_.stop();
 }
 
 bool spend_database::close()
 {
-    return lookup_file_.close();
+    return
+        lookup_file_.close() &&
+        growth_file_.close();
+}
+
+// Convert a lookup table created with a fixed bucket count (offline).
+// The existing buckets remain in place, so only entries are counted.
+bool spend_database::convert()
+{
+    if (!lookup_file_.start() ||
+        !growth_file_.start() ||
+        !lookup_header_.convert() ||
+        !lookup_manager_.start())
+        return false;
+
+    lookup_header_.set_entries(lookup_map_.count());
+    return true;
 }
 
 // ----------------------------------------------------------------------------
@@ -20,6 +20,8 @@
  */
 #include <metaverse/database/databases/stealth_database.hpp>
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -41,6 +43,17 @@ constexpr size_t prefix_size = sizeof(uint32_t);
 constexpr size_t row_size = prefix_size + height_size + hash_size +
     short_hash_size + hash_size;
 
+// Rows are appended in block order, so a run of rows spans few heights.
+constexpr size_t segment_rows = 1024;
+constexpr size_t prefix_bits = prefix_size * byte_bits;
+
+// The stored prefix as a key whose high order bit is the first filter bit.
+static uint32_t to_prefix_key(uint32_t prefix)
+{
+    const auto bytes = to_little_endian(prefix);
+    return from_big_endian_unsafe<uint32_t>(bytes.begin());
+}
+
 stealth_database::stealth_database(const path& rows_filename,
     std::shared_ptr<shared_mutex> mutex)
   : rows_file_(rows_filename, mutex),
@@ -71,7 +84,11 @@ bool stealth_database::create()
         return false;
 
     // Should not call start after create, already started.
-    return rows_manager_.start();
+    if (!rows_manager_.start())
+        return false;
+
+    load_index();
+    return true;
 }
 
 // Startup and shutdown.
@@ -79,9 +96,11 @@ bool stealth_database::create()
 
 bool stealth_database::start()
 {
-    return
-        rows_file_.start() &&
-        rows_manager_.start();
+    if (!rows_file_.start() || !rows_manager_.start())
+        return false;
+
+    load_index();
+    return true;
 }
 
 bool stealth_database::stop()
@@ -94,45 +113,157 @@ bool stealth_database::close()
     return rows_file_.close();
 }
 
+// Index.
+// ----------------------------------------------------------------------------
+
+void stealth_database::load_index()
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(index_mutex_);
+
+    prefixes_.clear();
+    segments_.clear();
+
+    const auto count = rows_manager_.count();
+    prefixes_.reserve(count);
+
+    for (array_index row = 0; row < count; ++row)
+    {
+        const auto memory = rows_manager_.get(row);
+        const auto record = REMAP_ADDRESS(memory);
+        const auto prefix = from_little_endian_unsafe<uint32_t>(record);
+        const auto height = from_little_endian_unsafe<uint32_t>(
+            record + prefix_size);
+        index_row(prefix, height);
+    }
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Call under exclusive index lock, after the row has been allocated.
+void stealth_database::index_row(uint32_t prefix, uint32_t height)
+{
+    if (prefixes_.size() % segment_rows == 0)
+        segments_.push_back({ height, height });
+
+    auto& last = segments_.back();
+    last.min_height = std::min(last.min_height, height);
+    last.max_height = std::max(last.max_height, height);
+    prefixes_.push_back(to_prefix_key(prefix));
+}
+
+// Call under exclusive index lock, recomputes the bounds of the last segment.
+void stealth_database::truncate_index(array_index count)
+{
+    prefixes_.resize(count);
+    segments_.resize((count + segment_rows - 1) / segment_rows);
+
+    if (segments_.empty())
+        return;
+
+    const auto first = (segments_.size() - 1) * segment_rows;
+    auto& last = segments_.back();
+    last.min_height = read_height(first);
+    last.max_height = last.min_height;
+
+    for (auto row = first + 1; row < count; ++row)
+    {
+        const auto height = read_height(row);
+        last.min_height = std::min(last.min_height, height);
+        last.max_height = std::max(last.max_height, height);
+    }
+}
+
+uint32_t stealth_database::read_height(array_index row) const
+{
+    const auto memory = rows_manager_.get(row);
+    const auto record = REMAP_ADDRESS(memory);
+    return from_little_endian_unsafe<uint32_t>(record + prefix_size);
+}
+
+// Query.
 // ----------------------------------------------------------------------------
 
 // The prefix is fixed at 32 bits, but the filter is 0-32 bits, so the records
-// cannot be indexed using a hash table. We also do not index by height.
+// cannot be indexed using a hash table. Instead the packed prefix column of
+// each segment reaching from_height is matched against the filter as a
+// masked compare, and only matching rows are read from the file.
 stealth_compact::list stealth_database::scan(const binary& filter,
     size_t from_height) const
 {
     stealth_compact::list result;
 
-    for (array_index row = 0; row < rows_manager_.count(); ++row)
+    // A filter longer than the prefix must also match its zero padding.
+    const auto bits = filter.size();
+    const auto exact = bits <= prefix_bits;
+    const uint32_t mask = bits == 0 ? 0 :
+        (exact ? max_uint32 << (prefix_bits - bits) : max_uint32);
+
+    byte_array<prefix_size> head{ { 0 } };
+    const auto& blocks = filter.blocks();
+    std::copy_n(blocks.begin(), std::min(blocks.size(), prefix_size),
+        head.begin());
+    const auto target = from_big_endian_unsafe<uint32_t>(head.begin()) & mask;
+
+    std::array<uint8_t, segment_rows> hits;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(index_mutex_);
+
+    for (size_t index = 0; index < segments_.size(); ++index)
     {
-        const auto memory = rows_manager_.get(row);
-        auto record = REMAP_ADDRESS(memory);
+        const auto& bounds = segments_[index];
 
-        // Skip if prefix doesn't match.
-        const auto field = from_little_endian_unsafe<uint32_t>(record);
-        if (!filter.is_prefix_of(field))
+        // Skip if all heights are too low.
+        if (bounds.max_height < from_height)
             continue;
 
-        // Skip if height is too low.
-        record += prefix_size;
-        const auto height = from_little_endian_unsafe<uint32_t>(record);
-        if (height < from_height)
-            continue;
+        const auto first = index * segment_rows;
+        const auto rows = std::min(segment_rows, prefixes_.size() - first);
+        const auto keys = prefixes_.data() + first;
+
+        // Branch free so that the compiler vectorizes the comparison.
+        for (size_t row = 0; row < rows; ++row)
+            hits[row] = static_cast<uint8_t>((keys[row] & mask) == target);
 
-        // Add row to results.
-        auto deserial = make_deserializer_unsafe(record + height_size);
-        result.push_back(
+        for (size_t row = 0; row < rows; ++row)
         {
-            deserial.read_hash(),
-            deserial.read_short_hash(),
-            deserial.read_hash()
-        });
+            if (hits[row] == 0)
+                continue;
+
+            const auto memory = rows_manager_.get(first + row);
+            auto record = REMAP_ADDRESS(memory);
+
+            // Skip if prefix doesn't match beyond its 32 bits.
+            if (!exact && !filter.is_prefix_of(
+                from_little_endian_unsafe<uint32_t>(record)))
+                continue;
+
+            // Skip if height is too low.
+            record += prefix_size;
+            const auto height = from_little_endian_unsafe<uint32_t>(record);
+            if (height < from_height)
+                continue;
+
+            // Add row to results.
+            auto deserial = make_deserializer_unsafe(record + height_size);
+            result.push_back(
+            {
+                deserial.read_hash(),
+                deserial.read_short_hash(),
+                deserial.read_hash()
+            });
+        }
     }
+    ///////////////////////////////////////////////////////////////////////////
 
-    // TODO: we could sort result here.
     return result;
 }
 
+// Store.
+// ----------------------------------------------------------------------------
+
 void stealth_database::store(uint32_t prefix, uint32_t height,
     const stealth_compact& row)
 {
@@ -152,11 +283,31 @@ void stealth_database::store(uint32_t prefix, uint32_t height,
     serial.write_hash(row.ephemeral_public_key_hash);
     serial.write_short_hash(row.public_key_hash);
     serial.write_hash(row.transaction_hash);
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(index_mutex_);
+    index_row(prefix, height);
+    ///////////////////////////////////////////////////////////////////////////
 }
 
-void stealth_database::unlink(size_t /* from_height */)
+// Blocks are popped from the top, so their rows are the trailing rows.
+void stealth_database::unlink(size_t from_height)
 {
-    // TODO: scan by height and mark as deleted.
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(index_mutex_);
+
+    auto count = rows_manager_.count();
+    while (count > 0 && read_height(count - 1) >= from_height)
+        --count;
+
+    if (count == rows_manager_.count())
+        return;
+
+    rows_manager_.set_count(count);
+    truncate_index(count);
+    ///////////////////////////////////////////////////////////////////////////
 }
 
 void stealth_database::sync()
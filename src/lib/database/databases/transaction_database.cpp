@@ -38,9 +38,10 @@ BC_CONSTEXPR size_t header_size = slab_hash_table_header_size(number_buckets);
 BC_CONSTEXPR size_t initial_map_file_size = header_size + minimum_slabs_size;
 
 transaction_database::transaction_database(const path& map_filename,
-    std::shared_ptr<shared_mutex> mutex)
+    const path& growth_filename, std::shared_ptr<shared_mutex> mutex)
   : lookup_file_(map_filename, mutex),
-    lookup_header_(lookup_file_, number_buckets),
+    growth_file_(growth_filename, mutex),
+    lookup_header_(lookup_file_, growth_file_, number_buckets),
     lookup_manager_(lookup_file_, header_size),
     lookup_map_(lookup_header_, lookup_manager_)
 {
@@ -58,8 +59,9 @@ transaction_database::~transaction_database()
 // Initialize files and start.
 bool transaction_database::create()
 {
-    // Resize and create require a started file.
-    if (!lookup_file_.start())
+    // Resize and create require started files.
+    if (!lookup_file_.start() ||
+        !growth_file_.start())
         return false;
 
     // This will throw if insufficient disk space.
@@ -83,6 +85,7 @@ bool transaction_database::start()
 {
     return
         lookup_file_.start() &&
+        growth_file_.start() &&
         lookup_header_.start() &&
         lookup_manager_.start();
 }
@@ -90,13 +93,31 @@ bool transaction_database::start()
 // Stop files.
 bool transaction_database::stop()
 {
-    return lookup_file_.stop();
+    return
+        lookup_file_.stop() &&
+        growth_file_.stop();
 }
 
 // Close files.
 bool transaction_database::close()
 {
-    return lookup_file_.close();
+    return
+        lookup_file_.close() &&
+        growth_file_.close();
+}
+
+// Convert a lookup table created with a fixed bucket count (offline).
+// The existing buckets remain in place, so only entries are counted.
+bool transaction_database::convert()
+{
+    if (!lookup_file_.start() ||
+        !growth_file_.start() ||
+        !lookup_header_.convert() ||
+        !lookup_manager_.start())
+        return false;
+
+    lookup_header_.set_entries(lookup_map_.count());
+    return true;
 }
 
 // ----------------------------------------------------------------------------
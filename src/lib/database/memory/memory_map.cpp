@@ -32,6 +32,7 @@
     #include <sys/mman.h>
     #define FILE_OPEN_PERMISSIONS S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH
 #endif
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <fcntl.h>
@@ -60,6 +61,21 @@ using boost::filesystem::path;
 #define EXPANSION_NUMERATOR 150
 #define EXPANSION_DENOMINATOR 100
 
+// Address space is reserved for growth in place, this costs no memory.
+// A 32 bit process cannot spare the minimum, it reserves only the multiple.
+#define RESERVATION_MULTIPLE 2
+#define RESERVATION_MINIMUM (sizeof(size_t) < sizeof(uint64_t) ? size_t(0) : \
+    static_cast<size_t>(uint64_t(1) << 36))
+
+// Round up to a whole number of pages.
+static size_t page_ceiling(size_t size, size_t page_size)
+{
+    if (page_size == 0 || size % page_size == 0)
+        return size;
+
+    return size + (page_size - size % page_size);
+}
+
 size_t memory_map::file_size(int file_handle)
 {
     if (file_handle == -1)
@@ -138,6 +154,9 @@ memory_map::memory_map(const path& filename)
   : file_handle_(open_file(filename)),
     filename_(filename),
     data_(nullptr),
+#ifndef REMAP_SAFETY
+    reserved_(0),
+#endif
     file_size_(file_size(file_handle_)),
     logical_size_(file_size_),
     closed_(true),
@@ -249,7 +268,7 @@ bool memory_map::close()
 
     if (msync(data_, logical_size_, MS_SYNC) == -1)
         error_name = "msync";
-    else if (munmap(data_, file_size_) == -1)
+    else if (!unmap())
         error_name = "munmap";
     else if (ftruncate(file_handle_, logical_size_) == -1)
         error_name = "ftruncate";
@@ -295,7 +314,12 @@ size_t memory_map::size() const
 // throws runtime_error
 memory_ptr memory_map::access()
 {
+#ifdef REMAP_SAFETY
     return REMAP_ACCESSOR(data_, mutex_);
+#else
+    // The mapping does not move or unmap until close, so no lock is held.
+    return data_.load(std::memory_order_acquire);
+#endif
 }
 
 // throws runtime_error
@@ -324,7 +348,11 @@ memory_ptr memory_map::reserve(size_t size, size_t expansion)
 
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
+#ifdef REMAP_SAFETY
     const auto memory = REMAP_ALLOCATOR(mutex_);
+#else
+    unique_lock lock(mutex_);
+#endif
 
     // The store should only have been closed after all threads terminated.
     if (closed_)
@@ -337,8 +365,10 @@ memory_ptr memory_map::reserve(size_t size, size_t expansion)
     {
         const size_t target = size * expansion / EXPANSION_DENOMINATOR;
 
+#ifdef REMAP_SAFETY
         mutex_.unlock_upgrade_and_lock();
         //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+#endif
 
         // TODO: isolate cause and if recoverable (disk size) return nullptr.
         // All existing database pointers are invalidated by this call.
@@ -348,16 +378,23 @@ memory_ptr memory_map::reserve(size_t size, size_t expansion)
             throw std::runtime_error("Resize failure, disk space may be low.");
         }
 
+#ifdef REMAP_SAFETY
         //---------------------------------------------------------------------
         mutex_.unlock_and_lock_upgrade();
+#endif
     }
 
     logical_size_ = size;
+
+#ifdef REMAP_SAFETY
     REMAP_DOWNGRADE(memory, data_);
 
     // Always return in shared lock state.
     // The critical section does not end until this shared pointer is freed.
     return memory;
+#else
+    return data_.load(std::memory_order_relaxed);
+#endif
     ///////////////////////////////////////////////////////////////////////////
 }
 
@@ -385,7 +422,17 @@ size_t memory_map::page()
 
 bool memory_map::unmap()
 {
+#ifdef REMAP_SAFETY
     const auto success = (munmap(data_, file_size_) != -1);
+#else
+    auto success = (munmap(data_, reserved_) != -1);
+
+    for (const auto& mapping: retired_)
+        success &= (munmap(mapping.first, mapping.second) != -1);
+
+    retired_.clear();
+    reserved_ = 0;
+#endif
     file_size_ = 0;
     data_ = nullptr;
     return success;
@@ -396,15 +443,26 @@ bool memory_map::map(size_t size)
     if (size == 0)
         return false;
 
+#ifdef REMAP_SAFETY
     data_ = reinterpret_cast<uint8_t*>(mmap(0, size, PROT_READ | PROT_WRITE,
         MAP_SHARED, file_handle_, 0));
 
     return validate(size);
+#else
+    if (reserve_map(size))
+        return true;
+
+    file_size_ = 0;
+    data_ = nullptr;
+    return false;
+#endif
 }
 
 bool memory_map::remap(size_t size)
 {
-#ifdef MREMAP_MAYMOVE
+#ifndef REMAP_SAFETY
+    return extend_map(size);
+#elif defined(MREMAP_MAYMOVE)
     data_ = reinterpret_cast<uint8_t*>(mremap(data_, file_size_, size,
         MREMAP_MAYMOVE));
 
@@ -414,6 +472,118 @@ bool memory_map::remap(size_t size)
 #endif
 }
 
+#ifndef REMAP_SAFETY
+
+size_t memory_map::reservation(size_t size)
+{
+    const auto grown = size > max_size_t / RESERVATION_MULTIPLE ? size :
+        size * RESERVATION_MULTIPLE;
+
+    return page_ceiling(std::max(grown, RESERVATION_MINIMUM), page());
+}
+
+// Map the file at the start of a new reservation of address space. The file
+// pages of a prior mapping are retained, as readers may still hold pointers
+// into them, and as they share the file pages they observe all writes made
+// through the new mapping. Its unused reservation is released at once.
+bool memory_map::reserve_map(size_t size)
+{
+    const auto reserved = reservation(size);
+
+    const auto base = mmap(0, reserved, PROT_NONE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+    if (base == MAP_FAILED)
+        return false;
+
+    const auto data = mmap(base, size, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_FIXED, file_handle_, 0);
+
+    if (data == MAP_FAILED)
+    {
+        munmap(base, reserved);
+        return false;
+    }
+
+    if (data_ != nullptr)
+    {
+        const auto used = std::min(page_ceiling(file_size_, page()),
+            reserved_);
+
+        if (used < reserved_)
+            munmap(data_.load() + used, reserved_ - used);
+
+        retired_.emplace_back(data_.load(), used);
+    }
+
+    reserved_ = reserved;
+    file_size_ = size;
+    data_.store(reinterpret_cast<uint8_t*>(data), std::memory_order_release);
+    return true;
+}
+
+// Extend the reservation in place when the address space after it is free,
+// so that the mapping need not move.
+bool memory_map::grow_reservation(size_t size)
+{
+    const auto reserved = reservation(size);
+    const auto end = data_.load() + reserved_;
+    const auto extra = reserved - reserved_;
+
+    // Without MAP_FIXED the address is a hint, taken only if it is free.
+    const auto base = mmap(end, extra, PROT_NONE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+    if (base == MAP_FAILED)
+        return false;
+
+    if (base != end)
+    {
+        munmap(base, extra);
+        return false;
+    }
+
+    reserved_ = reserved;
+    return true;
+}
+
+// Map the grown end of the file into the reservation, so that the mapped
+// address does not change. The page containing the old end is already mapped.
+bool memory_map::extend_map(size_t size)
+{
+    const auto page_size = page();
+
+    if (page_size == 0)
+        return false;
+
+    if (size > reserved_ && !grow_reservation(size))
+        return reserve_map(size);
+
+    const auto data = data_.load();
+    const auto start = page_ceiling(file_size_, page_size);
+    const auto end = page_ceiling(size, page_size);
+
+    // Pages wholly past a reduced end of file would fault on access, so they
+    // are returned to the reservation.
+    if (end < start)
+    {
+        if (mmap(data + end, start - end, PROT_NONE, MAP_PRIVATE |
+            MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0) == MAP_FAILED)
+            return false;
+    }
+    else if (end > start)
+    {
+        if (mmap(data + start, end - start, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_FIXED, file_handle_, start) == MAP_FAILED)
+            return false;
+    }
+
+    file_size_ = size;
+    return true;
+}
+
+#endif // REMAP_SAFETY
+
 bool memory_map::truncate(size_t size)
 {
     return ftruncate(file_handle_, size) != -1;
@@ -427,7 +597,7 @@ bool memory_map::truncate_mapped(size_t size)
     ///////////////////////////////////////////////////////////////////////////
     conditional_lock lock(remap_mutex_);
 
-#ifndef MREMAP_MAYMOVE
+#if defined(REMAP_SAFETY) && !defined(MREMAP_MAYMOVE)
     if (!unmap())
         return false;
 #endif
@@ -435,7 +605,7 @@ bool memory_map::truncate_mapped(size_t size)
     if (!truncate(size))
         return false;
 
-#ifndef MREMAP_MAYMOVE
+#if defined(REMAP_SAFETY) && !defined(MREMAP_MAYMOVE)
     return map(size);
 #else
     return remap(size);
@@ -0,0 +1,164 @@
+/**
+ * Copyright (c) 2011-2021 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2021 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/database/primitives/symbol_index.hpp>
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <metaverse/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+symbol_index::symbol_index(loader load)
+  : load_(std::move(load)), loaded_(false)
+{
+}
+
+void symbol_index::insert(const std::string& symbol, const hash_digest& key)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    scoped_lock lock(mutex_);
+
+    // The first scan loads the table, including this key.
+    if (!loaded_)
+        return;
+
+    if (keys_.emplace(key, symbol).second)
+        symbols_.emplace(symbol, key);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void symbol_index::erase(const hash_digest& key)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    scoped_lock lock(mutex_);
+
+    const auto it = keys_.find(key);
+    if (it == keys_.end())
+        return;
+
+    symbols_.erase(it->second);
+    keys_.erase(it);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void symbol_index::clear()
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    scoped_lock lock(mutex_);
+
+    symbols_.clear();
+    keys_.clear();
+    loaded_ = true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t symbol_index::size(const std::string& prefix,
+    const std::string& after) const
+{
+    size_t count = 0;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    scoped_lock lock(mutex_);
+
+    load();
+    if (prefix.empty() && after.empty())
+        return symbols_.size();
+
+    for (auto it = first(prefix, after); it != symbols_.end() &&
+        it->first.compare(0, prefix.size(), prefix) == 0; ++it)
+        ++count;
+    ///////////////////////////////////////////////////////////////////////////
+
+    return count;
+}
+
+hash_list symbol_index::scan(const std::string& prefix,
+    const std::string& after, size_t limit, size_t skip,
+    const filter& exclude) const
+{
+    hash_list keys;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    scoped_lock lock(mutex_);
+
+    load();
+
+    for (auto it = first(prefix, after); it != symbols_.end(); ++it)
+    {
+        if (it->first.compare(0, prefix.size(), prefix) != 0)
+            break;
+
+        if (limit != 0 && keys.size() == limit)
+            break;
+
+        if (exclude && exclude(it->first))
+            continue;
+
+        if (skip != 0)
+        {
+            --skip;
+            continue;
+        }
+
+        keys.push_back(it->second);
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    return keys;
+}
+
+// private
+//-----------------------------------------------------------------------------
+
+// The first symbol at or past the prefix and after the cursor, the caller
+// must hold the lock.
+symbol_index::symbol_map::const_iterator symbol_index::first(
+    const std::string& prefix, const std::string& after) const
+{
+    return after.empty() || after < prefix ?
+        symbols_.lower_bound(prefix) : symbols_.upper_bound(after);
+}
+
+// Walks the whole table once, the caller must hold the lock.
+void symbol_index::load() const
+{
+    if (loaded_)
+        return;
+
+    const auto add = [this](const std::string& symbol, const hash_digest& key)
+    {
+        if (keys_.emplace(key, symbol).second)
+            symbols_.emplace(symbol, key);
+    };
+
+    load_(add);
+    loaded_ = true;
+}
+
+} // namespace database
+} // namespace libbitcoin
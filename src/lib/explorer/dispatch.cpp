@@ -132,6 +132,77 @@ console_result dispatch_command(int argc, const char* argv[],
     return command->invoke(out, err);
 }
 
+// Height and allow/forbid checks shared by the argv and json entry points.
+static console_result invoke_extension(commands::command_extension& command,
+    Json::Value& jv_output, libbitcoin::server::server_node& node)
+{
+#ifndef PRIVATE_CHAIN
+    // fixme. is_blockchain_sync has some problem.
+    // if (command.category(ctgy_online) && node.is_blockchain_sync()) {
+    if (command.category(ctgy_online) &&
+        !node.chain_impl().chain_settings().use_testnet_rules) {
+        uint64_t height{0};
+        node.chain_impl().get_last_height(height);
+        if (!command.is_block_height_fullfilled(height)) {
+            throw block_sync_required_exception{"This command is unavailable because of the height < 610000."};
+        }
+    }
+#endif
+    const std::string command_name = command.name();
+    const auto& allowed_methods = node.server_settings().allow_rpc_methods;
+    const auto& forbidden_methods = node.server_settings().forbid_rpc_methods;
+
+    if (!forbidden_methods.empty()) {
+        try {
+            const std::sregex_iterator end;
+            for (const auto& item : forbidden_methods) {
+                auto patterns = bc::split(item, ", ", true);
+                for (const auto& pattern : patterns) {
+                    const std::regex reg_pattern("^" + pattern + "$");
+                    std::sregex_iterator it(command_name.begin(), command_name.end(), reg_pattern);
+                    if (it != end) {
+                        throw invalid_command_exception{command_name
+                            + " is forbidden with config item server.forbid_rpc_methods"};
+                    }
+                }
+            }
+        } catch (const std::exception& e) {
+            throw std::runtime_error{command_name +
+                " is called. when parse config item server.forbid_rpc_methods caught exception. " + e.what()};
+        }
+    }
+
+    if (!allowed_methods.empty()) {
+        bool allow = false;
+        try {
+            const std::sregex_iterator end;
+            for (const auto& item : allowed_methods) {
+                auto patterns = bc::split(item, ", ", true);
+                for (const auto& pattern : patterns) {
+                    const std::regex reg_pattern("^" + pattern + "$");
+                    std::sregex_iterator it(command_name.begin(), command_name.end(), reg_pattern);
+                    if (it != end) {
+                        allow = true;
+                        break;
+                    }
+                }
+                if (allow) {
+                    break;
+                }
+            }
+        } catch (const std::exception& e) {
+            throw std::runtime_error{command_name +
+                " is called. when parse config item server.allow_rpc_methods caught exception. " + e.what()};
+        }
+        if (!allow) {
+            throw invalid_command_exception{command_name
+                + " is not allowed with config item server.allow_rpc_methods"};
+        }
+    }
+
+    return command.invoke(jv_output, node);
+}
+
 console_result dispatch_command(int argc, const char* argv[],
     Json::Value& jv_output,
     libbitcoin::server::server_node& node, uint8_t api_version)
@@ -170,71 +241,8 @@ console_result dispatch_command(int argc, const char* argv[],
 
     if (command->category(ctgy_extension))
     {
-#ifndef PRIVATE_CHAIN
-        // fixme. is_blockchain_sync has some problem.
-        // if (command->category(ctgy_online) && node.is_blockchain_sync()) {
-        if (command->category(ctgy_online) &&
-            !node.chain_impl().chain_settings().use_testnet_rules) {
-            uint64_t height{0};
-            node.chain_impl().get_last_height(height);
-            if (!command->is_block_height_fullfilled(height)) {
-                throw block_sync_required_exception{"This command is unavailable because of the height < 610000."};
-            }
-        }
-#endif
-        const std::string command_name = command->name();
-        const auto& allowed_methods = node.server_settings().allow_rpc_methods;
-        const auto& forbidden_methods = node.server_settings().forbid_rpc_methods;
-
-        if (!forbidden_methods.empty()) {
-            try {
-                const std::sregex_iterator end;
-                for (const auto& item : forbidden_methods) {
-                    auto patterns = bc::split(item, ", ", true);
-                    for (const auto& pattern : patterns) {
-                        const std::regex reg_pattern("^" + pattern + "$");
-                        std::sregex_iterator it(command_name.begin(), command_name.end(), reg_pattern);
-                        if (it != end) {
-                            throw invalid_command_exception{command_name
-                                + " is forbidden with config item server.forbid_rpc_methods"};
-                        }
-                    }
-                }
-            } catch (const std::exception& e) {
-                throw std::runtime_error{command_name +
-                    " is called. when parse config item server.forbid_rpc_methods caught exception. " + e.what()};
-            }
-        }
-
-        if (!allowed_methods.empty()) {
-            bool allow = false;
-            try {
-                const std::sregex_iterator end;
-                for (const auto& item : allowed_methods) {
-                    auto patterns = bc::split(item, ", ", true);
-                    for (const auto& pattern : patterns) {
-                        const std::regex reg_pattern("^" + pattern + "$");
-                        std::sregex_iterator it(command_name.begin(), command_name.end(), reg_pattern);
-                        if (it != end) {
-                            allow = true;
-                            break;
-                        }
-                    }
-                    if (allow) {
-                        break;
-                    }
-                }
-            } catch (const std::exception& e) {
-                throw std::runtime_error{command_name +
-                    " is called. when parse config item server.allow_rpc_methods caught exception. " + e.what()};
-            }
-            if (!allow) {
-                throw invalid_command_exception{command_name
-                    + " is not allowed with config item server.allow_rpc_methods"};
-            }
-        }
-
-        return static_cast<commands::command_extension*>(command.get())->invoke(jv_output, node);
+        return invoke_extension(*static_cast<commands::command_extension*>(command.get()),
+            jv_output, node);
     }
     else {
         command->set_api_version(1); // only compatible for v1
@@ -244,6 +252,23 @@ console_result dispatch_command(int argc, const char* argv[],
     }
 }
 
+bool dispatch_json(const std::string& method, const Json::Value& params,
+    Json::Value& jv_output, console_result& result,
+    libbitcoin::server::server_node& node, uint8_t api_version)
+{
+    const auto command = find(method);
+    if (!command || !command->category(ctgy_extension))
+        return false;
+
+    auto& extension = *static_cast<commands::command_extension*>(command.get());
+    if (!extension.bind_json(params))
+        return false;
+
+    extension.set_api_version(api_version);
+    result = invoke_extension(extension, jv_output, node);
+    return true;
+}
+
 
 } // namespace explorer
 } // namespace libbitcoin
@@ -444,7 +444,7 @@ void sync_fetch_asset_balance(const std::string& address, bool sum_all,
     bc::blockchain::block_chain_impl& blockchain,
     std::shared_ptr<asset_balances::list> sh_asset_vec)
 {
-    auto&& rows = blockchain.get_address_history(wallet::payment_address(address));
+    auto&& rows = blockchain.get_address_utxos(wallet::payment_address(address));
 
     chain::transaction tx_temp;
     uint64_t tx_height;
@@ -453,15 +453,12 @@ void sync_fetch_asset_balance(const std::string& address, bool sum_all,
 
     for (auto& row: rows)
     {
-        // spend unconfirmed (or no spend attempted)
-        if ((row.spend.hash == null_hash)
+        // only asset outputs need their transaction loaded
+        if (row.attachment_type == ASSET_TYPE
                 && blockchain.get_transaction(tx_temp, tx_height, row.output.hash))
         {
             BITCOIN_ASSERT(row.output.index < tx_temp.outputs.size());
             const auto& output = tx_temp.outputs.at(row.output.index);
-            if (output.get_script_address() != address) {
-                continue;
-            }
             if (output.is_asset())
             {
                 const auto& symbol = output.get_asset_symbol();
@@ -480,8 +477,8 @@ void sync_fetch_asset_balance(const std::string& address, bool sum_all,
                 if (asset_amount
                     && operation::is_pay_key_hash_with_attenuation_model_pattern(output.script.operations)) {
                     const auto& attenuation_model_param = output.get_attenuation_model_param();
-                    auto diff_height = row.output_height
-                        ? blockchain.calc_number_of_blocks(row.output_height, height)
+                    auto diff_height = row.height
+                        ? blockchain.calc_number_of_blocks(row.height, height)
                         : 0;
                     auto available_amount = attenuation_model::get_available_asset_amount(
                             asset_amount, diff_height, attenuation_model_param);
@@ -489,7 +486,7 @@ void sync_fetch_asset_balance(const std::string& address, bool sum_all,
                 }
                 else if (asset_amount
                     && chain::operation::is_pay_key_hash_with_sequence_lock_pattern(output.script.operations)) {
-                    auto is_spendable = blockchain.is_utxo_spendable(tx_temp, row.output.index, tx_height, height);
+                    auto is_spendable = blockchain.is_utxo_spendable(row, height);
                     if (!is_spendable) {
                         // utxo already in block but is locked with sequence and not mature
                         locked_amount = asset_amount;
@@ -513,7 +510,7 @@ void sync_fetch_asset_balance(const std::string& address, bool sum_all,
     std::shared_ptr<utxo_balance::list> sh_asset_utxo_vec,
     uint64_t utxo_min_confirm)
 {
-    auto&& rows = blockchain.get_address_history(wallet::payment_address(address));
+    auto&& rows = blockchain.get_address_utxos(wallet::payment_address(address));
 
     chain::transaction tx_temp;
     uint64_t tx_height;
@@ -523,18 +520,12 @@ void sync_fetch_asset_balance(const std::string& address, bool sum_all,
 
     for (auto& row: rows)
     {
-        uint64_t unspent_balance = 0;
-        uint64_t frozen_balance = 0;
-
-        // spend unconfirmed (or no spend attempted)
-        if ((row.spend.hash == null_hash)
+        // only asset outputs need their transaction loaded
+        if (row.attachment_type == ASSET_TYPE
                 && blockchain.get_transaction(tx_temp, tx_height, row.output.hash))
         {
             BITCOIN_ASSERT(row.output.index < tx_temp.outputs.size());
             const auto& output = tx_temp.outputs.at(row.output.index);
-            if (output.get_script_address() != address) {
-                continue;
-            }
             if (output.is_asset())
             {
                 const auto& symbol = output.get_asset_symbol();
@@ -553,8 +544,8 @@ void sync_fetch_asset_balance(const std::string& address, bool sum_all,
                 if (asset_amount
                     && operation::is_pay_key_hash_with_attenuation_model_pattern(output.script.operations)) {
                     const auto& attenuation_model_param = output.get_attenuation_model_param();
-                    auto diff_height = row.output_height
-                        ? blockchain.calc_number_of_blocks(row.output_height, height)
+                    auto diff_height = row.height
+                        ? blockchain.calc_number_of_blocks(row.height, height)
                         : 0;
                     auto available_amount = attenuation_model::get_available_asset_amount(
                             asset_amount, diff_height, attenuation_model_param);
@@ -568,7 +559,7 @@ void sync_fetch_asset_balance(const std::string& address, bool sum_all,
                     if (utxo_min_confirm > blockchain.calc_number_of_blocks(tx_height, height)){
                         continue;
                     }
-                    auto is_spendable = blockchain.is_utxo_spendable(tx_temp, row.output.index, tx_height, height);
+                    auto is_spendable = blockchain.is_utxo_spendable(row, height);
                     if (!is_spendable) {
                         // utxo already in block but is locked with sequence and not mature
                         locked_amount = asset_amount;
@@ -580,7 +571,7 @@ void sync_fetch_asset_balance(const std::string& address, bool sum_all,
                 }
                 sh_asset_utxo_vec->emplace_back(utxo_balance{
                     encode_hash(row.output.hash), row.output.index,
-                    row.output_height, asset_amount, locked_amount, symbol});
+                    row.height, asset_amount, locked_amount, symbol});
             }
         }
     }
@@ -992,45 +983,30 @@ void sync_fetch_deposited_balance(wallet::payment_address& address,
 void sync_fetchbalance(wallet::payment_address& address,
     bc::blockchain::block_chain_impl& blockchain, balances& addr_balance)
 {
-    auto&& rows = blockchain.get_address_history(address, false);
+    auto&& rows = blockchain.get_address_utxos(address);
 
-    uint64_t total_received = 0;
     uint64_t confirmed_balance = 0;
     uint64_t unspent_balance = 0;
     uint64_t frozen_balance = 0;
 
-    chain::transaction tx_temp;
-    uint64_t tx_height;
     uint64_t height = 0;
     blockchain.get_last_height(height);
 
     for (auto& row: rows) {
-        // spend unconfirmed (or no spend attempted)
-        if ((row.spend.hash == null_hash)
-            && blockchain.get_transaction(tx_temp, tx_height, row.output.hash)) {
-            BITCOIN_ASSERT(row.output.index < tx_temp.outputs.size());
-            auto output = tx_temp.outputs.at(row.output.index);
-            if (output.get_script_address() != address.encoded()) {
-                continue;
-            }
-
-            auto is_spendable = blockchain.is_utxo_spendable(tx_temp, row.output.index, tx_height, height);
-            if (!is_spendable) {
-                frozen_balance += row.value;
-            }
-
-            unspent_balance += row.value;
+        // maturity and lock check, the row records the lock of its output
+        auto is_spendable = blockchain.is_utxo_spendable(row, height);
+        if (!is_spendable) {
+            frozen_balance += row.value;
         }
 
-        total_received += row.value;
+        unspent_balance += row.value;
 
-        if ((row.spend.hash == null_hash || row.spend_height == 0)) {
-            confirmed_balance += row.value;
-        }
+        // the index holds outputs of blocks, none spent by a block
+        confirmed_balance += row.value;
     }
 
     addr_balance.confirmed_balance = confirmed_balance;
-    addr_balance.total_received = total_received;
+    addr_balance.total_received = blockchain.get_address_received(address);
     addr_balance.unspent_balance = unspent_balance;
     addr_balance.frozen_balance = frozen_balance;
 }
@@ -1039,10 +1015,7 @@ void sync_fetchbalance(wallet::payment_address& address,
     bc::blockchain::block_chain_impl& blockchain,
     std::shared_ptr<utxo_balance::list> sh_vec)
 {
-    auto&& rows = blockchain.get_address_history(address, false);
-
-    chain::transaction tx_temp;
-    uint64_t tx_height = 0;
+    auto&& rows = blockchain.get_address_utxos(address);
 
     uint64_t height = 0;
     blockchain.get_last_height(height);
@@ -1055,21 +1028,7 @@ void sync_fetchbalance(wallet::payment_address& address,
             continue;
         }
 
-        bool tx_ready = (row.spend.hash == null_hash)
-            && blockchain.get_transaction(tx_temp, tx_height, row.output.hash);
-
-        // spend unconfirmed (or no spend attempted)
-        if (!tx_ready) {
-            continue;
-        }
-
-        BITCOIN_ASSERT(row.output.index < tx_temp.outputs.size());
-        auto output = tx_temp.outputs.at(row.output.index);
-        if (output.get_script_address() != address.encoded()) {
-            continue;
-        }
-
-        auto is_spendable = blockchain.is_utxo_spendable(tx_temp, row.output.index, tx_height, height);
+        auto is_spendable = blockchain.is_utxo_spendable(row, height);
         if (!is_spendable) {
             frozen_balance += row.value;
         }
@@ -1077,7 +1036,7 @@ void sync_fetchbalance(wallet::payment_address& address,
         unspent_balance += row.value;
         sh_vec->emplace_back(utxo_balance{
             encode_hash(row.output.hash), row.output.index,
-            row.output_height, unspent_balance, frozen_balance});
+            row.height, unspent_balance, frozen_balance});
     }
 
     if (sh_vec->size() > 1) {
@@ -23,6 +23,7 @@
 #include <memory>
 #include <string>
 #include <array>
+#include <unordered_map>
 
 #include <metaverse/explorer/command.hpp>
 #include <metaverse/explorer/dispatch.hpp>
@@ -222,189 +223,157 @@ void broadcast_extension(const function<void(shared_ptr<command>)> func, std::os
     func(make_shared<getdid>());
 }
 
-shared_ptr<command> find_extension(const string& symbol)
-{
-    // account
-    if (symbol == getnewaccount::symbol())
-        return make_shared<getnewaccount>();
-    if (symbol == getaccount::symbol())
-        return make_shared<getaccount>();
-    if (symbol == deleteaccount::symbol())
-        return make_shared<deleteaccount>();
-    if (symbol == changepasswd::symbol())
-        return make_shared<changepasswd>();
-    if (symbol == validateaddress::symbol())
-        return make_shared<validateaddress>();
-    if (symbol == getnewaddress::symbol())
-        return make_shared<getnewaddress>();
-    if (symbol == listaddresses::symbol())
-        return make_shared<listaddresses>();
-    if (symbol == importaccount::symbol())
-        return make_shared<importaccount>();
-    if (symbol == dumpkeyfile::symbol() || symbol == "exportaccountasfile")
-        return make_shared<dumpkeyfile>();
-    if (symbol == importkeyfile::symbol() || symbol == "importaccountfromfile")
-        return make_shared<importkeyfile>();
-    if (symbol == importaddress::symbol())
-        return make_shared<importaddress>();
+namespace {
 
-    // system
-    if (symbol == shutdown::symbol())
-        return make_shared<shutdown>();
-    if (symbol == getinfo::symbol())
-        return make_shared<getinfo>();
-    if (symbol == addnode::symbol())
-        return make_shared<addnode>();
-    if (symbol == getpeerinfo::symbol())
-        return make_shared<getpeerinfo>();
-    if (symbol == getrandom::symbol())
-        return make_shared<getrandom>();
-    if (symbol == verifyrandom::symbol())
-        return make_shared<verifyrandom>();
-
-    // mining
-    if (symbol == stopmining::symbol() || symbol == "stop")
-        return make_shared<stopmining>();
-    if (symbol == startmining::symbol() || symbol == "start")
-        return make_shared<startmining>();
-    if (symbol == setminingaccount::symbol())
-        return make_shared<setminingaccount>();
-    if (symbol == getmininginfo::symbol())
-        return make_shared<getmininginfo>();
-    if (symbol == getstakeinfo::symbol())
-        return make_shared<getstakeinfo>();
-    if ((symbol == getwork::symbol()) || (symbol == "eth_getWork"))
-        return make_shared<getwork>();
-    if ((symbol == submitwork::symbol()) || ( symbol == "eth_submitWork"))
-        return make_shared<submitwork>();
-    if (symbol == getmemorypool::symbol())
-        return make_shared<getmemorypool>();
-    if (symbol == registerwitness::symbol())
-        return make_shared<registerwitness>();
-
-    // block & tx
-    if (symbol == getheight::symbol())
-        return make_shared<getheight>();
-    if (symbol == "fetch-height")
-        return make_shared<getheight>(symbol);
-    if (symbol == getblock::symbol())
-        return make_shared<getblock>();
-    if (symbol == "getbestblockhash")
-        return make_shared<getblockheader>(symbol);
-    if (symbol == getblockheader::symbol() || symbol == "fetch-header" || symbol == "getbestblockheader")
-        return make_shared<getblockheader>();
-    if (symbol == fetchheaderext::symbol())
-        return make_shared<fetchheaderext>();
-    if (symbol == gettx::symbol() || symbol == "gettransaction")
-        return make_shared<gettx>();
-    if (symbol == popblock::symbol())
-        return make_shared<popblock>();
-    if (symbol == "fetch-tx")
-        return make_shared<gettx>(symbol);
-    if (symbol == listtxs::symbol())
-        return make_shared<listtxs>();
+typedef std::function<shared_ptr<command>()> command_factory;
 
-    // raw tx
-    if (symbol == createrawtx::symbol())
-        return make_shared<createrawtx>();
-    if (symbol == decoderawtx::symbol())
-        return make_shared<decoderawtx>();
-    if (symbol == signrawtx::symbol())
-        return make_shared<signrawtx>();
-    if (symbol == sendrawtx::symbol())
-        return make_shared<sendrawtx>();
-
-    // multi-sig
-    if (symbol == getpublickey::symbol())
-        return make_shared<getpublickey>();
-    if (symbol == getnewmultisig::symbol())
-        return make_shared<getnewmultisig>();
-    if (symbol == listmultisig::symbol())
-        return make_shared<listmultisig>();
-    if (symbol == deletemultisig::symbol())
-        return make_shared<deletemultisig>();
-    if (symbol == createmultisigtx::symbol())
-        return make_shared<createmultisigtx>();
-    if (symbol == signmultisigtx::symbol())
-        return make_shared<signmultisigtx>();
+template <typename Command>
+command_factory make_factory()
+{
+    return []() -> shared_ptr<command> { return make_shared<Command>(); };
+}
 
-    // etp
-    if (symbol == listbalances::symbol())
-        return make_shared<listbalances>();
-    if (symbol == getbalance::symbol())
-        return make_shared<getbalance>();
-    if (symbol == getaddressetp::symbol() || symbol == "fetch-balance")
-        return make_shared<getaddressetp>();
-    if (symbol == lock::symbol())
-        return make_shared<lock>();
-    if (symbol == getlocked::symbol())
-        return make_shared<getlocked>();
-    if (symbol == send::symbol() || symbol == "didsend")
-        return make_shared<send>();
-    if (symbol == sendmore::symbol() || symbol == "didsendmore")
-        return make_shared<sendmore>();
-    if (symbol == sendfrom::symbol() || symbol == "didsendfrom")
-        return make_shared<sendfrom>();
+template <typename Command>
+command_factory make_alias(const string& symbol)
+{
+    return [symbol]() -> shared_ptr<command> { return make_shared<Command>(symbol); };
+}
 
-    // asset
-    if (symbol == validatesymbol::symbol())
-        return make_shared<validatesymbol>();
-    if (symbol == createasset::symbol())
-        return make_shared<createasset>();
-    if (symbol == deletelocalasset::symbol() || symbol == "deleteasset" )
-        return make_shared<deletelocalasset>();
-    if (symbol == listassets::symbol())
-        return make_shared<listassets>();
-    if (symbol == getasset::symbol())
-        return make_shared<getasset>();
-    if (symbol == getaccountasset::symbol())
-        return make_shared<getaccountasset>();
-    // if (symbol == getassetview::symbol())
-    //     return make_shared<getassetview>();
-    if (symbol == getaddressasset::symbol())
-        return make_shared<getaddressasset>();
-    if (symbol == issue::symbol())
-        return make_shared<issue>();
-    if (symbol == secondaryissue::symbol() || (symbol == "additionalissue") )
-        return make_shared<secondaryissue>();
-    if (symbol == sendasset::symbol() || symbol == "didsendasset")
-        return make_shared<sendasset>();
-    if (symbol == sendassetfrom::symbol() || symbol == "didsendassetfrom")
-        return make_shared<sendassetfrom>();
-    if (symbol == sendmoreasset::symbol() || symbol == "sendassetmore")
-        return make_shared<sendmoreasset>();
-    if (symbol == burn::symbol())
-        return make_shared<burn>();
-    if (symbol == swaptoken::symbol())
-        return make_shared<swaptoken>();
+// Built once on first lookup, function local statics are thread safe.
+const std::unordered_map<string, command_factory>& extension_registry()
+{
+    static const std::unordered_map<string, command_factory> registry
+    {
+        // account
+        { getnewaccount::symbol(), make_factory<getnewaccount>() },
+        { getaccount::symbol(), make_factory<getaccount>() },
+        { deleteaccount::symbol(), make_factory<deleteaccount>() },
+        { changepasswd::symbol(), make_factory<changepasswd>() },
+        { validateaddress::symbol(), make_factory<validateaddress>() },
+        { getnewaddress::symbol(), make_factory<getnewaddress>() },
+        { listaddresses::symbol(), make_factory<listaddresses>() },
+        { importaccount::symbol(), make_factory<importaccount>() },
+        { dumpkeyfile::symbol(), make_factory<dumpkeyfile>() },
+        { "exportaccountasfile", make_factory<dumpkeyfile>() },
+        { importkeyfile::symbol(), make_factory<importkeyfile>() },
+        { "importaccountfromfile", make_factory<importkeyfile>() },
+        { importaddress::symbol(), make_factory<importaddress>() },
+
+        // system
+        { shutdown::symbol(), make_factory<shutdown>() },
+        { getinfo::symbol(), make_factory<getinfo>() },
+        { addnode::symbol(), make_factory<addnode>() },
+        { getpeerinfo::symbol(), make_factory<getpeerinfo>() },
+        { getrandom::symbol(), make_factory<getrandom>() },
+        { verifyrandom::symbol(), make_factory<verifyrandom>() },
+
+        // mining
+        { stopmining::symbol(), make_factory<stopmining>() },
+        { "stop", make_factory<stopmining>() },
+        { startmining::symbol(), make_factory<startmining>() },
+        { "start", make_factory<startmining>() },
+        { setminingaccount::symbol(), make_factory<setminingaccount>() },
+        { getmininginfo::symbol(), make_factory<getmininginfo>() },
+        { getstakeinfo::symbol(), make_factory<getstakeinfo>() },
+        { getwork::symbol(), make_factory<getwork>() },
+        { "eth_getWork", make_factory<getwork>() },
+        { submitwork::symbol(), make_factory<submitwork>() },
+        { "eth_submitWork", make_factory<submitwork>() },
+        { getmemorypool::symbol(), make_factory<getmemorypool>() },
+        { registerwitness::symbol(), make_factory<registerwitness>() },
+
+        // block & tx
+        { getheight::symbol(), make_factory<getheight>() },
+        { "fetch-height", make_alias<getheight>("fetch-height") },
+        { getblock::symbol(), make_factory<getblock>() },
+        { "getbestblockhash", make_alias<getblockheader>("getbestblockhash") },
+        { getblockheader::symbol(), make_factory<getblockheader>() },
+        { "fetch-header", make_factory<getblockheader>() },
+        { "getbestblockheader", make_factory<getblockheader>() },
+        { fetchheaderext::symbol(), make_factory<fetchheaderext>() },
+        { gettx::symbol(), make_factory<gettx>() },
+        { "gettransaction", make_factory<gettx>() },
+        { popblock::symbol(), make_factory<popblock>() },
+        { "fetch-tx", make_alias<gettx>("fetch-tx") },
+        { listtxs::symbol(), make_factory<listtxs>() },
+
+        // raw tx
+        { createrawtx::symbol(), make_factory<createrawtx>() },
+        { decoderawtx::symbol(), make_factory<decoderawtx>() },
+        { signrawtx::symbol(), make_factory<signrawtx>() },
+        { sendrawtx::symbol(), make_factory<sendrawtx>() },
+
+        // multi-sig
+        { getpublickey::symbol(), make_factory<getpublickey>() },
+        { getnewmultisig::symbol(), make_factory<getnewmultisig>() },
+        { listmultisig::symbol(), make_factory<listmultisig>() },
+        { deletemultisig::symbol(), make_factory<deletemultisig>() },
+        { createmultisigtx::symbol(), make_factory<createmultisigtx>() },
+        { signmultisigtx::symbol(), make_factory<signmultisigtx>() },
+
+        // etp
+        { listbalances::symbol(), make_factory<listbalances>() },
+        { getbalance::symbol(), make_factory<getbalance>() },
+        { getaddressetp::symbol(), make_factory<getaddressetp>() },
+        { "fetch-balance", make_factory<getaddressetp>() },
+        { lock::symbol(), make_factory<lock>() },
+        { getlocked::symbol(), make_factory<getlocked>() },
+        { send::symbol(), make_factory<send>() },
+        { "didsend", make_factory<send>() },
+        { sendmore::symbol(), make_factory<sendmore>() },
+        { "didsendmore", make_factory<sendmore>() },
+        { sendfrom::symbol(), make_factory<sendfrom>() },
+        { "didsendfrom", make_factory<sendfrom>() },
+
+        // asset
+        { validatesymbol::symbol(), make_factory<validatesymbol>() },
+        { createasset::symbol(), make_factory<createasset>() },
+        { deletelocalasset::symbol(), make_factory<deletelocalasset>() },
+        { "deleteasset", make_factory<deletelocalasset>() },
+        { listassets::symbol(), make_factory<listassets>() },
+        { getasset::symbol(), make_factory<getasset>() },
+        { getaccountasset::symbol(), make_factory<getaccountasset>() },
+        // { getassetview::symbol(), make_factory<getassetview>() },
+        { getaddressasset::symbol(), make_factory<getaddressasset>() },
+        { issue::symbol(), make_factory<issue>() },
+        { secondaryissue::symbol(), make_factory<secondaryissue>() },
+        { "additionalissue", make_factory<secondaryissue>() },
+        { sendasset::symbol(), make_factory<sendasset>() },
+        { "didsendasset", make_factory<sendasset>() },
+        { sendassetfrom::symbol(), make_factory<sendassetfrom>() },
+        { "didsendassetfrom", make_factory<sendassetfrom>() },
+        { sendmoreasset::symbol(), make_factory<sendmoreasset>() },
+        { "sendassetmore", make_factory<sendmoreasset>() },
+        { burn::symbol(), make_factory<burn>() },
+        { swaptoken::symbol(), make_factory<swaptoken>() },
+
+        // cert
+        { transfercert::symbol(), make_factory<transfercert>() },
+        { issuecert::symbol(), make_factory<issuecert>() },
+
+        // mit
+        { registermit::symbol(), make_factory<registermit>() },
+        { transfermit::symbol(), make_factory<transfermit>() },
+        { listmits::symbol(), make_factory<listmits>() },
+        { getmit::symbol(), make_factory<getmit>() },
+
+        // did
+        { registerdid::symbol(), make_factory<registerdid>() },
+        { didchangeaddress::symbol(), make_factory<didchangeaddress>() },
+        { listdids::symbol(), make_factory<listdids>() },
+        { getdid::symbol(), make_factory<getdid>() }
+    };
+
+    return registry;
+}
 
-    // cert
-    if (symbol == transfercert::symbol())
-        return make_shared<transfercert>();
-    if (symbol == issuecert::symbol())
-        return make_shared<issuecert>();
+} // namespace
 
-    // mit
-    if (symbol == registermit::symbol())
-        return make_shared<registermit>();
-    if (symbol == transfermit::symbol())
-        return make_shared<transfermit>();
-    if (symbol == listmits::symbol())
-        return make_shared<listmits>();
-    if (symbol == getmit::symbol())
-        return make_shared<getmit>();
-
-    // did
-    if (symbol == registerdid::symbol())
-        return make_shared<registerdid>();
-    if (symbol == didchangeaddress::symbol())
-        return make_shared<didchangeaddress>();
-    if (symbol == listdids::symbol())
-        return make_shared<listdids>();
-    if (symbol == getdid::symbol())
-        return make_shared<getdid>();
-
-    return nullptr;
+shared_ptr<command> find_extension(const string& symbol)
+{
+    const auto& registry = extension_registry();
+    const auto it = registry.find(symbol);
+    return it == registry.end() ? nullptr : it->second();
 }
 
 std::string formerly_extension(const string& former)
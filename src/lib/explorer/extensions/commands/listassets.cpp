@@ -89,8 +89,9 @@ console_result listassets::invoke(Json::Value& jv_output,
     else {
         json_key = "assets";
 
-        if (auth_.name.empty()) { // no account -- list whole assets in blockchain
-            auto sh_vec = blockchain.get_issued_assets();
+        if (auth_.name.empty()) { // no account -- list assets in blockchain by symbol
+            auto sh_vec = blockchain.get_issued_assets_page(option_.prefix,
+                option_.after, option_.limit);
             std::sort(sh_vec->begin(), sh_vec->end());
             for (auto& elem: *sh_vec) {
                 Json::Value asset_data = json_helper.prop_list(elem, true);
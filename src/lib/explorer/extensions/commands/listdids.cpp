@@ -48,47 +48,56 @@ console_result listdids::invoke(Json::Value& jv_output,
     }
 
     auto& blockchain = node.chain_impl();
-    std::shared_ptr<chain::did_detail::list> sh_vec;
-    if (auth_.name.empty()) {
-        // no account -- list all dids in blockchain
-        sh_vec = blockchain.get_registered_dids();
-    }
-    else {
-        // list dids owned by the account
-        blockchain.is_account_passwd_valid(auth_.name, auth_.auth);
-        sh_vec = blockchain.get_account_dids(auth_.name);
-    }
 
     uint64_t limit = argument_.limit;
     uint64_t index = argument_.index;
 
     std::vector<chain::did_detail> result;
-    uint64_t total_count = sh_vec-> size();
+    uint64_t total_count = 0;
     uint64_t total_page = 0;
-    if (total_count > 0) {
-        std::sort(sh_vec->begin(), sh_vec->end());
 
-        uint64_t start = 0, end = 0, tx_count = 0;
-        if (index && limit) {
+    if (auth_.name.empty()) {
+        // no account -- page through the ordered did index of the blockchain
+        total_count = blockchain.get_registered_dids_count(argument_.prefix,
+            argument_.after);
+        if (total_count > 0) {
             total_page = (total_count % limit) ? (total_count / limit + 1) : (total_count / limit);
             index = index > total_page ? total_page : index;
-            start = (index - 1) * limit;
-            end = index * limit;
-            tx_count = end >= total_count ? (total_count - start) : limit ;
-        }
-        else if (!index && !limit) { // all tx records
-            start = 0;
-            tx_count = total_count;
-            index = 1;
-            total_page = 1;
-        }
-        else {
-            throw argument_legality_exception{"invalid limit or index parameter"};
+
+            // a cursor pages from its symbol instead of from the page index
+            const uint64_t skip = argument_.after.empty() ? (index - 1) * limit : 0;
+            auto sh_vec = blockchain.get_registered_dids(argument_.prefix,
+                argument_.after, limit, skip);
+            result.assign(sh_vec->begin(), sh_vec->end());
         }
+    }
+    else {
+        // list dids owned by the account
+        blockchain.is_account_passwd_valid(auth_.name, auth_.auth);
+        auto sh_vec = blockchain.get_account_dids(auth_.name);
+
+        const auto& prefix = argument_.prefix;
+        const auto& after = argument_.after;
+        const auto excluded = [&prefix, &after](const chain::did_detail& did) {
+            const auto& symbol = did.get_symbol();
+            return symbol.compare(0, prefix.size(), prefix) != 0 ||
+                (!after.empty() && symbol <= after);
+        };
+        sh_vec->erase(std::remove_if(sh_vec->begin(), sh_vec->end(), excluded),
+            sh_vec->end());
+
+        total_count = sh_vec->size();
+        if (total_count > 0) {
+            std::sort(sh_vec->begin(), sh_vec->end());
+
+            total_page = (total_count % limit) ? (total_count / limit + 1) : (total_count / limit);
+            index = index > total_page ? total_page : index;
 
-        if (start < total_count && tx_count > 0) {
-            result.resize(tx_count);
-            std::copy(sh_vec->begin() + start, sh_vec->begin() + start + tx_count, result.begin());
+            const uint64_t start = after.empty() ? (index - 1) * limit : 0;
+            const uint64_t end = std::min(start + limit, total_count);
+            if (start < end) {
+                result.assign(sh_vec->begin() + start, sh_vec->begin() + end);
+            }
         }
     }
 
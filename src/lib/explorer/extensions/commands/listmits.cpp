@@ -41,8 +41,9 @@ console_result listmits::invoke(Json::Value& jv_output,
     auto json_helper = config::json_helper(get_api_version());
 
     if (auth_.name.empty()) {
-        // no account -- list whole assets in blockchain
-        auto sh_vec = blockchain.get_registered_mits();
+        // no account -- list assets in blockchain by symbol
+        auto sh_vec = blockchain.get_registered_mits(option_.prefix,
+            option_.after, option_.limit);
         if (nullptr != sh_vec) {
             std::sort(sh_vec->begin(), sh_vec->end());
             for (auto& elem : *sh_vec) {
@@ -103,23 +103,6 @@ console_result listtxs::invoke(Json::Value& jv_output,
     auto& aroot = jv_output;
     Json::Value balances;
 
-    auto sort_by_height = [](const tx_block_info & lhs, const tx_block_info & rhs)->bool {
-        return const_cast<tx_block_info&>(lhs).get_height() > const_cast<tx_block_info&>(rhs).get_height();
-    };
-
-    auto sh_txs = std::make_shared<std::vector<tx_block_info>>();
-
-    // scan all addresses business record
-    for (auto& each : *sh_addr_vec) {
-        auto sh_vec = blockchain.get_address_business_record(each, argument_.symbol,
-                      option_.height.first(), option_.height.second(), 0, 0);
-        for (auto& elem : *sh_vec)
-            sh_txs->push_back(tx_block_info(elem.height, elem.data.get_timestamp(), elem.point.hash));
-    }
-    std::sort (sh_txs->begin(), sh_txs->end());
-    sh_txs->erase(std::unique(sh_txs->begin(), sh_txs->end()), sh_txs->end());
-    std::sort (sh_txs->begin(), sh_txs->end(), sort_by_height);
-
     // page limit & page index paramenter check
     if (!argument_.index)
         throw argument_legality_exception{"page index parameter cannot be zero"};
@@ -128,29 +111,101 @@ console_result listtxs::invoke(Json::Value& jv_output,
     if (argument_.limit > 100)
         throw argument_legality_exception{"page record limit cannot be bigger than 100."};
 
-    uint64_t start, end, total_page, tx_count;
-    if (argument_.index && argument_.limit) {
-        start = (argument_.index - 1) * argument_.limit;
-        end = (argument_.index) * argument_.limit;
-        if (start >= sh_txs->size() || !sh_txs->size())
-            throw argument_legality_exception{"no record in this page"};
-
-        total_page = sh_txs->size() % argument_.limit ? (sh_txs->size() / argument_.limit + 1) : (sh_txs->size() / argument_.limit);
-        tx_count = end >= sh_txs->size() ? (sh_txs->size() - start) : argument_.limit ;
-
-    } else if (!argument_.index && !argument_.limit) { // all tx records
-        start = 0;
-        tx_count = sh_txs->size();
-        argument_.index = 1;
-        total_page = 1;
-    } else {
-        throw argument_legality_exception{"invalid limit or index parameter"};
+    // The cursor is the position of the last transaction of the previous page.
+    blockchain::block_chain_impl::tx_position cursor{ 0, null_hash };
+    if (!option_.cursor.empty()) {
+        data_chunk data;
+        if (!decode_base16(data, option_.cursor) || data.size() != 8 + hash_size)
+            throw argument_legality_exception{"invalid cursor parameter"};
+
+        auto deserial = make_deserializer(data.begin(), data.end());
+        cursor.first = deserial.read_8_bytes_little_endian();
+        cursor.second = deserial.read_hash();
     }
 
-    auto json_helper = config::json_helper(get_api_version());
+    // true if the history row moves the symbol, as an output of the symbol
+    // to the address or as a spend of one, so sending it away is listed.
+    const auto has_symbol = [&](const chain::history_compact& row) {
+        chain::transaction tx;
+        uint64_t tx_height;
+        if (!blockchain.get_transaction(tx, tx_height, row.point.hash))
+            return false;
+
+        auto index = row.point.index;
+        if (row.kind == chain::point_kind::spend) {
+            if (index >= tx.inputs.size())
+                return false;
+
+            const auto previous = tx.inputs[index].previous_output;
+            if (!blockchain.get_transaction(tx, tx_height, previous.hash))
+                return false;
+
+            index = previous.index;
+        }
+
+        if (index >= tx.outputs.size())
+            return false;
+
+        const auto& output = tx.outputs[index];
+        return (output.is_asset() || output.is_asset_cert())
+            && output.get_asset_symbol() == argument_.symbol;
+    };
 
-    // sort by height
-    std::vector<tx_block_info> result(sh_txs->begin() + start, sh_txs->begin() + start + tx_count);
+    blockchain::block_chain_impl::history_filter filter;
+    if (!argument_.symbol.empty())
+        filter = has_symbol;
+
+    // Get the page after the cursor, advancing the cursor.
+    const auto next_page = [&]() {
+        std::vector<tx_block_info> page;
+        while (page.size() < argument_.limit) {
+            const auto positions = blockchain.get_addresses_transactions(
+                *sh_addr_vec, option_.height.first(), option_.height.second(),
+                cursor, argument_.limit, filter);
+
+            for (const auto& position : positions) {
+                if (page.size() >= argument_.limit)
+                    break;
+
+                cursor = position;
+                page.emplace_back(position.first,
+                    blockchain.get_block_timestamp(position.first),
+                    position.second);
+            }
+
+            if (positions.size() < argument_.limit)
+                break;
+        }
+        return page;
+    };
+
+    // Without a cursor the pages before the page index are skipped.
+    if (option_.cursor.empty()) {
+        for (uint64_t index = 1; index < argument_.index; ++index) {
+            if (next_page().empty())
+                throw argument_legality_exception{"no record in this page"};
+        }
+    }
+
+    auto result = next_page();
+    if (result.empty())
+        throw argument_legality_exception{"no record in this page"};
+
+    const uint64_t tx_count = result.size();
+
+    // The cursor of the next page, empty if this is the last.
+    std::string next_cursor;
+    if (tx_count == argument_.limit) {
+        data_chunk data;
+        data_sink ostream(data);
+        ostream_writer sink(ostream);
+        sink.write_8_bytes_little_endian(cursor.first);
+        sink.write_hash(cursor.second);
+        ostream.flush();
+        next_cursor = encode_base16(data);
+    }
+
+    auto json_helper = config::json_helper(get_api_version());
 
     // fetch tx according its hash
     std::vector<std::string> vec_ip_addr; // input addr
@@ -299,16 +354,16 @@ console_result listtxs::invoke(Json::Value& jv_output,
     }
 
     if (get_api_version() == 1) {
-        aroot["total_page"] += total_page;
         aroot["current_page"] += argument_.index;
         aroot["transaction_count"] += tx_count;
     }
     else {
-        aroot["total_page"] = total_page;
         aroot["current_page"] = argument_.index;
         aroot["transaction_count"] = tx_count;
     }
 
+    aroot["cursor"] = next_cursor;
+
     if (get_api_version() == 1 && balances.isNull()) { // compatible for v1
         aroot["transactions"] = "";
     }
@@ -21,6 +21,7 @@
 #include <metaverse/explorer/extensions/commands/startmining.hpp>
 #include <metaverse/macros_define.hpp>
 #include <metaverse/consensus/witness.hpp>
+#include <metaverse/consensus/miner/MinerAux.h>
 #include <metaverse/explorer/dispatch.hpp>
 #include <metaverse/explorer/extensions/command_extension_func.hpp>
 #include <metaverse/explorer/extensions/exception.hpp>
@@ -145,6 +146,7 @@ console_result startmining::invoke(Json::Value& jv_output,
     }
 
     miner.set_miner_payment_address(addr);
+    MinerAux::set_threads(option_.threads);
 
     // start
     if (miner.start(addr, option_.number)){
@@ -62,6 +62,7 @@ p2p::p2p(const settings& settings)
     : settings_(settings),
     stopped_(true),
     height_(0),
+    high_bandwidth_peers_(0),
     hosts_(std::make_shared<hosts>(threadpool_, settings_)),
     connections_(std::make_shared<connections>()),
     stop_subscriber_(std::make_shared<stop_subscriber>(threadpool_, NAME "_stop_sub")),
@@ -324,6 +325,22 @@ bool p2p::stopped() const
     return stopped_;
 }
 
+// The slots are shared by all channels and safe as an atomic.
+bool p2p::reserve_high_bandwidth(size_t limit)
+{
+    auto peers = high_bandwidth_peers_.load();
+
+    while (peers < limit &&
+        !high_bandwidth_peers_.compare_exchange_weak(peers, peers + 1));
+
+    return peers < limit;
+}
+
+void p2p::release_high_bandwidth()
+{
+    --high_bandwidth_peers_;
+}
+
 threadpool& p2p::thread_pool()
 {
     return threadpool_;
@@ -142,7 +142,7 @@ options_metadata parser::load_settings()
     (
         "network.protocol",
         value<uint32_t>(&configured.network.protocol),
-        "The network protocol version, defaults to 70012."
+        "The network protocol version, defaults to 70014."
     )
     (
         "network.identifier",
@@ -291,12 +291,12 @@ options_metadata parser::load_settings()
     (
         "blockchain.block_pool_capacity",
         value<uint32_t>(&configured.chain.block_pool_capacity),
-        "The maximum number of orphan blocks in the pool, defaults to 50."
+        "The maximum number of orphan blocks in the pool, 0 for no limit, defaults to 5000."
     )
     (
         "blockchain.transaction_pool_capacity",
         value<uint32_t>(&configured.chain.transaction_pool_capacity),
-        "The maximum number of transactions in the pool, defaults to 2000."
+        "The maximum number of transactions in the pool, zero stores none, defaults to 4096."
     )
     (
         "blockchain.transaction_pool_consistency",
@@ -318,6 +318,11 @@ options_metadata parser::load_settings()
         value<bool>(&configured.chain.collect_split_stake),
         "Use testnet rules for determination of work required, defaults to false."
     )
+    (
+        "blockchain.script_verification_threads",
+        value<uint32_t>(&configured.chain.script_verification_threads),
+        "The number of threads verifying block input scripts, zero for hardware concurrency, defaults to 0."
+    )
 
     /* [node] */
     (
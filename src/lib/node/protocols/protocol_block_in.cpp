@@ -21,9 +21,13 @@
 #include <metaverse/node/protocols/protocol_block_in.hpp>
 
 #include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <functional>
+#include <map>
 #include <memory>
 #include <string>
+#include <vector>
 #include <metaverse/blockchain.hpp>
 #include <metaverse/network.hpp>
 
@@ -41,9 +45,27 @@ using namespace std::placeholders;
 static constexpr auto perpetual_timer = true;
 static const auto get_blocks_interval = asio::seconds(100);
 
+// Requests of at most this many blocks ask for compact blocks.
+static constexpr size_t compact_request_limit = 4;
+
+// At most this many peers are asked to send new blocks unannounced (BIP152).
+static constexpr size_t high_bandwidth_limit = 3;
+
+// Compact blocks awaiting transactions, beyond this the oldest is dropped.
+static constexpr size_t partial_block_limit = 8;
+
+// Compact requests and partial blocks unanswered for this long are dropped.
+static const auto compact_timeout = asio::seconds(60);
+
+// A serialized transaction with one empty input and output is 60 bytes.
+static constexpr size_t minimum_transaction_size = 60;
+static constexpr size_t compact_transaction_limit = max_block_size /
+    minimum_transaction_size;
+
 protocol_block_in::protocol_block_in(p2p& network, channel::ptr channel,
-    block_chain& blockchain)
+    block_chain& blockchain, transaction_pool& pool)
   : protocol_timer(network, channel, perpetual_timer, NAME),
+    network_(network),
     blockchain_(blockchain),
     last_locator_top_(null_hash),
     current_chain_top_(null_hash),
@@ -51,6 +73,11 @@ protocol_block_in::protocol_block_in(p2p& network, channel::ptr channel,
     // TODO: move send_headers to a derived class protocol_block_in_70012.
     headers_from_peer_(peer_version().value >= version::level::bip130),
     headers_batch_size_{0},
+    pool_(pool),
+    compact_from_peer_(network.network_settings().protocol >=
+        version::level::bip152 && peer_version().value >=
+        version::level::bip152),
+    high_bandwidth_(false),
 
     CONSTRUCT_TRACK(protocol_block_in)
 {
@@ -64,6 +91,13 @@ protocol_block_in::ptr protocol_block_in::do_subscribe()
     // TODO: move not_found to a derived class protocol_block_in_70001.
     SUBSCRIBE2(not_found, handle_receive_not_found, _1, _2);
 
+    if (compact_from_peer_)
+    {
+        SUBSCRIBE2(compact_block, handle_receive_compact_block, _1, _2);
+        SUBSCRIBE2(block_transactions, handle_receive_block_transactions,
+            _1, _2);
+    }
+
     SUBSCRIBE2(inventory, handle_receive_inventory, _1, _2);
     SUBSCRIBE2(block_message, handle_receive_block, _1, _2);
     protocol_timer::start(get_blocks_interval, BIND1(get_block_inventory, _1));
@@ -84,6 +118,9 @@ void protocol_block_in::start()
 //        SEND2(send_headers(), handle_send, _1, send_headers::command);
     }
 
+    if (compact_from_peer_)
+        send_send_compact_blocks();
+
     // Subscribe to block acceptance notifications (for gap fill redundancy).
     blockchain_.subscribe_reorganize(
         BIND4(handle_reorganized, _1, _2, _3, _4));
@@ -97,6 +134,65 @@ void protocol_block_in::start()
     get_block_inventory(error::success);
 }
 
+// Send send_compact_blocks.
+//-----------------------------------------------------------------------------
+
+// Ask the peer for compact blocks, in high bandwidth mode (new blocks sent
+// unannounced) if one of the node's few high bandwidth slots is free.
+void protocol_block_in::send_send_compact_blocks()
+{
+    high_bandwidth_.store(network_.reserve_high_bandwidth(
+        high_bandwidth_limit));
+
+    send_compact_blocks request;
+    request.high_bandwidth_mode = high_bandwidth_.load();
+    request.version = 1;
+    SEND2(request, handle_send, _1, request.command);
+}
+
+void protocol_block_in::release_high_bandwidth()
+{
+    if (high_bandwidth_.exchange(false))
+        network_.release_high_bandwidth();
+}
+
+// Forget compact requests and partial blocks the peer never completed, the
+// blocks are requested again with the next inventory.
+void protocol_block_in::expire_compact_blocks()
+{
+    const auto cutoff = asio::steady_clock::now() - compact_timeout;
+    const auto requests = compact_requests_.expire(cutoff);
+    size_t partials = 0;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+
+    for (auto it = partial_blocks_.begin(); it != partial_blocks_.end();)
+    {
+        if (it->second.started < cutoff)
+        {
+            it = partial_blocks_.erase(it);
+            ++partials;
+        }
+        else
+            ++it;
+    }
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (requests == 0 && partials == 0)
+        return;
+
+    // Unanswered requests no longer hold back the next inventory request.
+    headers_batch_size_ -= requests;
+
+    log::debug(LOG_NODE)
+        << "Expired " << requests << " compact requests and " << partials
+        << " partial blocks from [" << authority() << "]";
+}
+
 // Send get_[headers|blocks] sequence.
 //-----------------------------------------------------------------------------
 
@@ -105,6 +201,7 @@ void protocol_block_in::get_block_inventory(const code& ec)
 {
     if (stopped(ec))
     {
+        release_high_bandwidth();
         blockchain_.fired();
         return;
     }
@@ -118,6 +215,9 @@ void protocol_block_in::get_block_inventory(const code& ec)
         return;
     }
 
+    if (compact_from_peer_)
+        expire_compact_blocks();
+
     auto& blockchain = static_cast<block_chain_impl&>(blockchain_);
     uint64_t top;
     auto is_got = blockchain.get_last_height(top);
@@ -299,10 +399,40 @@ void protocol_block_in::send_get_data(const code& ec, get_data_ptr message)
 
     headers_batch_size_ += message->inventories.size();
 
+    // A few blocks (near the top) are requested in compact form, relying on
+    // the transactions we already have in the pool.
+    if (compact_from_peer_ &&
+        message->inventories.size() <= compact_request_limit)
+    {
+        const auto now = asio::steady_clock::now();
+
+        for (auto& inventory: message->inventories)
+        {
+            if (inventory.type == inventory::type_id::block)
+            {
+                inventory.type = inventory::type_id::compact_block;
+                compact_requests_.insert(inventory.hash, now);
+            }
+        }
+
+        // inventory|headers->get_data[compact_blocks]
+        SEND2(*message, handle_send, _1, message->command);
+        return;
+    }
+
     // inventory|headers->get_data[blocks]
     SEND2(*message, handle_send, _1, message->command);
 }
 
+// Fall back to the full block when a compact block cannot be completed.
+void protocol_block_in::send_get_block(const hash_digest& hash)
+{
+    ++headers_batch_size_;
+
+    const get_data request{ { inventory::type_id::block, hash } };
+    SEND2(request, handle_send, _1, request.command);
+}
+
 // Receive not_found sequence.
 //-----------------------------------------------------------------------------
 
@@ -325,7 +455,16 @@ bool protocol_block_in::handle_receive_not_found(const code& ec,
     hash_list hashes;
     message->to_hashes(hashes, inventory::type_id::block);
 
-    headers_batch_size_ -= hashes.size();
+    hash_list compact_hashes;
+    message->to_hashes(compact_hashes, inventory::type_id::compact_block);
+    size_t compact_requests = 0;
+
+    // A request already expired has been taken out of the batch.
+    for (const auto& hash: compact_hashes)
+        compact_requests += compact_requests_.erase(hash) ? 1 : 0;
+
+    headers_batch_size_ -= hashes.size() + compact_requests;
+    hashes.insert(hashes.end(), compact_hashes.begin(), compact_hashes.end());
 
     // The peer cannot locate a block that it told us it had.
     // This only results from reorganization assuming peer is proper.
@@ -356,6 +495,23 @@ bool protocol_block_in::handle_receive_block(const code& ec, block_ptr message)
         return false;
     }
 
+    // A peer may answer a compact request with the full block, which is then
+    // no longer outstanding and must not expire out of the batch again.
+    compact_requests_.erase(message->header.hash());
+    handle_requested_block();
+
+    // We will pick this up in handle_reorganized.
+    message->set_originator(nonce());
+
+    log::trace(LOG_NODE) << "from " << authority() << ",receive block hash," << encode_hash(message->header.hash()) << ",tx-size," << message->header.transaction_count << ",number," << message->header.number ;
+
+    blockchain_.store(message, BIND2(handle_store_block, _1, message));
+    return true;
+}
+
+// A block of the last get_data arrived, full or compact.
+void protocol_block_in::handle_requested_block()
+{
     --headers_batch_size_;
 
     if(!headers_batch_size_.load())
@@ -366,16 +522,253 @@ bool protocol_block_in::handle_receive_block(const code& ec, block_ptr message)
     // Reset the timer because we just received a block from this peer.
     // Once we are at the top this will end up polling the peer.
     reset_timer();
+}
 
-    // We will pick this up in handle_reorganized.
-    message->set_originator(nonce());
+// Receive compact block sequence.
+//-----------------------------------------------------------------------------
 
-    log::trace(LOG_NODE) << "from " << authority() << ",receive block hash," << encode_hash(message->header.hash()) << ",tx-size," << message->header.transaction_count << ",number," << message->header.number ;
+bool protocol_block_in::handle_receive_compact_block(const code& ec,
+    compact_block_ptr message)
+{
+    if (stopped(ec))
+        return false;
 
-    blockchain_.store(message, BIND2(handle_store_block, _1, message));
+    if (ec)
+    {
+        log::trace(LOG_NODE)
+            << "Failure getting compact block from [" << authority() << "] "
+            << ec.message();
+        stop(ec);
+        return false;
+    }
+
+    const auto requested = compact_requests_.erase(message->header.hash());
+
+    // Blocks pushed unannounced (high bandwidth) were not part of a batch.
+    // A fallback to the full block is counted again by send_get_block.
+    if (requested)
+        handle_requested_block();
+    else
+        reset_timer();
+
+    // Match the short ids against the transactions in our pool.
+    pool_.fetch(BIND3(handle_fetch_pool, _1, _2, message));
+    return true;
+}
+
+void protocol_block_in::handle_fetch_pool(const code& ec,
+    const transaction_ptr_list& transactions, compact_block_ptr message)
+{
+    if (stopped(ec))
+        return;
+
+    const auto hash = message->header.hash();
+
+    if (ec)
+    {
+        log::debug(LOG_NODE)
+            << "Failure reading pool for compact block ["
+            << encode_hash(hash) << "] " << ec.message();
+        send_get_block(hash);
+        return;
+    }
+
+    const auto count = message->short_ids.size() +
+        message->transactions.size();
+
+    // The peer sets the count, it cannot exceed what fits in a block.
+    if (count > compact_transaction_limit)
+    {
+        log::debug(LOG_NODE)
+            << "Oversized compact block [" << encode_hash(hash)
+            << "] from [" << authority() << "]";
+        stop(error::channel_stopped);
+        return;
+    }
+
+    const auto block = std::make_shared<block_message>();
+    block->header = message->header;
+    block->header.transaction_count = count;
+    block->transactions.resize(count);
+    std::vector<bool> filled(count, false);
+
+    // Prefilled indexes are differentially encoded, each relative to the
+    // index following the previous prefilled transaction.
+    uint64_t next = 0;
+
+    for (const auto& prefilled: message->transactions)
+    {
+        const auto index = next + prefilled.index;
+
+        if (index < next || index >= count)
+        {
+            log::debug(LOG_NODE)
+                << "Invalid compact block [" << encode_hash(hash)
+                << "] from [" << authority() << "]";
+            stop(error::channel_stopped);
+            return;
+        }
+
+        block->transactions[index] = prefilled.transaction;
+        filled[index] = true;
+        next = index + 1;
+    }
+
+    // Colliding short ids in the pool are treated as missing.
+    const auto key = message->short_id_key();
+    std::map<compact_block::short_id, transaction_ptr> pool_ids;
+
+    for (const auto& tx: transactions)
+    {
+        const auto id = compact_block::to_short_id(key, tx->hash());
+        const auto result = pool_ids.emplace(id, tx);
+
+        if (!result.second)
+            result.first->second = nullptr;
+    }
+
+    std::vector<uint64_t> missing;
+    auto id = message->short_ids.begin();
+
+    for (uint64_t index = 0; index < count; ++index)
+    {
+        if (filled[index])
+            continue;
+
+        const auto found = pool_ids.find(*id++);
+
+        if (found == pool_ids.end() || !found->second)
+            missing.push_back(index);
+        else
+            block->transactions[index] = *found->second;
+    }
+
+    if (missing.empty())
+    {
+        handle_reconstructed(block);
+        return;
+    }
+
+    log::trace(LOG_NODE)
+        << "Compact block [" << encode_hash(hash) << "] from ["
+        << authority() << "] missing " << missing.size() << " of "
+        << count << " transactions.";
+
+    // Ask for the missing transactions, differentially encoded.
+    get_block_transactions request;
+    request.block_hash = hash;
+    request.indexes.reserve(missing.size());
+    next = 0;
+
+    for (const auto index: missing)
+    {
+        request.indexes.push_back(index - next);
+        next = index + 1;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+
+    // A peer that never answers cannot grow the map without bound.
+    if (partial_blocks_.size() >= partial_block_limit)
+    {
+        const auto oldest = std::min_element(partial_blocks_.begin(),
+            partial_blocks_.end(), [](const partial_block_map::value_type& left,
+                const partial_block_map::value_type& right)
+            {
+                return left.second.started < right.second.started;
+            });
+
+        partial_blocks_.erase(oldest);
+    }
+
+    partial_blocks_[hash] = partial_block{ block, std::move(missing),
+        asio::steady_clock::now() };
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    SEND2(request, handle_send, _1, request.command);
+}
+
+bool protocol_block_in::handle_receive_block_transactions(const code& ec,
+    block_transactions_ptr message)
+{
+    if (stopped(ec))
+        return false;
+
+    if (ec)
+    {
+        log::trace(LOG_NODE)
+            << "Failure getting block transactions from [" << authority()
+            << "] " << ec.message();
+        stop(ec);
+        return false;
+    }
+
+    partial_block partial;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+
+    const auto it = partial_blocks_.find(message->block_hash);
+    const auto found = it != partial_blocks_.end();
+
+    if (found)
+    {
+        partial = std::move(it->second);
+        partial_blocks_.erase(it);
+    }
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Ignore transactions of a block we did not ask for.
+    if (!found)
+        return true;
+
+    if (message->transactions.size() != partial.missing.size())
+    {
+        log::debug(LOG_NODE)
+            << "Incomplete block transactions [" << encode_hash(
+            message->block_hash) << "] from [" << authority() << "]";
+        send_get_block(message->block_hash);
+        return true;
+    }
+
+    for (size_t position = 0; position < partial.missing.size(); ++position)
+        partial.block->transactions[partial.missing[position]] =
+            std::move(message->transactions[position]);
+
+    handle_reconstructed(partial.block);
     return true;
 }
 
+void protocol_block_in::handle_reconstructed(block_ptr block)
+{
+    const auto& header = block->header;
+
+    // A short id collision with the pool yields the wrong transactions.
+    if (chain::block::generate_merkle_root(block->transactions) !=
+        header.merkle)
+    {
+        log::debug(LOG_NODE)
+            << "Compact block [" << encode_hash(header.hash())
+            << "] from [" << authority() << "] failed to reconstruct.";
+        send_get_block(header.hash());
+        return;
+    }
+
+    // We will pick this up in handle_reorganized.
+    block->set_originator(nonce());
+
+    log::trace(LOG_NODE) << "from " << authority() << ",receive compact block hash," << encode_hash(header.hash()) << ",tx-size," << header.transaction_count << ",number," << header.number ;
+
+    blockchain_.store(block, BIND2(handle_store_block, _1, block));
+}
+
 void protocol_block_in::handle_store_block(const code& ec, block_ptr message)
 {
     if (stopped(ec))
@@ -390,6 +783,15 @@ void protocol_block_in::handle_store_block(const code& ec, block_ptr message)
         return;
     }
 
+    // The orphan pool is full of other chains, drop the block but keep the peer.
+    if (ec.value() == error::pool_filled)
+    {
+        log::debug(LOG_NODE)
+            << "Orphan pool full, dropped block from [" << authority() << "] "
+            << encode_hash(message->header.hash());
+        return;
+    }
+
     if(ec.value() == error::fetch_more_block)
     {
         log::trace(LOG_NODE)
@@ -54,6 +54,11 @@ protocol_block_out::protocol_block_out(p2p& network, channel::ptr channel,
     // TODO: move send_headers to a derived class protocol_block_out_70012.
     headers_to_peer_(network.network_settings().protocol >=
         version::level::bip130),
+    compact_capable_(network.network_settings().protocol >=
+        version::level::bip152 && peer_version().value >=
+        version::level::bip152),
+    compact_to_peer_(false),
+    compact_high_bandwidth_(false),
 
     CONSTRUCT_TRACK(protocol_block_out)
 {
@@ -68,6 +73,14 @@ protocol_block_out::ptr protocol_block_out::do_subscribe()
         SUBSCRIBE2(send_headers, handle_receive_send_headers, _1, _2);
     }
 
+    if (compact_capable_)
+    {
+        SUBSCRIBE2(send_compact_blocks, handle_receive_send_compact_blocks,
+            _1, _2);
+        SUBSCRIBE2(get_block_transactions,
+            handle_receive_get_block_transactions, _1, _2);
+    }
+
     // TODO: move get_headers to a derived class protocol_block_out_31800.
     SUBSCRIBE2(get_headers, handle_receive_get_headers, _1, _2);
     SUBSCRIBE2(get_blocks, handle_receive_get_blocks, _1, _2);
@@ -119,6 +132,40 @@ bool protocol_block_out::handle_receive_send_headers(const code& ec,
     return false;
 }
 
+// Receive send_compact_blocks.
+//-----------------------------------------------------------------------------
+
+bool protocol_block_out::handle_receive_send_compact_blocks(const code& ec,
+    send_compact_blocks_ptr message)
+{
+    if (stopped(ec))
+        return false;
+
+    if (ec)
+    {
+        log::trace(LOG_NODE)
+            << "Failure getting " << message->command << " from ["
+            << authority() << "] " << ec.message();
+        stop(ec);
+        return false;
+    }
+
+    // Only version 1 (no witness) compact blocks are supported.
+    if (message->version != 1)
+        return true;
+
+    // The peer may switch between high and low bandwidth at any time.
+    compact_to_peer_.store(true);
+    compact_high_bandwidth_.store(message->high_bandwidth_mode);
+
+    log::trace(LOG_NODE)
+        << "Peer [" << authority() << "] requests compact blocks in "
+        << (message->high_bandwidth_mode ? "high" : "low")
+        << " bandwidth mode.";
+
+    return true;
+}
+
 // Receive get_headers sequence.
 //-----------------------------------------------------------------------------
 
@@ -322,6 +369,9 @@ bool protocol_block_out::handle_receive_get_data(const code& ec,
         else if (inventory.type == inventory::type_id::filtered_block)
             blockchain_.fetch_merkle_block(inventory.hash,
                 BIND3(send_merkle_block, _1, _2, inventory.hash));
+        else if (inventory.type == inventory::type_id::compact_block)
+            blockchain_.fetch_block(inventory.hash,
+                BIND3(send_compact_block, _1, _2, inventory.hash));
     }
 
     return true;
@@ -388,6 +438,123 @@ void protocol_block_out::send_merkle_block(const code& ec,
     SEND2(*message, handle_send, _1, message->command);
 }
 
+// A peer that has not asked for compact blocks is sent the full block.
+void protocol_block_out::send_compact_block(const code& ec,
+    chain::block::ptr block, const hash_digest& hash)
+{
+    if (stopped(ec))
+        return;
+
+    if (ec.value() == error::not_found)
+    {
+        log::trace(LOG_NODE)
+            << "Compact block requested by [" << authority() << "] not found."
+            << encode_hash(hash);
+
+        const not_found reply{ { inventory::type_id::compact_block, hash } };
+        SEND2(reply, handle_send, _1, reply.command);
+        return;
+    }
+
+    if (ec)
+    {
+        log::error(LOG_NODE)
+            << "Internal failure locating compact block requested by ["
+            << authority() << "] " << ec.message();
+        stop(ec);
+        return;
+    }
+
+    if (!compact_to_peer_)
+    {
+        SEND2(block_message(*block), handle_send, _1, block_message::command);
+        return;
+    }
+
+    const auto compact = compact_block::factory_from_block(*block,
+        pseudo_random());
+    SEND2(compact, handle_send, _1, compact.command);
+}
+
+// Receive get_block_transactions sequence.
+//-----------------------------------------------------------------------------
+
+bool protocol_block_out::handle_receive_get_block_transactions(
+    const code& ec, get_block_transactions_ptr message)
+{
+    if (stopped(ec))
+        return false;
+
+    if (ec)
+    {
+        log::trace(LOG_NODE)
+            << "Failure getting get_block_transactions from ["
+            << authority() << "] " << ec.message();
+        stop(ec);
+        return false;
+    }
+
+    blockchain_.fetch_block(message->block_hash,
+        BIND3(send_block_transactions, _1, _2, message));
+    return true;
+}
+
+void protocol_block_out::send_block_transactions(const code& ec,
+    chain::block::ptr block, get_block_transactions_ptr request)
+{
+    if (stopped(ec))
+        return;
+
+    if (ec.value() == error::not_found)
+    {
+        log::trace(LOG_NODE)
+            << "Block transactions requested by [" << authority()
+            << "] not found." << encode_hash(request->block_hash);
+
+        const not_found reply{ { inventory::type_id::block,
+            request->block_hash } };
+        SEND2(reply, handle_send, _1, reply.command);
+        return;
+    }
+
+    if (ec)
+    {
+        log::error(LOG_NODE)
+            << "Internal failure locating block transactions requested by ["
+            << authority() << "] " << ec.message();
+        stop(ec);
+        return;
+    }
+
+    const auto& transactions = block->transactions;
+    block_transactions response;
+    response.block_hash = request->block_hash;
+    response.transactions.reserve(request->indexes.size());
+
+    // Indexes are differentially encoded, each relative to the index
+    // following the previous one.
+    uint64_t next = 0;
+
+    for (const auto offset: request->indexes)
+    {
+        const auto index = next + offset;
+
+        if (index < next || index >= transactions.size())
+        {
+            log::debug(LOG_NODE)
+                << "Invalid block transaction index requested by ["
+                << authority() << "] ";
+            stop(error::channel_stopped);
+            return;
+        }
+
+        response.transactions.push_back(transactions[index]);
+        next = index + 1;
+    }
+
+    SEND2(response, handle_send, _1, response.command);
+}
+
 // Subscription.
 //-----------------------------------------------------------------------------
 
@@ -417,6 +584,22 @@ bool protocol_block_out::handle_reorganized(const code& ec, size_t fork_point,
     BITCOIN_ASSERT(max_size_t - fork_point >= incoming.size());
     current_chain_height_.store(fork_point + incoming.size());
 
+    // A high bandwidth peer is sent new blocks unannounced in compact form.
+    if (compact_high_bandwidth_ && incoming.size() <= compact_announce_limit)
+    {
+        for (const auto& block: incoming)
+        {
+            if (block->originator() == nonce())
+                continue;
+
+            const auto compact = compact_block::factory_from_block(*block,
+                pseudo_random());
+            SEND2(compact, handle_send, _1, compact.command);
+        }
+
+        return true;
+    }
+
     // TODO: move announce headers to a derived class protocol_block_in_70012.
     if (headers_to_peer_)
     {
@@ -52,7 +52,7 @@ void session_inbound::attach_handshake_protocols(channel::ptr channel,
         if (!ec) {
             auto pt_ping = attach<protocol_ping>(channel);
             auto pt_address = attach<protocol_address>(channel);
-            auto pt_block_in = attach<protocol_block_in>(channel, blockchain_);
+            auto pt_block_in = attach<protocol_block_in>(channel, blockchain_, pool_);
             auto pt_block_out = attach<protocol_block_out>(channel, blockchain_);
             auto pt_tx_in = attach<protocol_transaction_in>(channel, blockchain_, pool_);
             auto pt_tx_out = attach<protocol_transaction_out>(channel, blockchain_, pool_);
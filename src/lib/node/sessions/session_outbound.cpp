@@ -53,7 +53,7 @@ void session_outbound::attach_handshake_protocols(channel::ptr channel,
         if (!ec) {
             auto pt_ping = attach<protocol_ping>(channel)->do_subscribe();
             auto pt_address = attach<protocol_address>(channel)->do_subscribe();
-            auto pt_block_in = attach<protocol_block_in>(channel, blockchain_)->do_subscribe();
+            auto pt_block_in = attach<protocol_block_in>(channel, blockchain_, pool_)->do_subscribe();
             auto pt_block_out = attach<protocol_block_out>(channel, blockchain_)->do_subscribe();
             auto pt_tx_in = attach<protocol_transaction_in>(channel, blockchain_, pool_)->do_subscribe();
             auto pt_tx_out = attach<protocol_transaction_out>(channel, blockchain_, pool_)->do_subscribe();
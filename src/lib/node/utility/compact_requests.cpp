@@ -0,0 +1,80 @@
+/**
+ * Copyright (c) 2011-2021 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/node/utility/compact_requests.hpp>
+
+#include <cstddef>
+#include <metaverse/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+void compact_requests::insert(const hash_digest& hash,
+    asio::time_point requested)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+    requests_[hash] = requested;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool compact_requests::erase(const hash_digest& hash)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+    return requests_.erase(hash) != 0;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t compact_requests::expire(asio::time_point cutoff)
+{
+    size_t expired = 0;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    for (auto it = requests_.begin(); it != requests_.end();)
+    {
+        if (it->second < cutoff)
+        {
+            it = requests_.erase(it);
+            ++expired;
+        }
+        else
+            ++it;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    return expired;
+}
+
+size_t compact_requests::size() const
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(mutex_);
+    return requests_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+} // namespace node
+} // namespace libbitcoin
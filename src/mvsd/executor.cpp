@@ -155,6 +155,16 @@ bool executor::do_initchain()
                 throw std::runtime_error{ " upgrade database to version 63 failed!" };
             }
         }
+
+        const auto history_height =
+            metadata_.configured.database.history_start_height;
+        for (uint32_t version = 65; version <= MVS_DATABASE_VERSION_NUMBER;
+            ++version) {
+            if (!data_base::upgrade_version(data_path, version, history_height)) {
+                throw std::runtime_error{ " upgrade database to version "
+                    + std::to_string(version) + " failed!" };
+            }
+        }
     }
 
     if (ec.value() == directory_exists)
@@ -19,8 +19,10 @@
 
 #include <metaverse/mgbubble/HttpServ.hpp>
 #include <metaverse/mgbubble/exception/Instances.hpp>
+#include <metaverse/mgbubble/utility/JsonWriter.hpp>
 #include <metaverse/mgbubble/utility/Stream_buf.hpp>
 
+#include <metaverse/explorer/generated.hpp>
 #include <metaverse/explorer/extensions/command_extension_func.hpp>
 #include <metaverse/explorer/extensions/exception.hpp>
 #include <metaverse/server/server_node.hpp>
@@ -28,7 +30,6 @@
 namespace mgbubble {
 using namespace libbitcoin;
 
-thread_local OStream HttpServ::out_;
 thread_local Tokeniser<'/'> HttpServ::uri_;
 thread_local int HttpServ::state_ = 0;
 
@@ -66,19 +67,217 @@ void HttpServ::reset(HttpMessage& data) noexcept
 void HttpServ::rpc_request(mg_connection& nc, HttpMessage data, uint8_t rpc_version)
 {
     reset(data);
-    StreamBuf buf{ nc.send_mbuf };
-    out_.rdbuf(&buf);
-    out_.reset(200, "OK");
 
+    // Responses leave in request order even when a keep-alive client
+    // pipelines calls that finish out of order on the workers.
+    auto& state = rpc_connections_[&nc];
+    if (state.generation == 0)
+        state.generation = ++rpc_generation_;
+
+    const auto order = state.issued++;
+
+    std::vector<std::string> args;
+    Json::Value params;
     try {
         check_rpc_client_addresses(nc);
 
         data.data_to_arg(rpc_version);
+        args = data.args();
+        params = data.jsonrpc_params();
+    }
+    catch (const libbitcoin::explorer::explorer_exception& e) {
+        rpc_deliver(nc, order, { rpc_error(e, data.jsonrpc_id(), rpc_version) });
+        return;
+    }
+    catch (const std::exception& e) {
+        libbitcoin::explorer::explorer_exception ex(1000, e.what());
+        rpc_deliver(nc, order, { rpc_error(ex, data.jsonrpc_id(), rpc_version) });
+        return;
+    }
 
-        Json::Value jv_output;
+    const auto generation = state.generation;
+    if (!data.batch().empty()) {
+        rpc_batch(nc, generation, order, data.batch(), rpc_version);
+        return;
+    }
+
+    const auto id = data.jsonrpc_id();
+    const auto parts = std::make_shared<rpc_parts>(1);
+    auto connection = &nc;
+
+    rpc_job job;
+    job.method = args.empty() ? std::string{} : args.front();
+    job.run = [this, connection, generation, order, parts, args, params, id, rpc_version]() {
+        parts->front() = rpc_invoke(args, params, id, rpc_version);
+        rpc_complete(connection, generation, order, parts);
+    };
+
+    rpc_submit(std::move(job));
+}
+
+void HttpServ::rpc_batch(mg_connection& nc, uint64_t generation, uint64_t order,
+    const std::vector<JsonRpcCall>& calls, uint8_t rpc_version)
+{
+    struct batch_state
+    {
+        rpc_parts parts;
+        std::atomic<size_t> remaining{0};
+    };
+
+    // The reply is written as "[", r0, ",", r1, ..., "]" so that results
+    // are never joined into one document. Each worker owns its own slot.
+    auto batch = std::make_shared<batch_state>();
+    auto& parts = batch->parts;
+    parts.resize(2 * calls.size() + 1, ",");
+    parts.front() = "[";
+    parts.back() = "]";
+
+    const std::shared_ptr<rpc_parts> result(batch, &batch->parts);
+    auto connection = &nc;
+
+    // Independent queries run concurrently, account and admin calls keep
+    // their order within the batch on a single job.
+    std::vector<size_t> queries;
+    std::vector<size_t> exclusive;
+    for (size_t index = 0; index < calls.size(); ++index) {
+        const auto& call = calls[index];
+        if (call.error_code != 0) {
+            libbitcoin::explorer::explorer_exception ex(call.error_code, call.error_message);
+            parts[2 * index + 1] = rpc_error(ex, call.id, rpc_version);
+        }
+        else if (call.args.empty()) {
+            libbitcoin::explorer::jsonrpc_invalid_request ex;
+            parts[2 * index + 1] = rpc_error(ex, call.id, rpc_version);
+        }
+        else if (rpc_exclusive(call.args.front())) {
+            exclusive.push_back(index);
+        }
+        else {
+            queries.push_back(index);
+        }
+    }
+
+    batch->remaining = queries.size() + (exclusive.empty() ? 0 : 1);
+    if (batch->remaining == 0) {
+        rpc_deliver(nc, order, std::move(parts));
+        return;
+    }
+
+    auto done = [this, connection, generation, order, batch, result]() {
+        if (--batch->remaining == 0)
+            rpc_complete(connection, generation, order, result);
+    };
+
+    for (const auto index : queries) {
+        const auto& call = calls[index];
+
+        rpc_job job;
+        job.method = call.args.front();
+        job.run = [this, batch, index, call, rpc_version, done]() {
+            batch->parts[2 * index + 1] = rpc_invoke(call.args, call.params, call.id, rpc_version);
+            done();
+        };
+        rpc_submit(std::move(job));
+    }
+
+    if (!exclusive.empty()) {
+        std::vector<JsonRpcCall> ordered;
+        for (const auto index : exclusive)
+            ordered.push_back(calls[index]);
+
+        rpc_job job;
+        job.method = ordered.front().args.front();
+        job.run = [this, batch, exclusive, ordered, rpc_version, done]() {
+            for (size_t item = 0; item < ordered.size(); ++item)
+                batch->parts[2 * exclusive[item] + 1] = rpc_invoke(
+                    ordered[item].args, ordered[item].params, ordered[item].id,
+                    rpc_version);
+            done();
+        };
+        rpc_submit(std::move(job));
+    }
+}
+
+void HttpServ::rpc_complete(mg_connection* connection, uint64_t generation,
+    uint64_t order, std::shared_ptr<rpc_parts> parts)
+{
+    std::function<void(uint64_t)> deliver =
+        [this, connection, generation, order, parts](uint64_t) {
+        // The connection may have closed (and its address been reused)
+        // while the command was running.
+        auto it = rpc_connections_.find(connection);
+        if (it == rpc_connections_.end() || it->second.generation != generation)
+            return;
+
+        rpc_deliver(*connection, order, std::move(*parts));
+    };
+
+    if (spawn_to_mongoose(std::function<void(uint64_t)>(deliver)))
+        return;
+
+    // Later replies on the connection wait for this one, so it is kept for
+    // the event loop to deliver after its next poll.
+    log::warning(LOG_HTTP) << "rpc reply notify failed, deferred to the event loop";
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    std::lock_guard<std::mutex> lock(rpc_mutex_);
+    rpc_undelivered_.push_back(std::move(deliver));
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void HttpServ::rpc_flush()
+{
+    std::vector<std::function<void(uint64_t)>> undelivered;
+
+    {
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section
+        std::lock_guard<std::mutex> lock(rpc_mutex_);
+        undelivered.swap(rpc_undelivered_);
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    for (const auto& deliver : undelivered)
+        deliver(0);
+}
 
-        auto retcode = explorer::dispatch_command(data.argc(), const_cast<const char**>(data.argv()),
-                       jv_output, node_, rpc_version);
+std::string HttpServ::rpc_invoke(const std::vector<std::string>& args,
+    const Json::Value& params, int64_t id, uint8_t rpc_version)
+{
+    std::vector<const char*> argv;
+    argv.reserve(args.size());
+    for (const auto& arg : args)
+        argv.push_back(arg.c_str());
+
+    const auto pretty = node_.server_settings().pretty_json;
+    std::string out;
+
+    try {
+        if (argv.empty())
+            throw std::logic_error{"no command found"};
+
+        Json::Value jv_output;
+        console_result retcode;
+
+        // Commands with a typed binding skip argv and program_options.
+        const auto dispatch = [&]() {
+            if (!explorer::dispatch_json(args.front(), params, jv_output,
+                retcode, node_, rpc_version))
+                retcode = explorer::dispatch_command(argv.size(), argv.data(),
+                    jv_output, node_, rpc_version);
+        };
+
+        if (rpc_exclusive(args.front())) {
+            ///////////////////////////////////////////////////////////////////
+            // Critical Section
+            std::lock_guard<std::mutex> lock(exclusive_mutex_);
+            dispatch();
+            ///////////////////////////////////////////////////////////////////
+        }
+        else {
+            dispatch();
+        }
 
         if (retcode == console_result::failure) { // only orignal command
             if (rpc_version == 1 && !jv_output.isObject() && !jv_output.isArray()) {
@@ -90,91 +289,278 @@ void HttpServ::rpc_request(mg_connection& nc, HttpMessage data, uint8_t rpc_vers
         if (retcode == console_result::okay) {
             if (rpc_version == 1) {
                 if (jv_output.isObject() || jv_output.isArray())
-                    out_ << jv_output.toStyledString();
+                    writeJson(out, jv_output, pretty);
                 else
-                    out_ << jv_output.asString();
+                    out = jv_output.asString();
             }
             else {
                 Json::Value jv_root;
                 jv_root["jsonrpc"] = "2.0";
-                jv_root["id"] = data.jsonrpc_id();
-                jv_root["result"] = jv_output;
+                jv_root["id"] = id;
+                jv_root["result"].swap(jv_output);
 
-                out_ << jv_root.toStyledString();
+                writeJson(out, jv_root, pretty);
             }
         }
     }
     catch (const libbitcoin::explorer::explorer_exception& e) {
-        if (rpc_version == 1) {
-            out_ << e;
-        }
-        else {
-            Json::Value root;
-            root["jsonrpc"] = "2.0";
-            root["id"] = data.jsonrpc_id();
-            root["error"]["code"] = (int32_t)e.code();
-            root["error"]["message"] = e.what();
+        return rpc_error(e, id, rpc_version);
+    }
+    catch (const std::exception& e) {
+        libbitcoin::explorer::explorer_exception ex(1000, e.what());
+        return rpc_error(ex, id, rpc_version);
+    }
+
+    return out;
+}
+
+std::string HttpServ::rpc_error(const libbitcoin::explorer::explorer_exception& e,
+    int64_t id, uint8_t rpc_version) const
+{
+    std::ostringstream out;
+    if (rpc_version == 1) {
+        out << e;
+    }
+    else {
+        Json::Value root;
+        root["jsonrpc"] = "2.0";
+        root["id"] = id;
+        root["error"]["code"] = (int32_t)e.code();
+        root["error"]["message"] = e.what();
+
+        writeJson(out, root, node_.server_settings().pretty_json);
+    }
+    return out.str();
+}
+
+bool HttpServ::rpc_exclusive(const std::string& method) const
+{
+    // Wallet and administrative commands were written against a single
+    // rpc thread, keep them mutually exclusive.
+    const auto command = explorer::find(method);
+    if (!command)
+        return false;
 
-            out_ << root.toStyledString();
+    return command->category(explorer::ctgy_account_required)
+        || command->category(explorer::ctgy_admin_required);
+}
+
+void HttpServ::rpc_submit(rpc_job&& job)
+{
+    const auto limit = node_.server_settings().rpc_method_concurrency;
+    ++rpc_queue_depth_;
+
+    {
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section
+        std::lock_guard<std::mutex> lock(rpc_mutex_);
+
+        auto& running = rpc_running_[job.method];
+        if (limit != 0 && running >= limit) {
+            log::debug(LOG_HTTP) << "rpc " << job.method << " waiting, "
+                << rpc_queue_depth() << " queued";
+            rpc_waiting_.push_back(std::move(job));
+            return;
         }
+
+        ++running;
+        ///////////////////////////////////////////////////////////////////////
     }
-    catch (const std::exception& e) {
-        if (rpc_version == 1) {
-            libbitcoin::explorer::explorer_exception ex(1000, e.what());
-            out_ << ex;
+
+    rpc_post(std::move(job));
+}
+
+void HttpServ::rpc_post(rpc_job&& job)
+{
+    log::debug(LOG_HTTP) << "rpc " << job.method << " dispatched, "
+        << rpc_queue_depth() << " queued";
+
+    auto shared = std::make_shared<rpc_job>(std::move(job));
+    rpc_pool_.service().post([this, shared]() {
+        --rpc_queue_depth_;
+        shared->run();
+        rpc_finish(shared->method);
+    });
+}
+
+void HttpServ::rpc_finish(const std::string& method)
+{
+    const auto limit = node_.server_settings().rpc_method_concurrency;
+    rpc_job next;
+    auto found = false;
+
+    {
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section
+        std::lock_guard<std::mutex> lock(rpc_mutex_);
+
+        auto running = rpc_running_.find(method);
+        if (running != rpc_running_.end() && --running->second == 0)
+            rpc_running_.erase(running);
+
+        // Start the oldest waiting call whose method now has a free slot.
+        for (auto it = rpc_waiting_.begin(); it != rpc_waiting_.end(); ++it) {
+            auto& count = rpc_running_[it->method];
+            if (count < limit) {
+                ++count;
+                next = std::move(*it);
+                rpc_waiting_.erase(it);
+                found = true;
+                break;
+            }
         }
-        else {
-            Json::Value root;
-            root["jsonrpc"] = "2.0";
-            root["id"] = data.jsonrpc_id();
-            root["error"]["code"] = 1000;
-            root["error"]["message"] = e.what();
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    if (found)
+        rpc_post(std::move(next));
+}
 
-            out_ << root.toStyledString();
+void HttpServ::rpc_deliver(mg_connection& nc, uint64_t order, rpc_parts&& parts)
+{
+    auto it = rpc_connections_.find(&nc);
+    if (it == rpc_connections_.end())
+        return;
+
+    auto& state = it->second;
+    state.ready.emplace(order, std::move(parts));
+
+    for (auto ready = state.ready.begin(); ready != state.ready.end()
+        && ready->first == state.sent; ready = state.ready.erase(ready)) {
+        if (state.websocket) {
+            std::string frame;
+            for (const auto& part : ready->second)
+                frame += part;
+
+            send_frame(nc, frame);
+            ++state.sent;
+            continue;
         }
+
+        size_t length = 0;
+        for (const auto& part : ready->second)
+            length += part.size();
+
+        std::ostringstream head;
+        head << "HTTP/1.1 200 OK\r\nContent-Type: text/plain;charset=utf-8\r\n"
+            << "Content-Length: " << length << "\r\n\r\n";
+
+        send(nc, head.str());
+        for (const auto& part : ready->second)
+            send(nc, part);
+        ++state.sent;
     }
-    out_.setContentLength();
 }
 
 void HttpServ::ws_request(mg_connection& nc, WebsocketMessage ws)
 {
-    Json::Value jv_output;
+    // Frames are answered in arrival order, commands run on the workers.
+    auto& state = rpc_connections_[&nc];
+    if (state.generation == 0)
+        state.generation = ++rpc_generation_;
+
+    state.websocket = true;
+    const auto order = state.issued++;
 
+    std::vector<std::string> args;
     try {
         check_rpc_client_addresses(nc);
 
         ws.data_to_arg();
+        args = ws.args();
+        if (args.empty())
+            throw std::logic_error{"no command found"};
+    }
+    catch (const std::exception& e) {
+        rpc_deliver(nc, order, { ws_error(e.what()) });
+        return;
+    }
+
+    const auto generation = state.generation;
+    const auto parts = std::make_shared<rpc_parts>(1);
+    auto connection = &nc;
+
+    rpc_job job;
+    job.method = args.front();
+    job.run = [this, connection, generation, order, parts, args]() {
+        parts->front() = ws_invoke(args);
+        rpc_complete(connection, generation, order, parts);
+    };
 
-        console_result retcode = explorer::dispatch_command(ws.argc(), const_cast<const char**>(ws.argv()), jv_output, node_);
+    rpc_submit(std::move(job));
+}
+
+std::string HttpServ::ws_invoke(const std::vector<std::string>& args)
+{
+    std::vector<const char*> argv;
+    argv.reserve(args.size());
+    for (const auto& arg : args)
+        argv.push_back(arg.c_str());
+
+    Json::Value jv_output;
+
+    try {
+        console_result retcode;
+        if (rpc_exclusive(args.front())) {
+            ///////////////////////////////////////////////////////////////////
+            // Critical Section
+            std::lock_guard<std::mutex> lock(exclusive_mutex_);
+            retcode = explorer::dispatch_command(argv.size(), argv.data(), jv_output, node_);
+            ///////////////////////////////////////////////////////////////////
+        }
+        else {
+            retcode = explorer::dispatch_command(argv.size(), argv.data(), jv_output, node_);
+        }
         if (retcode != console_result::okay) {
             throw explorer::command_params_exception(jv_output.asString());
         }
 
     } catch (const std::exception& e) {
-        jv_output = Json::objectValue;
-        jv_output["error"]["code"] = 1000;
-        jv_output["error"]["message"] = e.what();
+        return ws_error(e.what());
     }
 
     if (jv_output.isObject() || jv_output.isArray())
-        send_frame(nc, jv_output.toStyledString());
-    else
-        send_frame(nc, jv_output.asString());
+        return toJson(jv_output, node_.server_settings().pretty_json);
+
+    return jv_output.asString();
+}
+
+std::string HttpServ::ws_error(const std::string& message) const
+{
+    Json::Value jv_output;
+    jv_output["error"]["code"] = 1000;
+    jv_output["error"]["message"] = message;
+    return toJson(jv_output, node_.server_settings().pretty_json);
 }
 
 bool HttpServ::start()
 {
     if (!attach_notify())
         return false;
+
+    const auto threads = node_.server_settings().rpc_threads;
+    rpc_pool_.spawn(std::max<size_t>(threads, 1));
+
     return base::start();
 }
 
-void HttpServ::spawn_to_mongoose(const std::function<void(uint64_t)>&& handler)
+void HttpServ::stop()
+{
+    // Drain running commands while the loop can still deliver responses.
+    rpc_pool_.shutdown();
+    rpc_pool_.join();
+    base::stop();
+}
+
+bool HttpServ::spawn_to_mongoose(const std::function<void(uint64_t)>&& handler)
 {
     auto msg = std::make_shared<MgEvent>(std::move(handler));
     struct mg_event ev { msg->hook() };
-    if (!notify(ev))
-        msg->unhook();
+    if (notify(ev))
+        return true;
+
+    msg->unhook();
+    return false;
 }
 
 void HttpServ::run() {
@@ -182,7 +568,11 @@ void HttpServ::run() {
 
     node_.subscribe_stop([this](const libbitcoin::code & ec) { stop(); });
 
-    base::run();
+    while (!stopped())
+    {
+        mg_mgr_poll(&mg_mgr(), 1000);
+        rpc_flush();
+    }
 
     log::info(LOG_HTTP) << "Http Service Stopped.";
 }
@@ -235,6 +625,11 @@ void HttpServ::on_ws_frame_handler(struct mg_connection& nc, websocket_message&
     ws_request(nc, WebsocketMessage(&msg));
 }
 
+void HttpServ::on_close_handler(struct mg_connection& nc)
+{
+    rpc_connections_.erase(&nc);
+}
+
 void HttpServ::check_rpc_client_addresses(struct mg_connection& nc)
 {
     const auto& allowed_clients = node_.server_settings().rpc_client_addresses;
@@ -22,30 +22,14 @@
 
 namespace mgbubble {
 
-void HttpMessage::data_to_arg(uint8_t rpc_version) {
-
-    auto vargv_to_argv = [this]() {
-        // convert to char** argv
-        int i = 0;
-        for(auto& iter : this->vargv_){
-            if (i >= max_paramters){
-                break;
-            }
-            this->argv_[i++] = iter.c_str();
-        }
-        argc_ = i;
-    };
-
-    Json::Reader reader;
-    Json::Value root;
-    const char* begin = body().data();
-    const char* end = body().data() + body().size();
-    if (!reader.parse(begin, end, root) || !root.isObject()) {
-        throw libbitcoin::explorer::jsonrpc_parse_error();
-    }
+namespace {
 
+// Convert one json-rpc call object into command line arguments.
+void call_to_arg(const Json::Value& root, uint8_t rpc_version,
+    std::vector<std::string>& args, Json::Value& params, int64_t& id)
+{
     if (root["method"].isString()) {
-        vargv_.emplace_back(root["method"].asString());
+        args.emplace_back(root["method"].asString());
     }
 
     if (root.isMember("params") && !root["params"].isArray()) {
@@ -57,9 +41,12 @@ void HttpMessage::data_to_arg(uint8_t rpc_version) {
          * application/json
          * {"method":"xxx", "params":["p1","p2"]}
          * ******************************************/
+        params = Json::arrayValue;
         for (auto& param : root["params"]) {
-            if (!param.isObject())
-                vargv_.emplace_back(param.asString());
+            if (!param.isObject()) {
+                args.emplace_back(param.asString());
+                params.append(param);
+            }
         }
     } else {
         /* ***************** /rpc/v2 or /rpc/v3 **********************
@@ -87,11 +74,13 @@ void HttpMessage::data_to_arg(uint8_t rpc_version) {
         }
 
         if (root["id"].isString()) {
-            jsonrpc_id_ = std::stol(root["id"].asString());
+            id = std::stol(root["id"].asString());
         } else {
-            jsonrpc_id_ = root["id"].asInt64();
+            id = root["id"].asInt64();
         }
 
+        params = root["params"];
+
         // push options
         for (auto& param : root["params"]) {
             if (param.isObject()) {
@@ -100,21 +89,21 @@ void HttpMessage::data_to_arg(uint8_t rpc_version) {
 
                         if (!param[key].isArray()) {
                             // --option
-                            vargv_.emplace_back("--" + key);
+                            args.emplace_back("--" + key);
                             // value
-                            vargv_.emplace_back(param[key].asString());
+                            args.emplace_back(param[key].asString());
                         } else  {
                             for (auto& member : param[key]) {
                                 // --option
-                                vargv_.emplace_back("--" + key);
+                                args.emplace_back("--" + key);
                                 // value
-                                vargv_.emplace_back(member.asString());
+                                args.emplace_back(member.asString());
                             }
                         }
 
                     } else {
                         // --option
-                        vargv_.emplace_back("--" + key);
+                        args.emplace_back("--" + key);
                     }
                 }
                 break;
@@ -124,11 +113,76 @@ void HttpMessage::data_to_arg(uint8_t rpc_version) {
         // push arguments at last
         for (auto& param : root["params"]) {
             if (!param.isObject()){
-                vargv_.emplace_back(param.asString());
+                args.emplace_back(param.asString());
             }
         }
     }
+}
+
+} // namespace
+
+void HttpMessage::data_to_arg(uint8_t rpc_version) {
+
+    auto vargv_to_argv = [this]() {
+        // convert to char** argv
+        int i = 0;
+        for(auto& iter : this->vargv_){
+            if (i >= max_paramters){
+                break;
+            }
+            this->argv_[i++] = iter.c_str();
+        }
+        argc_ = i;
+    };
+
+    Json::Reader reader;
+    Json::Value root;
+    const char* begin = body().data();
+    const char* end = body().data() + body().size();
+    if (!reader.parse(begin, end, root)) {
+        throw libbitcoin::explorer::jsonrpc_parse_error();
+    }
+
+    if (root.isArray() && rpc_version != 1) {
+        /* ***************** /rpc/v2 or /rpc/v3 batch **********************
+         * [ {"jsonrpc":"2.0", "method":"xxx", "params":[], "id":1}, ... ]
+         * A malformed entry is answered with its own error, the rest
+         * of the batch still runs.
+         * ******************************************/
+        if (root.empty() || root.size() > max_batch_calls) {
+            throw libbitcoin::explorer::jsonrpc_invalid_request();
+        }
+
+        batch_.reserve(root.size());
+        for (auto& item : root) {
+            JsonRpcCall call;
+            try {
+                if (!item.isObject()) {
+                    throw libbitcoin::explorer::jsonrpc_invalid_request();
+                }
+                call_to_arg(item, rpc_version, call.args, call.params, call.id);
+                if (!item["method"].isString()) {
+                    throw libbitcoin::explorer::jsonrpc_invalid_request();
+                }
+            }
+            catch (const libbitcoin::explorer::explorer_exception& e) {
+                call.error_code = e.code();
+                call.error_message = e.what();
+            }
+            catch (const std::exception& e) {
+                call.error_code = libbitcoin::explorer::jsonrpc_invalid_request().code();
+                call.error_message = e.what();
+            }
+            batch_.push_back(std::move(call));
+        }
+        return;
+    }
+
+    if (!root.isObject()) {
+        throw libbitcoin::explorer::jsonrpc_parse_error();
+    }
 
+    call_to_arg(root, rpc_version, vargv_, jsonrpc_params_, jsonrpc_id_);
     vargv_to_argv();
 }
 
@@ -19,6 +19,7 @@
 #include <sstream>
 #include <metaverse/explorer/json_helper.hpp>
 #include <metaverse/mgbubble/WsPushServ.hpp>
+#include <metaverse/mgbubble/utility/JsonWriter.hpp>
 #include <metaverse/server/server_node.hpp>
 
 namespace mgbubble {
@@ -40,6 +41,9 @@ constexpr auto CH_TRANSACTION = "tx";
 constexpr auto CH_ALL         = "all";
 
 constexpr int  JSON_FORMAT_VERSION = 3;
+
+// Pending output beyond which a slow client misses notifications.
+constexpr size_t max_pending_send_bytes = 4 * 1024 * 1024;
 }
 
 namespace mgbubble {
@@ -208,7 +212,16 @@ void WsPushServ::do_notify(
     Json::Value& root,
     std::shared_ptr<connection_string_map> topic_map)
 {
-    auto orignal_rep = root.toStyledString();
+    typedef std::shared_ptr<const std::string> payload_ptr;
+    typedef std::pair<std::shared_ptr<mg_connection>, payload_ptr> target;
+
+    // Serialize each distinct payload once, connections share the buffer.
+    const auto orignal_rep = std::make_shared<const std::string>(
+        toJson(root, node_.server_settings().pretty_json));
+    std::map<string_vector, payload_ptr> topic_reps;
+
+    auto targets = std::make_shared<std::vector<target>>();
+    targets->reserve(notify_cons.size());
 
     for (auto& con : notify_cons)
     {
@@ -217,54 +230,63 @@ void WsPushServ::do_notify(
             continue;
         }
 
-        std::string rep;
+        payload_ptr rep = orignal_rep;
         if (topic_map != nullptr) {
             auto iter = topic_map->find(con);
             if (iter != topic_map->end()) {
                 auto& topics = iter->second;
-                if (topics.end() != std::find(topics.begin(), topics.end(), CH_ALL)) {
-                    root["topic"] = CH_ALL;
-                }
-                else if (topics.size() == 1) {
-                    root["topic"] = topics[0];
-                }
-                else {
-                    Json::Value value;
-                    for (auto& topic : topics) {
-                        value.append(topic);
+                auto& cached = topic_reps[topics];
+                if (!cached) {
+                    if (topics.end() != std::find(topics.begin(), topics.end(), CH_ALL)) {
+                        root["topic"] = CH_ALL;
+                    }
+                    else if (topics.size() == 1) {
+                        root["topic"] = topics[0];
                     }
-                    if (value.isNull())
-                        value.resize(0);
+                    else {
+                        Json::Value value;
+                        for (auto& topic : topics) {
+                            value.append(topic);
+                        }
+                        if (value.isNull())
+                            value.resize(0);
 
-                    root["topic"] = value;
+                        root["topic"] = value;
+                    }
+
+                    cached = std::make_shared<const std::string>(
+                        toJson(root, node_.server_settings().pretty_json));
                 }
 
-                rep = root.toStyledString();
+                rep = cached;
             }
         }
 
-        if (rep.empty()) {
-            rep = orignal_rep;
-        }
+        targets->emplace_back(shared_con, rep);
+    }
 
-        spawn_to_mongoose([this, shared_con, rep](uint64_t id) {
-            size_t active_connections = 0;
-            auto* mgr = &this->mg_mgr();
-            auto* notify_nc = shared_con.get();
-            for (auto* nc = mg_next(mgr, NULL); nc != NULL; nc = mg_next(mgr, nc)) {
-                if (!is_websocket(*nc) || is_listen_socket(*nc) || is_notify_socket(*nc))
-                    continue;
-                ++active_connections;
-                if (notify_nc == nc) {
-                    send_frame(*nc, rep);
-                }
+    if (targets->empty()) {
+        return;
+    }
+
+    // One event loop task per notification, each target is found by id.
+    spawn_to_mongoose([this, targets](uint64_t id) {
+        for (auto& item : *targets) {
+            auto* nc = item.first.get();
+            if (map_connections_.find(nc) == map_connections_.end()) {
+                continue;
             }
 
-            if (active_connections != map_connections_.size()) {
-                refresh_connections();
+            // Drop frames for clients that are not draining their socket.
+            if (nc->send_mbuf.len > max_pending_send_bytes) {
+                log::debug(NAME) << "websocket client is not keeping up, "
+                    << nc->send_mbuf.len << " bytes pending, frame dropped.";
+                continue;
             }
-        });
-    }
+
+            send_frame(*nc, *item.second);
+        }
+    });
 }
 
 void WsPushServ::notify_transaction(uint32_t height, const hash_digest& block_hash, const transaction& tx)
@@ -273,68 +295,77 @@ void WsPushServ::notify_transaction(uint32_t height, const hash_digest& block_ha
         return;
     }
 
-    connection_string_map subscribers;
-    {
-        std::lock_guard<std::mutex> guard(subscribers_lock_);
-        if (subscribers_.size() == 0) {
-            return;
-        }
-
-        for (auto& con : subscribers_) {
-            if (!con.first.expired()) {
-                subscribers.insert(con);
-            }
-        }
-
-        if (subscribers.size() != subscribers_.size()) {
-            subscribers_ = subscribers;
-        }
+    if (address_index_.size() == 0) {
+        return;
     }
 
     /* ---------- may has subscribers ---------- */
 
+    static constexpr size_t address_bits = short_hash_size * byte_bits;
+
     string_vector tx_addrs;
+    std::vector<binary> tx_fields;
+    const auto add_address = [&](const wallet::payment_address& address) {
+        auto addr_hash = address.encoded();
+        if (tx_addrs.end() == std::find(tx_addrs.begin(), tx_addrs.end(), addr_hash)) {
+            tx_addrs.push_back(addr_hash);
+            tx_fields.emplace_back(address_bits, address.hash());
+        }
+    };
+
     for (const auto& input : tx.inputs) {
         const auto address = wallet::payment_address::extract(input.script);
         if (address) {
-            auto addr_hash = address.encoded();
-            if (tx_addrs.end() == std::find(tx_addrs.begin(), tx_addrs.end(), addr_hash)) {
-                tx_addrs.push_back(addr_hash);
-            }
+            add_address(address);
         }
     }
 
     for (const auto& output : tx.outputs) {
         const auto address = wallet::payment_address::extract(output.script);
         if (address) {
-            auto addr_hash = address.encoded();
-            if (tx_addrs.end() == std::find(tx_addrs.begin(), tx_addrs.end(), addr_hash)) {
-                tx_addrs.push_back(addr_hash);
-            }
+            add_address(address);
         }
     }
 
+    // Only the subscribers of the tx addresses (or of all) are visited.
     std::shared_ptr<connection_string_map> topic_map = std::make_shared<connection_string_map>();
+    for (size_t i = 0; i < tx_addrs.size(); ++i)
+    {
+        const auto& addr_hash = tx_addrs[i];
+        address_index_.find(tx_fields[i],
+            [&topic_map, &addr_hash](const binary& prefix, const connection_ptr& con) {
+                auto& topics = (*topic_map)[con];
+                if (prefix.size() != 0) {
+                    topics.push_back(addr_hash);
+                }
+                else if (topics.empty()) {
+                    topics.push_back(CH_ALL);
+                }
+            });
+    }
 
     std::vector<std::weak_ptr<mg_connection>> notify_cons;
-    for (auto& sub : subscribers)
+    std::vector<connection_ptr> expired_cons;
+    for (auto& sub : *topic_map)
     {
-        string_vector topics;
-        auto& sub_addrs = sub.second;
-        if (sub_addrs.empty()) {
-            topics.push_back(CH_ALL);
+        if (sub.first.expired()) {
+            expired_cons.push_back(sub.first);
         }
         else {
-            for (auto& addr_hash : sub_addrs) {
-                if (tx_addrs.end() != std::find(tx_addrs.begin(), tx_addrs.end(), addr_hash)) {
-                    topics.push_back(addr_hash);
-                }
-            }
+            notify_cons.push_back(sub.first);
         }
+    }
 
-        if (!topics.empty()) {
-            topic_map->insert({sub.first, topics});
-            notify_cons.push_back(sub.first);
+    // Closed connections are dropped as they are found.
+    if (!expired_cons.empty()) {
+        std::lock_guard<std::mutex> guard(subscribers_lock_);
+        for (auto& con : expired_cons) {
+            topic_map->erase(con);
+            auto sub_it = subscribers_.find(con);
+            if (sub_it != subscribers_.end()) {
+                index_subscription(con, sub_it->second, false);
+                subscribers_.erase(sub_it);
+            }
         }
     }
 
@@ -363,7 +394,7 @@ void WsPushServ::send_bad_response(struct mg_connection& nc, const char* message
     root["event"]  = EV_MG_ERROR;
     root["result"] = result;
 
-    auto&& tmp = root.toStyledString();
+    const auto tmp = toJson(root, node_.server_settings().pretty_json);
     send_frame(nc, tmp.c_str(), tmp.size());
 }
 
@@ -379,23 +410,10 @@ void WsPushServ::send_response(struct mg_connection& nc, const std::string& even
         root["result"] = data;
     }
 
-    auto&& tmp = root.toStyledString();
+    const auto tmp = toJson(root, node_.server_settings().pretty_json);
     send_frame(nc, tmp.c_str(), tmp.size());
 }
 
-void WsPushServ::refresh_connections()
-{
-    auto* mgr = &mg_mgr();
-    std::unordered_map<void*, std::shared_ptr<mg_connection>> swap;
-    for (auto* nc = mg_next(mgr, NULL); nc != NULL; nc = mg_next(mgr, nc)) {
-        if (!is_websocket(*nc) || is_listen_socket(*nc) || is_notify_socket(*nc))
-            continue;
-        std::shared_ptr<struct mg_connection> con(nc, [](struct mg_connection * ptr) { (void)(ptr); });
-        swap.emplace(&nc, con);
-    }
-    map_connections_.swap(swap);
-}
-
 void WsPushServ::on_ws_handshake_done_handler(struct mg_connection& nc)
 {
     std::shared_ptr<struct mg_connection> con(&nc, [](struct mg_connection * ptr) { (void)(ptr); });
@@ -411,7 +429,7 @@ void WsPushServ::on_ws_handshake_done_handler(struct mg_connection& nc)
     root["event"] = EV_INFO;
     root["result"] = connections;
 
-    auto&& tmp = root.toStyledString();
+    const auto tmp = toJson(root, node_.server_settings().pretty_json);
     send_frame(nc, tmp);
 }
 
@@ -511,9 +529,11 @@ void WsPushServ::on_ws_frame_handler(struct mg_connection& nc, websocket_message
                 auto sub_it = subscribers_.find(week_con);
                 if (sub_it != subscribers_.end()) {
                     auto& sub_list = sub_it->second;
+                    index_subscription(week_con, sub_list, false);
 
                     if (addresses.empty()) {
                         sub_list.clear();
+                        index_subscription(week_con, sub_list, true);
                         send_response(nc, EV_SUBSCRIBED, channel);
                         return;
                     }
@@ -524,6 +544,7 @@ void WsPushServ::on_ws_frame_handler(struct mg_connection& nc, websocket_message
                         }
                     }
 
+                    index_subscription(week_con, sub_list, true);
                     send_response(nc, EV_SUBSCRIBED, channel);
                 }
                 else {
@@ -535,6 +556,7 @@ void WsPushServ::on_ws_frame_handler(struct mg_connection& nc, websocket_message
                     }
 
                     subscribers_.insert({ week_con, sub_list });
+                    index_subscription(week_con, sub_list, true);
                     send_response(nc, EV_SUBSCRIBED, channel);
                 }
             }
@@ -547,7 +569,11 @@ void WsPushServ::on_ws_frame_handler(struct mg_connection& nc, websocket_message
             if (it != map_connections_.end()) {
                 std::lock_guard<std::mutex> guard(subscribers_lock_);
                 std::weak_ptr<struct mg_connection> week_con(it->second);
-                subscribers_.erase(week_con);
+                auto sub_it = subscribers_.find(week_con);
+                if (sub_it != subscribers_.end()) {
+                    index_subscription(week_con, sub_it->second, false);
+                    subscribers_.erase(sub_it);
+                }
                 send_response(nc, EV_UNSUBSCRIBED, channel);
             }
             else {
@@ -598,7 +624,7 @@ void WsPushServ::on_ws_frame_handler(struct mg_connection& nc, websocket_message
                         }
 
                         if (params.empty()) {
-                            subscribers_.erase(week_con);
+                            block_subscribers_.erase(iter);
                         }
                     }
 
@@ -639,10 +665,48 @@ void WsPushServ::on_close_handler(struct mg_connection& nc)
 {
     if (is_websocket(nc))
     {
+        auto it = map_connections_.find(&nc);
+        if (it != map_connections_.end()) {
+            std::lock_guard<std::mutex> guard(subscribers_lock_);
+            std::weak_ptr<struct mg_connection> week_con(it->second);
+            auto sub_it = subscribers_.find(week_con);
+            if (sub_it != subscribers_.end()) {
+                index_subscription(week_con, sub_it->second, false);
+                subscribers_.erase(sub_it);
+            }
+        }
+
         map_connections_.erase(&nc);
     }
 }
 
+void WsPushServ::index_subscription(const connection_ptr& con,
+    const string_vector& addresses, bool add)
+{
+    static constexpr size_t address_bits = short_hash_size * byte_bits;
+
+    const auto update = [this, &con, add](const binary& prefix) {
+        if (add) {
+            address_index_.insert(prefix, con);
+        }
+        else {
+            address_index_.erase(prefix, con);
+        }
+    };
+
+    if (addresses.empty()) {
+        update(binary());
+        return;
+    }
+
+    for (const auto& address : addresses) {
+        const wallet::payment_address pay_addr(address);
+        if (pay_addr) {
+            update(binary(address_bits, pay_addr.hash()));
+        }
+    }
+}
+
 void WsPushServ::on_broadcast(struct mg_connection& nc, const char* ev_data)
 {
     if (is_listen_socket(nc) || is_notify_socket(nc))
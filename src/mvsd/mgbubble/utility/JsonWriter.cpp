@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2016-2021 metaverse core developers (see MVS-AUTHORS) - Metaverse.
+ *
+ * This program is free software; you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if
+ * not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+#include <metaverse/mgbubble/utility/JsonWriter.hpp>
+
+using namespace std;
+
+namespace mgbubble {
+
+namespace {
+
+class StringSink {
+ public:
+  explicit StringSink(string& out) noexcept : out_(out) {}
+  void put(char c) { out_.push_back(c); }
+  void write(const char* s, size_t n) { out_.append(s, n); }
+
+ private:
+  string& out_;
+};
+
+class StreamSink {
+ public:
+  explicit StreamSink(ostream& os) noexcept : os_(os) {}
+  void put(char c) { os_.put(c); }
+  void write(const char* s, size_t n) { os_.write(s, n); }
+
+ private:
+  ostream& os_;
+};
+
+template <typename SinkT>
+void writeString(SinkT& sink, const char* begin, const char* end)
+{
+  static const char hex[] = "0123456789abcdef";
+
+  sink.put('"');
+  auto run = begin;
+  for (auto it = begin; it != end; ++it) {
+    const auto c = static_cast<unsigned char>(*it);
+    if (c >= 0x20 && c != '"' && c != '\\') {
+      continue;
+    }
+
+    // Flush the unescaped run before the escape.
+    sink.write(run, it - run);
+    run = it + 1;
+
+    switch (c) {
+    case '"':
+      sink.write("\\\"", 2);
+      break;
+    case '\\':
+      sink.write("\\\\", 2);
+      break;
+    case '\b':
+      sink.write("\\b", 2);
+      break;
+    case '\f':
+      sink.write("\\f", 2);
+      break;
+    case '\n':
+      sink.write("\\n", 2);
+      break;
+    case '\r':
+      sink.write("\\r", 2);
+      break;
+    case '\t':
+      sink.write("\\t", 2);
+      break;
+    default:
+      const char escape[] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf]};
+      sink.write(escape, sizeof(escape));
+    }
+  }
+  sink.write(run, end - run);
+  sink.put('"');
+}
+
+template <typename SinkT>
+void writeValue(SinkT& sink, const Json::Value& value)
+{
+  switch (value.type()) {
+  case Json::nullValue:
+    sink.write("null", 4);
+    break;
+  case Json::intValue:
+  case Json::uintValue:
+  case Json::realValue: {
+    // Same number formatting as the jsoncpp writers.
+    const auto text = value.type() == Json::intValue ? Json::valueToString(value.asLargestInt())
+      : value.type() == Json::uintValue ? Json::valueToString(value.asLargestUInt())
+                                         : Json::valueToString(value.asDouble());
+    sink.write(text.data(), text.size());
+    break;
+  }
+  case Json::booleanValue:
+    if (value.asBool()) {
+      sink.write("true", 4);
+    } else {
+      sink.write("false", 5);
+    }
+    break;
+  case Json::stringValue: {
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    if (value.getString(&begin, &end)) {
+      writeString(sink, begin, end);
+    } else {
+      sink.write("\"\"", 2);
+    }
+    break;
+  }
+  case Json::arrayValue: {
+    sink.put('[');
+    const auto size = value.size();
+    for (Json::ArrayIndex i = 0; i < size; ++i) {
+      if (i != 0) {
+        sink.put(',');
+      }
+      writeValue(sink, value[i]);
+    }
+    sink.put(']');
+    break;
+  }
+  case Json::objectValue: {
+    sink.put('{');
+    auto first = true;
+    for (auto it = value.begin(); it != value.end(); ++it) {
+      if (!first) {
+        sink.put(',');
+      }
+      first = false;
+
+      const char* end = nullptr;
+      const char* begin = it.memberName(&end);
+      writeString(sink, begin, end);
+      sink.put(':');
+      writeValue(sink, *it);
+    }
+    sink.put('}');
+    break;
+  }
+  }
+}
+
+} // namespace
+
+MVS_API void writeJson(string& out, const Json::Value& value, bool pretty)
+{
+  if (pretty) {
+    out += value.toStyledString();
+    return;
+  }
+
+  StringSink sink{out};
+  writeValue(sink, value);
+}
+
+MVS_API void writeJson(ostream& os, const Json::Value& value, bool pretty)
+{
+  if (pretty) {
+    os << value.toStyledString();
+    return;
+  }
+
+  StreamSink sink{os};
+  writeValue(sink, value);
+}
+
+} // mgbubble
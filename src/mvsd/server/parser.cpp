@@ -159,7 +159,7 @@ options_metadata parser::load_settings()
     (
         "network.protocol",
         value<uint32_t>(&configured.network.protocol),
-        "The network protocol version, defaults to 70012."
+        "The network protocol version, defaults to 70014."
     )
     (
         "network.identifier",
@@ -308,12 +308,12 @@ options_metadata parser::load_settings()
     (
         "blockchain.block_pool_capacity",
         value<uint32_t>(&configured.chain.block_pool_capacity),
-        "The maximum number of orphan blocks in the pool, defaults to 50."
+        "The maximum number of orphan blocks in the pool, 0 for no limit, defaults to 5000."
     )
     (
         "blockchain.transaction_pool_capacity",
         value<uint32_t>(&configured.chain.transaction_pool_capacity),
-        "The maximum number of transactions in the pool, defaults to 2000."
+        "The maximum number of transactions in the pool, zero stores none, defaults to 4096."
     )
     (
         "blockchain.transaction_pool_consistency",
@@ -335,6 +335,11 @@ options_metadata parser::load_settings()
         value<bool>(&configured.chain.collect_split_stake),
         "Automatically collect or split utxos for pos stake, defaults to true."
     )
+    (
+        "blockchain.script_verification_threads",
+        value<uint32_t>(&configured.chain.script_verification_threads),
+        "The number of threads verifying block input scripts, zero for hardware concurrency, defaults to 0."
+    )
 
     /* [node] */
     (
@@ -484,6 +489,21 @@ options_metadata parser::load_settings()
         value<config::authority::list>(&configured.server.client_addresses),
         "Allowed client IP address, multiple entries allowed."
     )
+    (
+        "server.rpc_threads",
+        value<uint16_t>(&configured.server.rpc_threads),
+        "The number of threads running rpc commands, defaults to 4."
+    )
+    (
+        "server.rpc_method_concurrency",
+        value<uint16_t>(&configured.server.rpc_method_concurrency),
+        "The maximum number of concurrent calls per rpc method, defaults to 0 (unlimited)."
+    )
+    (
+        "server.pretty_json",
+        value<bool>(&configured.server.pretty_json),
+        "Indent rpc and websocket json responses, defaults to false."
+    )
     (
         "server.rpc_client_addresses",
         value<std::vector<std::string>>(&configured.server.rpc_client_addresses),
@@ -36,6 +36,9 @@ settings::settings()
     administrator_required(false),
     log_level("DEBUG"),
     rpc_version(""),
+    rpc_threads(4),
+    rpc_method_concurrency(0),
+    pretty_json(false),
     secure_only(false),
     query_service_enabled(true),
     heartbeat_service_enabled(false),
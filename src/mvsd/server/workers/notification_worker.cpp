@@ -318,6 +318,7 @@ bool notification_worker::handle_payment(const code& ec,
 {
     if (ec)
     {
+        payment_index_.erase(prefix_filter, { reply_to, prefix_filter });
         send(reply_to, address_update, id, message::to_bytes(ec));
         return false;
     }
@@ -335,6 +336,7 @@ bool notification_worker::handle_stealth(const code& ec,
 {
     if (ec)
     {
+        stealth_index_.erase(prefix_filter, { reply_to, prefix_filter });
         send(reply_to, address_stealth, id, message::to_bytes(ec));
         return false;
     }
@@ -352,6 +354,7 @@ bool notification_worker::handle_address(const code& ec,
 {
     if (ec)
     {
+        address_index_.erase(prefix_filter, { reply_to, prefix_filter });
         send(reply_to, address_update2, id, message::to_bytes(ec));
         return false;
     }
@@ -370,6 +373,8 @@ bool notification_worker::handle_address(const code& ec,
 
 // Subscribe to address and stealth prefix notifications.
 // Each delegate must connect to the appropriate query notification endpoint.
+// The key is indexed before subscribing, as a rejected subscription invokes
+// its handler, which removes the key from the index.
 void notification_worker::subscribe_address(const route& reply_to, uint32_t id,
     const binary& prefix_filter, subscribe_type type)
 {
@@ -387,6 +392,7 @@ void notification_worker::subscribe_address(const route& reply_to, uint32_t id,
                 std::bind(&notification_worker::handle_payment,
                     this, _1, _2, _3, _4, _5, reply_to, id, prefix_filter);
 
+            payment_index_.insert(prefix_filter, key);
             payment_subscriber_->subscribe(handler, key, duration, error_code,
                 {}, 0, {}, {});
             break;
@@ -400,6 +406,7 @@ void notification_worker::subscribe_address(const route& reply_to, uint32_t id,
                 std::bind(&notification_worker::handle_stealth,
                     this, _1, _2, _3, _4, _5, reply_to, id, prefix_filter);
 
+            stealth_index_.insert(prefix_filter, key);
             stealth_subscriber_->subscribe(handler, key, duration, error_code,
                 0, 0, {}, {});
             break;
@@ -418,6 +425,7 @@ void notification_worker::subscribe_address(const route& reply_to, uint32_t id,
                     sequence);
 
             // v3
+            address_index_.insert(prefix_filter, key);
             address_subscriber_->subscribe(handler, key, duration, error_code,
                 {}, 0, {}, {});
             break;
@@ -602,7 +610,7 @@ void notification_worker::notify_transaction(uint32_t height,
     if (stopped() || tx.outputs.empty())
         return;
 
-    // see data_base::push_inputs
+    // see data_base::push_history
     // Loop inputs and extract payment addresses.
     for (const auto& input: tx.inputs)
     {
@@ -616,7 +624,7 @@ void notification_worker::notify_transaction(uint32_t height,
         }
     }
 
-    // see data_base::push_outputs
+    // see data_base::push_history
     // Loop outputs and extract payment addresses.
     for (const auto& output: tx.outputs)
     {
@@ -649,12 +657,32 @@ void notification_worker::notify_transaction(uint32_t height,
     }
 }
 
+std::vector<address_key> notification_worker::to_keys(
+    const subscription_index& index, const binary& field)
+{
+    std::vector<address_key> keys;
+    const auto collect = [&keys](const binary&, const address_key& key)
+    {
+        keys.push_back(key);
+    };
+
+    index.find(field, collect);
+    return keys;
+}
+
 // v2/v3 (deprecated)
 void notification_worker::notify_payment(const payment_address& address,
     uint32_t height, const hash_digest& block_hash, const transaction& tx)
 {
     static const auto code = error::success;
-    payment_subscriber_->relay(code, address, height, block_hash, tx);
+    static constexpr size_t address_bits = short_hash_size * byte_bits;
+
+    const binary field(address_bits, address.hash());
+    const auto keys = to_keys(payment_index_, field);
+
+    if (!keys.empty())
+        payment_subscriber_->relay_to(keys, code, address, height,
+            block_hash, tx);
 }
 
 // v2/v3 (deprecated)
@@ -662,7 +690,14 @@ void notification_worker::notify_stealth(uint32_t prefix, uint32_t height,
     const hash_digest& block_hash, const transaction& tx)
 {
     static const auto code = error::success;
-    stealth_subscriber_->relay(code, prefix, height, block_hash, tx);
+    static constexpr size_t prefix_bits = sizeof(prefix) * byte_bits;
+
+    const binary field(prefix_bits, to_little_endian(prefix));
+    const auto keys = to_keys(stealth_index_, field);
+
+    if (!keys.empty())
+        stealth_subscriber_->relay_to(keys, code, prefix, height,
+            block_hash, tx);
 }
 
 // v3
@@ -670,7 +705,11 @@ void notification_worker::notify_address(const binary& field, uint32_t height,
     const hash_digest& block_hash, const transaction& tx)
 {
     static const auto code = error::success;
-    address_subscriber_->relay(code, field, height, block_hash, tx);
+    const auto keys = to_keys(address_index_, field);
+
+    if (!keys.empty())
+        address_subscriber_->relay_to(keys, code, field, height, block_hash,
+            tx);
 }
 
 // v3.x
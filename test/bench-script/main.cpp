@@ -0,0 +1,316 @@
+/**
+ * Copyright (c) 2011-2021 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2021 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <metaverse/bitcoin/constants.hpp>
+#include <metaverse/bitcoin/chain/script/script.hpp>
+#include <metaverse/bitcoin/chain/script/operation.hpp>
+#include <metaverse/bitcoin/chain/transaction.hpp>
+#include <metaverse/bitcoin/math/elliptic_curve.hpp>
+#include <metaverse/bitcoin/math/hash.hpp>
+#include <metaverse/bitcoin/math/script_number.hpp>
+#include <metaverse/bitcoin/utility/data.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+
+// Times the native interpreter over the standard spend patterns. The
+// unsigned patterns leave the checksig operations out, so what is measured
+// is evaluation context and stack item handling. The signed patterns run
+// checksig and checkmultisig over real endorsements, once against an empty
+// signature cache (as on pool acceptance) and once more answered from it
+// (as on block connection).
+
+static const size_t default_iterations = 200000;
+static const uint32_t signed_transactions = 1000;
+static const uint32_t lock_height = 1000;
+static const uint32_t flags = script_context::bip16_enabled
+    | script_context::bip65_enabled | script_context::bip66_enabled;
+
+// Sizes of a DER endorsement and a compressed public key.
+static const data_chunk endorsement_item(72, 0x30);
+static const data_chunk public_key_item(33, 0x02);
+
+// Each previous output index gives the spend its own signature hash.
+static transaction spending_transaction(uint32_t previous_index=0)
+{
+    transaction tx;
+    tx.version = 1;
+    tx.locktime = 0;
+
+    input in;
+    in.previous_output.hash = sha256_hash(to_chunk(std::string("prevout")));
+    in.previous_output.index = previous_index;
+    in.sequence = max_input_sequence;
+    tx.inputs.push_back(in);
+
+    output out;
+    out.value = 100000;
+    out.script.operations = operation::to_pay_key_hash_pattern(
+        bitcoin_short_hash(public_key_item));
+    tx.outputs.push_back(out);
+    return tx;
+}
+
+// [endorsement] [public key] : dup hash160 [hash] equalverify 2drop 1
+static void pay_key_hash(script& input_script, script& prevout_script)
+{
+    input_script.operations =
+    {
+        { opcode::special, endorsement_item },
+        { opcode::special, public_key_item }
+    };
+
+    prevout_script.operations =
+    {
+        { opcode::dup, {} },
+        { opcode::hash160, {} },
+        { opcode::special, to_chunk(bitcoin_short_hash(public_key_item)) },
+        { opcode::equalverify, {} },
+        { opcode::op_2drop, {} },
+        { opcode::op_1, {} }
+    };
+}
+
+// [endorsement] [public key] [height] :
+// [height] numequalverify dup hash160 [hash] equalverify 2drop 1
+static void pay_key_hash_with_lock_height(script& input_script,
+    script& prevout_script)
+{
+    pay_key_hash(input_script, prevout_script);
+
+    const auto height = script_number(lock_height).data();
+    input_script.operations.push_back({ opcode::special, height });
+
+    auto& ops = prevout_script.operations;
+    ops.insert(ops.begin(), { opcode::numequalverify, {} });
+    ops.insert(ops.begin(), { opcode::special, height });
+}
+
+// zero [endorsement] [endorsement] [redeem] : hash160 [hash] equal
+// redeem: 2 [key] [key] [key] 3 2drop 2drop 2drop 2drop 1
+static void pay_script_hash_multisig(script& input_script,
+    script& prevout_script)
+{
+    script redeem;
+    redeem.operations =
+    {
+        { opcode::op_2, {} },
+        { opcode::special, public_key_item },
+        { opcode::special, public_key_item },
+        { opcode::special, public_key_item },
+        { opcode::op_3, {} },
+        { opcode::op_2drop, {} },
+        { opcode::op_2drop, {} },
+        { opcode::op_2drop, {} },
+        { opcode::op_2drop, {} },
+        { opcode::op_1, {} }
+    };
+
+    const auto redeem_data = redeem.to_data(false);
+    input_script.operations =
+    {
+        { opcode::zero, {} },
+        { opcode::special, endorsement_item },
+        { opcode::special, endorsement_item },
+        operation::from_raw_data(redeem_data)
+    };
+
+    prevout_script.operations = operation::to_pay_script_hash_pattern(
+        bitcoin_short_hash(redeem_data));
+}
+
+static ec_secret make_secret(const std::string& seed)
+{
+    return sha256_hash(to_chunk(seed));
+}
+
+// [endorsement] [public key] : dup hash160 [hash] equalverify checksig
+static bool sign_key_hash(const transaction& tx, script& input_script,
+    script& prevout_script)
+{
+    const auto secret = make_secret("key");
+    ec_compressed point;
+    if (!secret_to_public(point, secret))
+        return false;
+
+    prevout_script.operations = operation::to_pay_key_hash_pattern(
+        bitcoin_short_hash(point));
+
+    endorsement signature;
+    if (!script::create_endorsement(signature, secret, prevout_script, tx, 0,
+        signature_hash_algorithm::all))
+        return false;
+
+    input_script.operations =
+    {
+        { opcode::special, signature },
+        { opcode::special, to_chunk(point) }
+    };
+    return true;
+}
+
+// zero [endorsement] [endorsement] [redeem] : hash160 [hash] equal
+// redeem: 2 [key] [key] [key] 3 checkmultisig
+static bool sign_script_hash_multisig(const transaction& tx,
+    script& input_script, script& prevout_script)
+{
+    std::vector<ec_secret> secrets;
+    point_list points;
+    for (size_t key = 0; key < 3; ++key)
+    {
+        secrets.push_back(make_secret("multisig" + std::to_string(key)));
+        ec_compressed point;
+        if (!secret_to_public(point, secrets.back()))
+            return false;
+
+        points.push_back(point);
+    }
+
+    script redeem;
+    redeem.operations = operation::to_pay_multisig_pattern(2, points);
+
+    input_script.operations = { { opcode::zero, {} } };
+    for (size_t key = 0; key < 2; ++key)
+    {
+        endorsement signature;
+        if (!script::create_endorsement(signature, secrets[key], redeem, tx,
+            0, signature_hash_algorithm::all))
+            return false;
+
+        input_script.operations.push_back({ opcode::special, signature });
+    }
+
+    const auto redeem_data = redeem.to_data(false);
+    input_script.operations.push_back(operation::from_raw_data(redeem_data));
+    prevout_script.operations = operation::to_pay_script_hash_pattern(
+        bitcoin_short_hash(redeem_data));
+    return true;
+}
+
+typedef std::function<bool(const transaction&, script&, script&)> signer;
+
+static size_t nanoseconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+static bool run_signed(const std::string& name, signer sign)
+{
+    std::vector<transaction> transactions;
+    std::vector<script> input_scripts(signed_transactions);
+    std::vector<script> prevout_scripts(signed_transactions);
+
+    for (uint32_t index = 0; index < signed_transactions; ++index)
+    {
+        transactions.push_back(spending_transaction(index));
+        if (!sign(transactions.back(), input_scripts[index],
+            prevout_scripts[index]))
+        {
+            std::cerr << name << ": cannot sign" << std::endl;
+            return false;
+        }
+    }
+
+    // Verification is not checked ahead, that would fill the cache.
+    auto valid = true;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t index = 0; index < signed_transactions; ++index)
+        valid &= script::verify(input_scripts[index], prevout_scripts[index],
+            transactions[index], 0, flags);
+
+    const auto uncached = nanoseconds_since(start);
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t index = 0; index < signed_transactions; ++index)
+        valid &= script::verify(input_scripts[index], prevout_scripts[index],
+            transactions[index], 0, flags);
+
+    const auto cached = nanoseconds_since(start);
+
+    if (!valid)
+    {
+        std::cerr << name << ": does not verify" << std::endl;
+        return false;
+    }
+
+    std::cout << name << ": " << uncached / signed_transactions
+        << " ns per verify, " << cached / signed_transactions
+        << " ns per cached verify" << std::endl;
+    return true;
+}
+
+static bool run(const std::string& name, const script& input_script,
+    const script& prevout_script, size_t iterations)
+{
+    const auto tx = spending_transaction();
+    if (!script::verify(input_script, prevout_script, tx, 0, flags))
+    {
+        std::cerr << name << ": does not verify" << std::endl;
+        return false;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+        script::verify(input_script, prevout_script, tx, 0, flags);
+
+    std::cout << name << ": " << nanoseconds_since(start) / iterations
+        << " ns per verify" << std::endl;
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    const size_t iterations = argc > 1 ?
+        std::strtoull(argv[1], nullptr, 10) : default_iterations;
+
+    if (iterations == 0)
+    {
+        std::cerr << "usage: script-bench [iterations]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    script input_script;
+    script prevout_script;
+    auto success = true;
+
+    pay_key_hash(input_script, prevout_script);
+    success &= run("pay_key_hash", input_script, prevout_script, iterations);
+
+    pay_key_hash_with_lock_height(input_script, prevout_script);
+    success &= run("pay_key_hash_with_lock_height", input_script,
+        prevout_script, iterations);
+
+    pay_script_hash_multisig(input_script, prevout_script);
+    success &= run("pay_script_hash_multisig", input_script, prevout_script,
+        iterations);
+
+    success &= run_signed("signed_pay_key_hash", sign_key_hash);
+    success &= run_signed("signed_pay_script_hash_multisig",
+        sign_script_hash_multisig);
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
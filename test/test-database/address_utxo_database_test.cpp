@@ -0,0 +1,172 @@
+#ifdef  DATABASE_TESTS
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/databases/address_utxo_database.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::chain;
+using namespace libbitcoin::database;
+
+static const boost::filesystem::path directory("address_utxo_test");
+
+static void touch(const boost::filesystem::path& file_path)
+{
+    bc::ofstream file(file_path.string());
+    file.write("X", 1);
+}
+
+static address_utxo make_utxo(uint32_t index, uint64_t value)
+{
+    return { output_point{ null_hash, index }, 10, value, 0,
+        utxo_lock_kind::none, 0, 0 };
+}
+
+BOOST_AUTO_TEST_SUITE(address_utxo_database_tests)
+
+BOOST_AUTO_TEST_CASE(address_utxo_database__restore__spent_output__received_unchanged)
+{
+    boost::filesystem::remove_all(directory);
+    boost::filesystem::create_directories(directory);
+    touch(directory / "lookup");
+    touch(directory / "lookup_buckets");
+    touch(directory / "rows");
+    touch(directory / "rows_buckets");
+
+    address_utxo_database instance(directory / "lookup",
+        directory / "lookup_buckets", directory / "rows",
+        directory / "rows_buckets");
+    BOOST_REQUIRE(instance.create());
+
+    const short_hash key{ { 0x42 } };
+    const auto first = make_utxo(0, 1000);
+    const auto second = make_utxo(1, 234);
+    instance.store(key, first);
+    instance.store(key, second);
+    BOOST_REQUIRE_EQUAL(instance.received(key), 1234u);
+
+    // A block spends the first output and is then popped.
+    BOOST_REQUIRE(instance.spend(first.output));
+    BOOST_REQUIRE_EQUAL(instance.get(key).size(), 1u);
+    instance.restore(key, first);
+
+    BOOST_REQUIRE_EQUAL(instance.get(key).size(), 2u);
+    BOOST_REQUIRE_EQUAL(instance.received(key), 1234u);
+
+    // Popping the creating block removes the output and its value.
+    instance.remove(first.output);
+    BOOST_REQUIRE_EQUAL(instance.get(key).size(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.received(key), 234u);
+
+    BOOST_REQUIRE(instance.close());
+    boost::filesystem::remove_all(directory);
+}
+
+BOOST_AUTO_TEST_CASE(address_utxo_database__remove__head_middle_tail__unlinked)
+{
+    boost::filesystem::remove_all(directory);
+    boost::filesystem::create_directories(directory);
+    touch(directory / "lookup");
+    touch(directory / "lookup_buckets");
+    touch(directory / "rows");
+    touch(directory / "rows_buckets");
+
+    address_utxo_database instance(directory / "lookup",
+        directory / "lookup_buckets", directory / "rows",
+        directory / "rows_buckets");
+    BOOST_REQUIRE(instance.create());
+
+    const short_hash key{ { 0x42 } };
+    const short_hash other{ { 0x43 } };
+    const auto first = make_utxo(0, 1);
+    const auto second = make_utxo(1, 20);
+    const auto third = make_utxo(2, 300);
+    const auto fourth = make_utxo(3, 4000);
+    instance.store(key, first);
+    instance.store(key, second);
+    instance.store(key, third);
+    instance.store(key, fourth);
+    instance.store(other, make_utxo(4, 50000));
+
+    // Popping blocks removes outputs from the middle and both ends.
+    instance.remove(second.output);
+    auto rows = instance.get(key);
+    BOOST_REQUIRE_EQUAL(rows.size(), 3u);
+    BOOST_REQUIRE_EQUAL(instance.received(key), 4301u);
+
+    instance.remove(fourth.output);
+    instance.remove(first.output);
+    rows = instance.get(key);
+    BOOST_REQUIRE_EQUAL(rows.size(), 1u);
+    BOOST_REQUIRE(rows.front().output == third.output);
+    BOOST_REQUIRE_EQUAL(instance.received(key), 300u);
+
+    // Removing an untracked output changes nothing.
+    instance.remove(second.output);
+    BOOST_REQUIRE_EQUAL(instance.get(key).size(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.received(key), 300u);
+
+    instance.remove(third.output);
+    BOOST_REQUIRE(instance.get(key).empty());
+    BOOST_REQUIRE_EQUAL(instance.received(key), 0u);
+
+    // Other addresses are not affected.
+    BOOST_REQUIRE_EQUAL(instance.get(other).size(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.received(other), 50000u);
+
+    // Freed rows are reused by later outputs.
+    instance.store(key, second);
+    BOOST_REQUIRE_EQUAL(instance.get(key).size(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.received(key), 20u);
+
+    BOOST_REQUIRE(instance.close());
+    boost::filesystem::remove_all(directory);
+}
+
+BOOST_AUTO_TEST_CASE(address_utxo_database__spend__rollback__unspent_again)
+{
+    boost::filesystem::remove_all(directory);
+    boost::filesystem::create_directories(directory);
+    touch(directory / "lookup");
+    touch(directory / "lookup_buckets");
+    touch(directory / "rows");
+    touch(directory / "rows_buckets");
+
+    address_utxo_database instance(directory / "lookup",
+        directory / "lookup_buckets", directory / "rows",
+        directory / "rows_buckets");
+    BOOST_REQUIRE(instance.create());
+
+    const short_hash key{ { 0x42 } };
+    const auto first = make_utxo(0, 1000);
+    const auto second = make_utxo(1, 234);
+    instance.store(key, first);
+    instance.store(key, second);
+
+    // A block spends both outputs, a spend is tracked only once.
+    BOOST_REQUIRE(instance.spend(second.output));
+    BOOST_REQUIRE(instance.spend(first.output));
+    BOOST_REQUIRE(!instance.spend(first.output));
+    BOOST_REQUIRE(!instance.spend(make_utxo(2, 0).output));
+    BOOST_REQUIRE(instance.get(key).empty());
+    BOOST_REQUIRE_EQUAL(instance.received(key), 1234u);
+
+    // Popping the spending block makes both outputs unspent again.
+    instance.restore(key, first);
+    instance.restore(key, second);
+    const auto rows = instance.get(key);
+    BOOST_REQUIRE_EQUAL(rows.size(), 2u);
+    BOOST_REQUIRE_EQUAL(rows[0].value + rows[1].value, 1234u);
+    BOOST_REQUIRE_EQUAL(instance.received(key), 1234u);
+
+    // The restored outputs can be spent by the next block.
+    BOOST_REQUIRE(instance.spend(first.output));
+    BOOST_REQUIRE_EQUAL(instance.get(key).size(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.get(key).front().value, 234u);
+
+    BOOST_REQUIRE(instance.close());
+    boost::filesystem::remove_all(directory);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
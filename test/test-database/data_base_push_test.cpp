@@ -0,0 +1,145 @@
+#ifdef  DATABASE_TESTS
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/data_base.hpp>
+#include <metaverse/database/settings.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::chain;
+using namespace libbitcoin::database;
+
+static const boost::filesystem::path directory("data_base_push_test");
+
+// Sized as a DER endorsement, so the input resolves its address.
+static const data_chunk endorsement_item(72, 0x30);
+
+static data_chunk make_public_key(uint8_t seed)
+{
+    data_chunk point(33, seed);
+    point[0] = 0x02;
+    return point;
+}
+
+static output make_output(const data_chunk& public_key, uint64_t value)
+{
+    output out;
+    out.value = value;
+    out.script.operations = operation::to_pay_key_hash_pattern(
+        bitcoin_short_hash(public_key));
+    return out;
+}
+
+static transaction make_coinbase(uint32_t height,
+    const data_chunk& first_key, const data_chunk& second_key)
+{
+    transaction tx;
+    tx.version = 1;
+    tx.locktime = 0;
+
+    input in;
+    in.previous_output = output_point{ null_hash, max_uint32 };
+    const auto coinbase_data = to_chunk(to_little_endian(height));
+    in.script.operations = { { opcode::special, coinbase_data } };
+    in.sequence = max_input_sequence;
+    tx.inputs.push_back(in);
+
+    tx.outputs.push_back(make_output(first_key, 1000));
+    tx.outputs.push_back(make_output(second_key, 234));
+    return tx;
+}
+
+static block make_block(uint32_t height, const hash_digest& previous,
+    const transaction::list& transactions)
+{
+    block result;
+    result.header.version = 1;
+    result.header.previous_block_hash = previous;
+    result.header.timestamp = height;
+    result.header.number = height;
+    result.header.transaction_count = transactions.size();
+    result.transactions = transactions;
+    result.header.merkle = result.generate_merkle_root(transactions);
+    return result;
+}
+
+BOOST_AUTO_TEST_SUITE(data_base_push_tests)
+
+BOOST_AUTO_TEST_CASE(data_base__push_pop__spend_in_same_block__restored)
+{
+    boost::filesystem::remove_all(directory);
+    boost::filesystem::create_directories(directory);
+
+    const auto first_key = make_public_key(0x11);
+    const auto second_key = make_public_key(0x22);
+    const auto third_key = make_public_key(0x33);
+    const wallet::payment_address first(bitcoin_short_hash(first_key));
+    const wallet::payment_address second(bitcoin_short_hash(second_key));
+    const wallet::payment_address third(bitcoin_short_hash(third_key));
+
+    const auto genesis = make_block(0, null_hash,
+        { make_coinbase(0, third_key, third_key) });
+    BOOST_REQUIRE(data_base::initialize(directory, genesis));
+
+    database::settings configuration;
+    configuration.directory = directory;
+    data_base instance(configuration);
+    BOOST_REQUIRE(instance.start());
+
+    // The second transaction spends the first output of the coinbase.
+    const auto coinbase = make_coinbase(1, first_key, second_key);
+    transaction spend;
+    spend.version = 1;
+    spend.locktime = 0;
+    input in;
+    in.previous_output = output_point{ coinbase.hash(), 0 };
+    in.script.operations =
+    {
+        { opcode::special, endorsement_item },
+        { opcode::special, first_key }
+    };
+    in.sequence = max_input_sequence;
+    spend.inputs.push_back(in);
+    spend.outputs.push_back(make_output(third_key, 900));
+
+    const auto pushed = make_block(1, genesis.header.hash(),
+        { coinbase, spend });
+    instance.push(pushed, 1);
+
+    // Every store written by the parallel tasks holds the block.
+    size_t top;
+    BOOST_REQUIRE(instance.blocks.top(top));
+    BOOST_REQUIRE_EQUAL(top, 1u);
+    BOOST_REQUIRE(instance.transactions.get(coinbase.hash()));
+    BOOST_REQUIRE(instance.transactions.get(spend.hash()));
+    BOOST_REQUIRE(instance.spends.get(in.previous_output).valid);
+    BOOST_REQUIRE(instance.address_utxos.get(first.hash()).empty());
+    BOOST_REQUIRE_EQUAL(instance.address_utxos.get(second.hash()).size(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.address_utxos.received(first.hash()), 1000u);
+    BOOST_REQUIRE_EQUAL(instance.history.get(first.hash(), 0, 0).size(), 2u);
+    BOOST_REQUIRE_EQUAL(instance.history.get(second.hash(), 0, 0).size(), 1u);
+
+    block popped;
+    BOOST_REQUIRE(instance.pop(popped));
+    BOOST_REQUIRE_EQUAL(popped.transactions.size(), 2u);
+    BOOST_REQUIRE(popped.transactions[1].hash() == spend.hash());
+
+    // Popping leaves the stores as they were after the genesis block.
+    BOOST_REQUIRE(instance.blocks.top(top));
+    BOOST_REQUIRE_EQUAL(top, 0u);
+    BOOST_REQUIRE(!instance.transactions.get(coinbase.hash()));
+    BOOST_REQUIRE(!instance.transactions.get(spend.hash()));
+    BOOST_REQUIRE(!instance.spends.get(in.previous_output).valid);
+    BOOST_REQUIRE(instance.address_utxos.get(first.hash()).empty());
+    BOOST_REQUIRE(instance.address_utxos.get(second.hash()).empty());
+    BOOST_REQUIRE_EQUAL(instance.address_utxos.received(first.hash()), 0u);
+    BOOST_REQUIRE(instance.history.get(first.hash(), 0, 0).empty());
+    BOOST_REQUIRE(instance.history.get(second.hash(), 0, 0).empty());
+    BOOST_REQUIRE_EQUAL(instance.address_utxos.get(third.hash()).size(), 2u);
+
+    BOOST_REQUIRE(instance.stop());
+    boost::filesystem::remove_all(directory);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
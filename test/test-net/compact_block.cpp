@@ -0,0 +1,136 @@
+/**
+ * Copyright (c) 2011-2021 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2021 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdint>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/node/utility/compact_requests.hpp>
+#include <boost/test/unit_test.hpp>
+
+using namespace bc;
+using namespace bc::message;
+
+// SipHash-2-4 reference vectors: key 00..0f, message 00..(n-1).
+static const siphash_key reference_key{ 0x0706050403020100ull,
+    0x0f0e0d0c0b0a0908ull };
+
+static data_chunk counting_bytes(size_t size)
+{
+    data_chunk out(size);
+    for (size_t index = 0; index < size; ++index)
+        out[index] = static_cast<uint8_t>(index);
+
+    return out;
+}
+
+static hash_digest counting_hash()
+{
+    hash_digest out;
+    const auto bytes = counting_bytes(out.size());
+    std::copy(bytes.begin(), bytes.end(), out.begin());
+    return out;
+}
+
+BOOST_AUTO_TEST_SUITE(compact_block_tests)
+
+BOOST_AUTO_TEST_CASE(siphash__reference_vectors__expected)
+{
+    BOOST_REQUIRE_EQUAL(siphash(reference_key, counting_bytes(0)), 0x726fdb47dd0e0e31ull);
+    BOOST_REQUIRE_EQUAL(siphash(reference_key, counting_bytes(1)), 0x74f839c593dc67fdull);
+    BOOST_REQUIRE_EQUAL(siphash(reference_key, counting_bytes(8)), 0x93f5f5799a932462ull);
+    BOOST_REQUIRE_EQUAL(siphash(reference_key, counting_bytes(9)), 0x9e0082df0ba9e4b0ull);
+    BOOST_REQUIRE_EQUAL(siphash(reference_key, counting_bytes(15)), 0xa129ca6149be45e5ull);
+    BOOST_REQUIRE_EQUAL(siphash(reference_key, counting_bytes(16)), 0x3f2acc7f57c29bdbull);
+    BOOST_REQUIRE_EQUAL(siphash(reference_key, counting_bytes(32)), 0x7127512f72f27cceull);
+    BOOST_REQUIRE_EQUAL(siphash(reference_key, counting_bytes(63)), 0x958a324ceb064572ull);
+}
+
+BOOST_AUTO_TEST_CASE(to_siphash_key__counting_hash__little_endian_halves)
+{
+    const auto key = to_siphash_key(counting_hash());
+    BOOST_REQUIRE_EQUAL(key.first, reference_key.first);
+    BOOST_REQUIRE_EQUAL(key.second, reference_key.second);
+}
+
+// The short id is the low six bytes of siphash(key, txid), little endian.
+BOOST_AUTO_TEST_CASE(compact_block__to_short_id__counting_hash__low_six_bytes)
+{
+    const compact_block::short_id expected{ { 0xce, 0x7c, 0xf2, 0x72, 0x2f, 0x51 } };
+    BOOST_REQUIRE(compact_block::to_short_id(reference_key, counting_hash()) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(compact_block__factory_from_block__prefills_coinbase)
+{
+    chain::transaction coinbase;
+    coinbase.inputs.resize(1);
+    coinbase.inputs[0].previous_output.hash = null_hash;
+    coinbase.inputs[0].previous_output.index = max_uint32;
+    coinbase.outputs.resize(1);
+
+    chain::transaction spend;
+    spend.inputs.resize(1);
+    spend.inputs[0].previous_output.hash = counting_hash();
+    spend.inputs[0].previous_output.index = 0;
+    spend.outputs.resize(1);
+
+    chain::block block;
+    block.header.number = 42;
+    block.transactions = { coinbase, spend };
+
+    const auto compact = compact_block::factory_from_block(block, 7);
+    BOOST_REQUIRE_EQUAL(compact.nonce, 7u);
+    BOOST_REQUIRE_EQUAL(compact.transactions.size(), 1u);
+    BOOST_REQUIRE_EQUAL(compact.transactions[0].index, 0u);
+    BOOST_REQUIRE_EQUAL(compact.short_ids.size(), 1u);
+    BOOST_REQUIRE(compact.short_ids[0] ==
+        compact_block::to_short_id(compact.short_id_key(), spend.hash()));
+
+    const auto version = version::level::bip152;
+    const auto copy = compact_block::factory_from_data(version,
+        compact.to_data(version));
+    BOOST_REQUIRE(copy.header == compact.header);
+    BOOST_REQUIRE_EQUAL(copy.nonce, compact.nonce);
+    BOOST_REQUIRE(copy.short_ids == compact.short_ids);
+    BOOST_REQUIRE_EQUAL(copy.transactions.size(), 1u);
+    BOOST_REQUIRE(copy.transactions[0].transaction.hash() == coinbase.hash());
+}
+
+
+BOOST_AUTO_TEST_CASE(compact_requests__erase__answered_by_full_block__not_expired)
+{
+    node::compact_requests requests;
+    const auto requested = asio::steady_clock::now();
+    const hash_digest answered{ { 0x01 } };
+    const hash_digest unanswered{ { 0x02 } };
+    requests.insert(answered, requested);
+    requests.insert(unanswered, requested);
+    BOOST_REQUIRE_EQUAL(requests.size(), 2u);
+
+    // The full block answers the first request exactly once.
+    BOOST_REQUIRE(requests.erase(answered));
+    BOOST_REQUIRE(!requests.erase(answered));
+
+    // Only the unanswered request is counted as expired, and only once.
+    const auto cutoff = requested + asio::seconds(1);
+    BOOST_REQUIRE_EQUAL(requests.expire(cutoff), 1u);
+    BOOST_REQUIRE_EQUAL(requests.expire(cutoff), 0u);
+    BOOST_REQUIRE_EQUAL(requests.size(), 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -75,4 +75,37 @@ class TestTransaction(MVSTestCaseBase):
         ec, message = mvs_rpc.listtxs(Alice.name, Alice.password, limit=100)
         self.assertEqual(ec, 0, message)
 
+        # cursor: the next page follows the last transaction of the previous page
+        ec, first = mvs_rpc.listtxs(Alice.name, Alice.password, limit=1)
+        self.assertEqual(ec, 0, first)
+        ec, second = mvs_rpc.listtxs(Alice.name, Alice.password, limit=1, cursor=first['cursor'])
+        self.assertEqual(ec, 0, second)
+        self.assertNotEqual(first['transactions'][0]['hash'], second['transactions'][0]['hash'])
+        self.assertTrue(first['transactions'][0]['height'] >= second['transactions'][0]['height'])
+
+        ec, message = mvs_rpc.listtxs(Alice.name, Alice.password, limit=1, index=2)
+        self.assertEqual(ec, 0, message)
+        self.assertEqual(message['transactions'], second['transactions'])
+
+        # cursor: invalid cursor
+        ec, message = mvs_rpc.listtxs(Alice.name, Alice.password, cursor='1'*10)
+        self.assertEqual(ec, 2003, message)
+
+
+    def test_3_listtxs_symbol_sent_away(self):
+        # symbol: a transaction sending all of the asset away has no output of
+        # the symbol to the account, it is listed through its spend
+        domain_symbol, asset_symbol = Alice.create_random_asset()
+        Alice.mining()
+
+        ec, message = mvs_rpc.send_asset(Alice.name, Alice.password, Zac.mainaddress(), asset_symbol, 300000)
+        self.assertEqual(ec, 0, message)
+        tx_hash = message['hash']
+        Alice.mining()
+
+        ec, message = mvs_rpc.listtxs(Alice.name, Alice.password, symbol=asset_symbol)
+        self.assertEqual(ec, 0, message)
+        hashes = [tx['hash'] for tx in message['transactions']]
+        self.assertEqual(hashes[0], tx_hash)
+        self.assertEqual(len(hashes), 2)
 
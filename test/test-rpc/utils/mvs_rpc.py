@@ -551,7 +551,7 @@ def gettx(tx_hash, json=None):
     return "gettx", [tx_hash], {'--json':json}, None
 
 @mvs_api
-def listtxs(account, password, address=None, height=None, index=None, limit=None, symbol=None):
+def listtxs(account, password, address=None, height=None, index=None, limit=None, symbol=None, cursor=None):
     '''
     height:         Get tx according height eg: -e
                      start-height:end-height will return tx between
@@ -565,7 +565,8 @@ def listtxs(account, password, address=None, height=None, index=None, limit=None
         '-e':height,
         '-i':index,
         '-l':limit,
-        '-s':symbol
+        '-s':symbol,
+        '-c':cursor
     }, None
 
 @mvs_api